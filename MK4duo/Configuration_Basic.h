@@ -108,6 +108,20 @@
 // Uncomment to include more info in ok command
 //#define ADVANCED_OK
 
+/**
+ * Sliding window for the host streaming
+ * After "M110 N<line> W1" the host can send lines without waiting for each ok:
+ *  - "ok" has the free slots of the command buffer (B) and free bytes of the RX buffer (R)
+ *  - A missing or broken line is asked again alone, "Resend: N", the input is not flushed
+ *  - Up to SERIAL_WINDOW_LINES lines after it are held and queued when it comes
+ *  - Lines already queued are skipped
+ *  - Lines without N are queued at once with their own ok, also ahead of held lines
+ * "M110 W0" goes back to one ok per line. Reported as Cap:SERIAL_WINDOW in M115.
+ * Spend (SERIAL_WINDOW_LINES * (MAX_CMD_SIZE + 6)) bytes of SRAM.
+ */
+//#define SERIAL_WINDOW
+#define SERIAL_WINDOW_LINES 4
+
 /**
  * Enable an emergency-command parser to intercept certain commands as they
  * enter the serial receive buffer, so they cannot be blocked.
@@ -115,11 +129,33 @@
  */
 //#define EMERGENCY_PARSER
 
+/**
+ * Binary protocol
+ * Accept binary frames on the serial port beside the G-code lines, so a
+ * host can stream small moves without the line assembly, the N and the
+ * checksum parsing of text lines. The host finds Cap:BINARY_PROTOCOL:1
+ * in the M115 report, see scripts/binary_stream.py for the frame format.
+ *  Frame: 0xB5, N (2 bytes), length, payload, CRC16 (2 bytes)
+ *  Payload: 0 + a G-code line, or 1/2 + axis mask + int32 values of a G0/G1
+ * Spend (MAX_CMD_SIZE + 8) bytes of SRAM for every serial port.
+ */
+//#define BINARY_PROTOCOL
+
 /**
  * Spend 28 bytes of SRAM to optimize the GCode parser
  */
 //#define FASTER_GCODE_PARSER
 
+/**
+ * Parse the commands when they are put in the command queue, while the
+ * printer is waiting for planner space, and keep letter, code, parameters
+ * and the first PREPARSED_VALUES numbers already converted with the line.
+ * G0/G1 then run without any string conversion. Needs FASTER_GCODE_PARSER.
+ * Spend (PREPARSED_VALUES * 4 + 42) bytes of SRAM for every BUFSIZE line.
+ */
+//#define PREPARSED_COMMANDS
+#define PREPARSED_VALUES 8
+
 /**
  * Spend more bytes of SRAM to optimize the GCode execute
  */
@@ -80,6 +80,25 @@
 // Subsegment per line 10 - xxx
 #define DELTA_SEGMENTS_PER_LINE 20
 
+// Split the moves from the path error instead of the segments per second.
+// The towers move in a straight line between the ends of a segment, so the
+// effector bows away from the straight cartesian line, little near the
+// centre and more near the towers. Every move gets the fewest lines that
+// keep this error within DELTA_SEGMENT_MAX_ERROR (mm), but never more than
+// DELTA_SEGMENTS_PER_SECOND gives without DELTA_SEGMENTS_PER_LINE.
+// scripts/delta_segments.py compares the two modes on a G-code file.
+//#define DELTA_ADAPTIVE_SEGMENTS
+#define DELTA_SEGMENT_MAX_ERROR 0.01
+
+// Move the towers on a parabola through the ends and the middle of every
+// line, instead of a straight line. The planner gives each block the tower
+// heights at the middle of its line and the stepper follows the curve step
+// by step, so the effector stays much nearer to the cartesian line and a
+// move needs far fewer lines (and buffer_line calls) for the same error.
+// With DELTA_ADAPTIVE_SEGMENTS the lines come from the error left by the
+// parabola. Only for 32 bit boards.
+//#define DELTA_STEP_INTERPOLATION
+
 // NOTE: All following values for DELTA_* MUST be floating point,
 // so always have a decimal point in them.
 //
@@ -155,6 +174,10 @@
  * Fast inverse sqrt from Quake III Arena                                                *
  * See: https://en.wikipedia.org/wiki/Fast_inverse_square_root                           *
  *                                                                                       *
+ * On AVR it replaces every square root of the Transform. On other boards it             *
+ * seeds the Newton steps that Transform_line uses for the points of a segmented line.   *
+ * Use it only when the processor has no hardware square root.                           *
+ *                                                                                       *
  *****************************************************************************************/
 //#define DELTA_FAST_SQRT
 /*****************************************************************************************/
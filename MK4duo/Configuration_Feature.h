@@ -58,6 +58,7 @@
  * - R/C Servo
  * - Late Z axis
  * - Ahead slowdown
+ * - Segment merging
  * - Quick home
  * - Home Y before X
  * - Force Home XY before Home Z
@@ -116,6 +117,8 @@
  * - Scad Mesh Output
  * - M43 command for pins info and testing
  * - Debug Feature
+ * - Step trace
+ * - Planner statistics
  * - Watchdog
  * - Start / Stop Gcode
  * - Proportional Font ratio
@@ -682,6 +685,35 @@
 /***********************************************************************/
 
 
+/***********************************************************************
+ ************************* Segment merging *****************************
+ ***********************************************************************
+ *                                                                     *
+ * Merge consecutive short moves going on in the same direction        *
+ * into one planner block, so STL facets and curves sliced in          *
+ * many tiny moves don't starve the stepper.                           *
+ *                                                                     *
+ * A move shorter than SEGMENT_MERGE_LENGTH is held back and           *
+ * extended by the next moves with the same feedrate and extruder      *
+ * while every merged point stays within SEGMENT_MERGE_TOLERANCE       *
+ * (mm) from the merged line and the extrusion per mm changes less     *
+ * than SEGMENT_MERGE_E_RATIO (0.05 = 5%).                             *
+ * Up to SEGMENT_MERGE_MAX moves make one block.                       *
+ * A move is held only while SEGMENT_MERGE_MIN_PLANNED blocks are      *
+ * planned, and queued as soon as fewer are left.                      *
+ *                                                                     *
+ * Cartesian and Core only.                                            *
+ *                                                                     *
+ ***********************************************************************/
+//#define SEGMENT_MERGING
+#define SEGMENT_MERGE_LENGTH     1.0  // (mm)
+#define SEGMENT_MERGE_TOLERANCE  0.01 // (mm)
+#define SEGMENT_MERGE_E_RATIO    0.05
+#define SEGMENT_MERGE_MAX        8
+#define SEGMENT_MERGE_MIN_PLANNED 4
+/***********************************************************************/
+
+
 /***********************************************************************
  *************************** Quick home ********************************
  ***********************************************************************
@@ -1251,6 +1283,19 @@
 // Enable this option to scroll long filenames in the SD card menu
 //#define SCROLL_LONG_FILENAMES
 
+// Read the printing file ahead in whole blocks of 512 bytes, into two
+// buffers: lines are taken from one while the other is filled when the
+// command buffer is full. Costs SD_READ_AHEAD_BLOCKS * 1024 bytes of SRAM.
+//#define SD_READ_AHEAD
+#define SD_READ_AHEAD_BLOCKS 1    // Blocks for each buffer (1-8)
+
+// While printing, read the file from the card SD_STREAM_BLOCKS blocks at a
+// time with one multi-block read (CMD18), instead of a command for each
+// block. The card is released between reads, so it can share the SPI bus.
+// Costs SD_STREAM_BLOCKS * 512 bytes of SRAM.
+//#define SD_STREAM_READ
+#define SD_STREAM_BLOCKS 4        // Blocks for each read (2-16)
+
 /**
  * Sort SD file listings in alphabetical order.
  *
@@ -1287,9 +1332,29 @@
 #define SDSORT_CACHE_VFATS 2      // Maximum number of 13-byte VFAT entries to use for sorting.
                                   // Note: Only affects SCROLL_LONG_FILENAMES with SDSORT_CACHE_NAMES but not SDSORT_DYNAMIC_RAM.
 
+// Sort folders with thousands of files: instead of the options above the sort
+// is an index of 2 bytes for each item, allocated for the folder (SDSORT_LIMIT
+// is not used), and only the names that are shown are read from the card.
+//#define SDSORT_INDEX
+// Keep the index of the current folder in a hidden file on the card,
+// so a folder that did not change is not sorted again.
+//#define SDSORT_INDEX_FILE
+
 // This function enable the firmware write restart file for restart print when power loss
-//#define SD_RESTART_FILE           // Uncomment to enable
-#define SD_RESTART_FILE_SAVE_TIME 1 // seconds between update
+// The file is a journal, a save writes a record of 32 bytes with the position
+// and a checkpoint of the whole state is written only when it changes.
+// The print goes on from the first SD command not done, commands queued by
+// the host or the LCD and not done yet are saved and run again first.
+//#define SD_RESTART_FILE             // Uncomment to enable
+#define SD_RESTART_FILE_SAVE_TIME   1 // seconds between update
+#define SD_RESTART_FILE_SAVE_MOVES  0 // also save every N moves with E or Z, 0 to disable
+
+// Read the selected file in the background for a layer index, kept in a
+// hidden file on the card for the last file selected: the progress is the
+// estimated print time done instead of the bytes read, M73 with no
+// parameters reports the time left, M26 L<layer> and M800 L (with
+// SD_RESTART_FILE) start a layer from its beginning.
+//#define SD_JOB_INDEX
 /*****************************************************************************************/
 
 
@@ -2241,8 +2306,11 @@
 // The number of linear motions that can be in the plan at any give time.
 // THE BLOCK BUFFER SIZE NEEDS TO BE A POWER OF 2 (i.g. 8, 16, 32) because shifts
 // and ors are used to do the ring-buffering.
-// For Arduino DUE setting BLOCK BUFFER SIZE to 32
-#define BLOCK_BUFFER_SIZE 16
+// Maximum 32 for AVR and 128 for 32 bit processors.
+// Leave it commented for the default of the processor: 16 for AVR,
+// 64 for Arduino DUE, 128 for SAMD. More blocks give the look-ahead
+// more millimetres of tiny segments to accelerate over.
+//#define BLOCK_BUFFER_SIZE 16
 
 // The ASCII buffer for receiving from the serial:
 #define MAX_CMD_SIZE 96
@@ -2268,6 +2336,13 @@
 // the host to signal the RX buffer is becoming full.
 //#define SERIAL_XON_XOFF
 
+// Arduino DUE only: the serial ports (not the native USB) receive with
+// the PDC (DMA) in the two halves of the RX buffer, without an interrupt
+// for every byte. Nothing is lost while the interrupts are held off, the
+// host waits when the buffer is full. Use RX_BUFFER_SIZE 256 or more.
+// Not with SERIAL_XON_XOFF or EMERGENCY_PARSER, they need the bytes in the ISR.
+//#define SERIAL_RX_DMA
+
 // Enable this option to collect and display the maximum
 // RX queue usage after transferring a file to SD.
 //#define SERIAL_STATS_MAX_RX_QUEUED
@@ -2291,6 +2366,18 @@
 #define MM_PER_ARC_SEGMENT  1   // Length of each arc segment
 #define MIN_ARC_SEGMENTS   24   // Minimum number of segments in a complete circle
 #define N_ARC_CORRECTION   25   // Number of intertpolated segments between corrections
+// Take the segment length from the radius, the feedrate and the planner queue
+// instead of MM_PER_ARC_SEGMENT: the longest chord within ARC_SEGMENT_TOLERANCE
+// of the arc, but long enough for the planner to keep up at the feedrate.
+//#define ARC_ADAPTIVE_SEGMENTS
+#define ARC_SEGMENT_TOLERANCE   0.01  // (mm) Largest distance of a segment from the arc
+#define MIN_MM_PER_ARC_SEGMENT  0.1   // (mm) Shortest segment
+#define MAX_MM_PER_ARC_SEGMENT 10     // (mm) Longest segment
+// Queue each G2/G3 as a single block and let the stepper turn the plane axes
+// at every step event: no segments to plan and no slowdowns between them.
+// Cartesian only, with the same steps per mm on both axes of the plane (32 bit).
+// Arcs with leveling, beyond the software endstops or too large are cut in lines.
+//#define ARC_STEP_INTERPOLATION
 //#define ARC_P_CIRCLES         // Enable the 'P' parameter to specify complete circles
 //#define CNC_WORKSPACE_PLANES  // Allow G2/G3 to operate in XY, ZX, or YZ planes
 
@@ -2480,8 +2567,16 @@
  * printer statistics.                                                                   *
  * Type 5 reports the current machine configuration.                                     *
  *                                                                                       *
+ * The file info (slicer, layer heights, filament used and object height) is read from   *
+ * the head and the tail of the file when it is selected. With GCODE_INFO_INDEX it is    *
+ * kept in a hidden index on the card, GCODE_INFO_INDEX_BUCKETS * 8 files, and the files *
+ * of the current folder are added while the printer is idle, so the file is not read   *
+ * again. A file that is changed is read again.                                          *
+ *                                                                                       *
  *****************************************************************************************/
 //#define JSON_OUTPUT
+//#define GCODE_INFO_INDEX
+#define GCODE_INFO_INDEX_BUCKETS 16
 /*****************************************************************************************/
 
 
@@ -2527,6 +2622,45 @@
 /*****************************************************************************************/
 
 
+/*****************************************************************************************
+ ************************************** Step trace ***************************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Record every step pulse of the Stepper ISR (time in timer ticks, axes, directions     *
+ * and planner block) in a ring buffer drained in the idle loop.                         *
+ * The trace goes to STEP_TRACE_FILE on the SD card, or to the serial as TRACE: lines.   *
+ * Replay it on the host with scripts/steptrace.py.                                      *
+ *                                                                                       *
+ * M45 S1 start trace, M45 S0 stop trace, M45 report.                                    *
+ *                                                                                       *
+ * STEP_TRACE_BUFFER_SIZE must be a power of 2, each event takes 8 bytes of RAM.         *
+ * Events that don't fit in the buffer are dropped and counted.                          *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define STEP_TRACE
+#define STEP_TRACE_BUFFER_SIZE 256
+#define STEP_TRACE_FILE "steptrace.bin"
+/*****************************************************************************************/
+
+
+/*****************************************************************************************
+ ********************************** Planner statistics ***********************************
+ *****************************************************************************************
+ *                                                                                       *
+ * Count the blocks queued, the time spent in the planner recalculate() and how many     *
+ * blocks the Stepper ISR started with less than 3 moves planned (starvation).           *
+ * Starved blocks include the first and last moves of every sequence of moves.           *
+ *                                                                                       *
+ * M46 report the counters, M46 R reset the counters.                                    *
+ *                                                                                       *
+ * On the Linux build run a G-code file through the planner with                         *
+ * mk4duo --bench file.gcode [--speed K]                                                 *
+ *                                                                                       *
+ *****************************************************************************************/
+//#define PLANNER_STATS
+/*****************************************************************************************/
+
+
 /*****************************************************************************************
  *************************************** Whatchdog ***************************************
  *****************************************************************************************
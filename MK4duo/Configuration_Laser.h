@@ -61,9 +61,10 @@
 
 // Raster mode enables the laser to etch bitmap data at high speeds. Increases command buffer size substantially.
 //#define LASER_RASTER
-#define LASER_MAX_RASTER_LINE 68      // Maximum number of base64 encoded pixels per raster gcode command
+#define LASER_MAX_RASTER_LINE 68      // Maximum number of base64 characters in the D of a G7. Raise it with MAX_CMD_SIZE for longer lines, the pool holds the decoded pixels
 #define LASER_RASTER_ASPECT_RATIO 1   // pixels aren't square on most displays, 1.33 == 4:3 aspect ratio. 
 #define LASER_RASTER_MM_PER_PULSE 0.2 // Can be overridden by providing an R value in M649 command : M649 S17 B2 D0 R0.1 F4000
+#define LASER_RASTER_POOL_SIZE 1024   // Bytes for the decoded raster lines waiting in the planner, shared by all the blocks. Multiple of 4.
 
 //#define LASER_RASTER_MANUAL_Y_FEED // Do not perform any X or Y movements on a G7 $ direction change. Manual Moves must be made between each line.
 
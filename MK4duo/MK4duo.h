@@ -116,6 +116,9 @@
 #include "src/utility/point_t.h"
 #include "src/utility/bezier.h"
 
+// Laser raster pool, the planner blocks refer to its slices
+#include "src/feature/laser/raster_pool.h"
+
 // Core modules
 #include "src/core/mechanics/mechanics.h"
 #include "src/core/tools/tools.h"
@@ -153,6 +156,7 @@
 
 // SDCARD modules
 #include "src/sdcard/sdcard.h"
+#include "src/sdcard/job_index.h"
 
 // Feature modules
 #include "src/feature/emergency_parser/emergency_parser.h"
@@ -178,3 +182,4 @@
 #include "src/feature/rgbled/led_events.h"
 #include "src/feature/caselight/caselight.h"
 #include "src/feature/restart/restart.h"
+#include "src/feature/steptrace/steptrace.h"
@@ -41,6 +41,19 @@ long  Commands::gcode_N = 0;
 
 int Commands::serial_count[NUM_SERIAL] = { 0 };
 
+#if ENABLED(BINARY_PROTOCOL)
+  uint8_t   Commands::binary_frame[NUM_SERIAL][BINARY_FRAME_SIZE];
+  uint16_t  Commands::binary_count[NUM_SERIAL] = { 0 };
+#endif
+
+#if ENABLED(SERIAL_WINDOW)
+  bool        Commands::window_mode = false;
+  long        Commands::resend_N    = 0,
+              Commands::lost_N      = 0;
+  int8_t      Commands::lost_port   = 0;
+  held_line_t Commands::held[SERIAL_WINDOW_LINES];
+#endif
+
 PGM_P Commands::injected_commands_P = NULL;
 
 watch_t Commands::last_command_watch(NO_TIMEOUTS);
@@ -74,7 +87,7 @@ void Commands::advance_queue() {
 
     if (card.isSaving()) {
       SERIAL_EM("Sono in Saving!");
-      gcode_t command = buffer_ring.peek();
+      gcode_t &command = buffer_ring.peek_ref();
       if (is_M29(command.gcode)) {
         // M29 closes the file
         card.finishWrite();
@@ -105,7 +118,7 @@ void Commands::advance_queue() {
   #endif // !HAS_SD_SUPPORT
 
   // The buffer_ring may be reset by a command handler or by code invoked by idle() within a handler
-  buffer_ring.dequeue();
+  buffer_ring.discard();
 
 }
 
@@ -293,7 +306,7 @@ Heater* Commands::get_target_heater() {
 /** Private Function */
 void Commands::ok_to_send() {
 
-  gcode_t tmp = buffer_ring.peek();
+  const gcode_t &tmp = buffer_ring.peek_ref();
 
   if (tmp.s_port < 0 || !tmp.send_ok) return;
 
@@ -301,7 +314,7 @@ void Commands::ok_to_send() {
   SERIAL_STR(OK);
 
   #if ENABLED(ADVANCED_OK)
-    char* p = tmp.gcode;
+    const char* p = tmp.gcode;
     if (*p == 'N') {
       SERIAL_CHR(' ');
       SERIAL_CHR(*p++);
@@ -312,6 +325,16 @@ void Commands::ok_to_send() {
     SERIAL_MV(" B", BUFSIZE - buffer_ring.count(), DEC);
   #endif
 
+  #if ENABLED(SERIAL_WINDOW)
+    // Room for the host to send more lines
+    if (window_mode) {
+      #if DISABLED(ADVANCED_OK)
+        SERIAL_MV(" B", BUFSIZE - buffer_ring.count(), DEC);
+      #endif
+      SERIAL_MV(" R", int(RX_BUFFER_SIZE - 1 - Com::serialAvailable(tmp.s_port)), DEC);
+    }
+  #endif
+
   SERIAL_EOL();
   SERIAL_PORT(-1);
 }
@@ -334,6 +357,16 @@ void Commands::get_serial() {
     return;
   }
 
+  #if ENABLED(SERIAL_WINDOW)
+    drain_held();
+  #endif
+
+  #if ENABLED(BINARY_PROTOCOL)
+    // Frames received whole while the buffer_ring was full
+    for (uint8_t i = 0; i < NUM_SERIAL && !buffer_ring.isFull(); ++i)
+      if (binary_count[i]) (void)get_binary(i);
+  #endif
+
   // If the command buffer is empty for too long,
   // send "wait" to indicate MK4duo is still waiting.
   #if NO_TIMEOUTS > 0
@@ -356,8 +389,25 @@ void Commands::get_serial() {
       last_command_watch.start();
       printer.max_inactivity_watch.start();
 
+      #if ENABLED(BINARY_PROTOCOL)
+        // The rest of a binary frame
+        if (binary_count[i]) {
+          if (!get_binary(i)) return;
+          continue;
+        }
+      #endif
+
       if ((c = Com::serialRead(i)) < 0) continue;
 
+      #if ENABLED(BINARY_PROTOCOL)
+        // A binary frame starts where a line would
+        if (c == BINARY_SYNC && !serial_count[i] && !serial_comment_mode[i]) {
+          binary_frame[i][binary_count[i]++] = c;
+          if (!get_binary(i)) return;
+          continue;
+        }
+      #endif
+
       char serial_char = c;
 
       /**
@@ -378,22 +428,12 @@ void Commands::get_serial() {
         while (*command == ' ') command++;                // Skip leading spaces
         char *npos = (*command == 'N') ? command : NULL;  // Require the N parameter to start the line
 
-        if (npos) {
-
-          bool M110 = strstr_P(command, PSTR("M110")) != NULL;
+        const char * const m110 = strstr_P(command, PSTR("M110"));
 
-          if (M110) {
-            char *n2pos = strchr(command + 4, 'N');
-            if (n2pos) npos = n2pos;
-          }
+        if (npos) {
 
           gcode_N = strtol(npos + 1, NULL, 10);
 
-          if (gcode_N != gcode_LastN + 1 && !M110) {
-            gcode_line_error(PSTR(MSG_ERR_LINE_NO), i);
-            return;
-          }
-
           char *apos = strrchr(command, '*');
           if (apos) {
             uint8_t checksum = 0, count = uint8_t(apos - command);
@@ -408,8 +448,20 @@ void Commands::get_serial() {
             return;
           }
 
-          gcode_LastN = gcode_N;
+          if (m110)
+            set_line_number(m110, gcode_N);
+          else if (gcode_N != gcode_LastN + 1) {
+            #if ENABLED(SERIAL_WINDOW)
+              if (hold_line(gcode_N, i, command, 0)) continue;
+            #endif
+            gcode_line_error(PSTR(MSG_ERR_LINE_NO), i);
+            return;
+          }
+          else
+            gcode_LastN = gcode_N;
         }
+        else if (m110)
+          set_line_number(m110, gcode_LastN);
         #if HAS_SD_SUPPORT
           // Pronterface "M29" and "M29 " has no line number
           else if (card.isSaving() && !is_M29(command)) {
@@ -418,41 +470,14 @@ void Commands::get_serial() {
           }
         #endif
 
-        // Movement commands alert when stopped
-        if (printer.isStopped()) {
-          char *gpos = strrchr(command, 'G');
-          if (gpos) {
-            switch (strtol(gpos + 1, NULL, 10)) {
-              case 0:
-              case 1:
-              #if ENABLED(ARC_SUPPORT)
-                case 2:
-                case 3:
-              #endif
-              #if ENABLED(G5_BEZIER)
-                case 5:
-              #endif
-                SERIAL_LM(ER, MSG_ERR_STOPPED);
-                LCD_MESSAGEPGM(MSG_STOPPED);
-                break;
-            }
-          }
-        }
-
-        #if DISABLED(EMERGENCY_PARSER)
-          // If command was e-stop process now
-          if (strcmp(command, "M108") == 0) {
-            printer.setWaitForHeatUp(false);
-            #if ENABLED(ULTIPANEL)
-              printer.setWaitForUser(false);
-            #endif
-          }
-          if (strcmp(command, "M112") == 0) printer.kill();
-          if (strcmp(command, "M410") == 0) printer.quickstop_stepper();
-        #endif
+        check_serial_command(command);
 
         // Add the command to the buffer_ring
         enqueue(serial_line_buffer[i], true, i);
+
+        #if ENABLED(SERIAL_WINDOW)
+          drain_held();
+        #endif
       }
       else if (serial_count[i] >= MAX_CMD_SIZE - 1) {
         // Keep fetching, but ignore normal characters beyond the max length
@@ -465,17 +490,341 @@ void Commands::get_serial() {
       }
       else { // its not a newline, carriage return or escape char
         if (serial_char == ';') serial_comment_mode[i] = true;
-        else if (!serial_comment_mode[i]) serial_line_buffer[i][serial_count[i]++] = serial_char;
+        else if (!serial_comment_mode[i]) {
+          serial_line_buffer[i][serial_count[i]++] = serial_char;
+          // The plain characters after it at once
+          serial_count[i] += Com::serialReadUntil(i, "\n\r;\\", &serial_line_buffer[i][serial_count[i]], MAX_CMD_SIZE - 1 - serial_count[i]);
+        }
       }
     } // for NUM_SERIAL
   }
 }
 
+void Commands::check_serial_command(const char * const command) {
+
+  // Movement commands alert when stopped
+  if (printer.isStopped()) {
+    const char *gpos = strrchr(command, 'G');
+    if (gpos) {
+      switch (strtol(gpos + 1, NULL, 10)) {
+        case 0:
+        case 1:
+        #if ENABLED(ARC_SUPPORT)
+          case 2:
+          case 3:
+        #endif
+        #if ENABLED(G5_BEZIER)
+          case 5:
+        #endif
+          SERIAL_LM(ER, MSG_ERR_STOPPED);
+          LCD_MESSAGEPGM(MSG_STOPPED);
+          break;
+      }
+    }
+  }
+
+  #if DISABLED(EMERGENCY_PARSER)
+    // If command was e-stop process now
+    if (strcmp(command, "M108") == 0) {
+      printer.setWaitForHeatUp(false);
+      #if ENABLED(ULTIPANEL)
+        printer.setWaitForUser(false);
+      #endif
+    }
+    if (strcmp(command, "M112") == 0) printer.kill();
+    if (strcmp(command, "M410") == 0) printer.quickstop_stepper();
+  #endif
+
+}
+
+void Commands::set_line_number(const char * const m110, const long line_N) {
+  const char * const npos = strchr(m110 + 4, 'N');
+  gcode_LastN = gcode_N = npos ? strtol(npos + 1, NULL, 10) : line_N;
+  #if ENABLED(SERIAL_WINDOW)
+    const char * const wpos = strchr(m110 + 4, 'W');
+    if (wpos) window_mode = wpos[1] == '1';
+    // Start again without held lines
+    resend_N = lost_N = 0;
+    LOOP_SERIAL_WINDOW(h) held[h].N = 0;
+  #endif
+}
+
+#if ENABLED(SERIAL_WINDOW)
+
+  void Commands::request_resend(const int8_t port) {
+    resend_N = gcode_LastN + 1;
+    SERIAL_PORT(port);
+    SERIAL_LV(RESEND, resend_N);
+    SERIAL_PORT(-1);
+  }
+
+  bool Commands::hold_line(const long N, const int8_t port, const void * const data, const uint8_t length) {
+
+    if (!window_mode) return false;
+
+    // Lines already queued are sent again after a resend, skip them
+    if (N <= gcode_LastN) return true;
+
+    held_line_t *entry = NULL;
+    LOOP_SERIAL_WINDOW(h) {
+      if (held[h].N == N) return true;
+      if (!held[h].N && !entry) entry = &held[h];
+    }
+
+    if (entry) {
+      entry->N = N;
+      entry->port = port;
+      entry->length = length;
+      if (length)
+        memcpy(entry->data, data, length);
+      else
+        strcpy(entry->data, (const char*)data);
+    }
+    else {
+      // Asked again when the held lines are queued
+      NOLESS(lost_N, N);
+      lost_port = port;
+    }
+
+    // Ask only for the missing line, once
+    if (resend_N != gcode_LastN + 1) request_resend(port);
+
+    return true;
+  }
+
+  void Commands::drain_held() {
+
+    bool held_left = false;
+
+    for (bool found = true; found;) {
+      found = held_left = false;
+      LOOP_SERIAL_WINDOW(h) {
+        held_line_t &entry = held[h];
+        if (!entry.N) continue;
+        if (entry.N <= gcode_LastN)
+          entry.N = 0;
+        else if (entry.N == gcode_LastN + 1) {
+          if (buffer_ring.isFull()) return;
+          gcode_LastN = gcode_N = entry.N;
+          entry.N = 0;
+          #if ENABLED(BINARY_PROTOCOL)
+            if (entry.length)
+              queue_binary((uint8_t*)entry.data, entry.length, entry.port);
+            else
+          #endif
+            {
+              check_serial_command(entry.data);
+              enqueue(entry.data, true, entry.port);
+            }
+          found = true;
+        }
+        else
+          held_left = true;
+      }
+    }
+
+    // A line is still missing, or lines were lost for lack of room
+    if ((held_left || gcode_LastN < lost_N) && resend_N != gcode_LastN + 1)
+      request_resend(lost_port);
+  }
+
+#endif // SERIAL_WINDOW
+
+#if ENABLED(BINARY_PROTOCOL)
+
+  bool Commands::get_binary(const uint8_t port) {
+
+    uint8_t * const frame = binary_frame[port];
+    uint16_t &count = binary_count[port];
+
+    // Take the bytes of the frame already received
+    int c;
+    while (count < BINARY_HEADER || count < BINARY_HEADER + frame[3] + 2) {
+      if ((c = Com::serialRead(port)) < 0) return true;
+      frame[count++] = c;
+      // A payload longer than a line can only be a broken length
+      if (count == BINARY_HEADER && frame[3] > MAX_CMD_SIZE - 1) {
+        count = 0;
+        gcode_line_error(PSTR(MSG_ERR_CHECKSUM_MISMATCH), port);
+        return false;
+      }
+    }
+
+    // Keep the whole frame until there is room for its command
+    if (buffer_ring.isFull()) return true;
+    count = 0;
+
+    const uint8_t length = frame[3];
+    uint8_t * const payload = &frame[BINARY_HEADER];
+
+    uint16_t crc = 0xFFFF;
+    crc16(&crc, &frame[1], BINARY_HEADER - 1 + length);
+    if (crc != (payload[length] | (payload[length + 1] << 8))) {
+      gcode_line_error(PSTR(MSG_ERR_CHECKSUM_MISMATCH), port);
+      return false;
+    }
+
+    // N goes on from the text lines, only its low 16 bits are sent
+    const long N = gcode_LastN + 1 + int16_t((frame[1] | (frame[2] << 8)) - uint16_t(gcode_LastN + 1));
+
+    // M110 sets the line number at once, like a text line
+    if (length && payload[0] == BINARY_GCODE) {
+      payload[length] = '\0';
+      const char * const m110 = strstr_P((char*)&payload[1], PSTR("M110"));
+      if (m110) {
+        set_line_number(m110, N);
+        queue_binary(payload, length, port);
+        return true;
+      }
+    }
+
+    if (N != gcode_LastN + 1) {
+      #if ENABLED(SERIAL_WINDOW)
+        if (hold_line(N, port, payload, length)) return true;
+      #endif
+      gcode_line_error(PSTR(MSG_ERR_LINE_NO), port);
+      return false;
+    }
+
+    gcode_LastN = gcode_N = N;
+    queue_binary(payload, length, port);
+
+    #if ENABLED(SERIAL_WINDOW)
+      drain_held();
+    #endif
+
+    return true;
+  }
+
+  void Commands::queue_binary(uint8_t * const payload, const uint8_t length, const int8_t port) {
+
+    if (payload[0] == BINARY_GCODE && length > 1) {
+      char * const command = (char*)&payload[1];
+      payload[length] = '\0';
+      check_serial_command(command);
+      enqueue(command, true, port);
+    }
+    else if ((payload[0] == BINARY_G0 || payload[0] == BINARY_G1)
+      && length > 1 && length == 2 + 4 * __builtin_popcount(payload[1] & 0x1F)
+    )
+      queue_binary_move(payload, port);
+    else {
+      // A frame from a newer host, skip it so the host can go on
+      SERIAL_PORT(port);
+      SERIAL_STR(ER);
+      SERIAL_STR(MSG_ERR_BINARY_FRAME);
+      SERIAL_EV(gcode_LastN);
+      SERIAL_STR(OK);
+      SERIAL_EOL();
+      SERIAL_PORT(-1);
+    }
+
+  }
+
+  /**
+   * Write a fixed point value, 1/10000 units, without trailing zeros
+   */
+  static char* fixed_to_str(char *p, const int32_t value) {
+    uint32_t v = value;
+    if (value < 0) { *p++ = '-'; v = 0u - uint32_t(value); }
+
+    char digits[12];
+    uint8_t n = 0;
+    uint32_t ip = v / 10000, fp = v % 10000;
+    do { digits[n++] = '0' + ip % 10; ip /= 10; } while (ip);
+    while (n) *p++ = digits[--n];
+
+    if (fp) {
+      *p++ = '.';
+      for (uint16_t d = 1000; fp; d /= 10) {
+        *p++ = '0' + fp / d;
+        fp %= d;
+      }
+    }
+    return p;
+  }
+
+  /**
+   * Write the move as a G-code line in a new slot of the buffer_ring. With
+   * PREPARSED_COMMANDS the parser state is set here from the values, so the
+   * line is never scanned.
+   */
+  void Commands::queue_binary_move(const uint8_t * payload, const uint8_t port) {
+
+    static const char axis_codes[] = { 'X', 'Y', 'Z', 'E', 'F' };
+
+    gcode_t * const slot = buffer_ring.reserve();
+    char *p = slot->gcode;
+
+    const uint8_t type = payload[0], mask = payload[1];
+    payload += 2;
+
+    int32_t values[COUNT(axis_codes)];
+    uint8_t offsets[COUNT(axis_codes)];
+
+    *p++ = 'G';
+    *p++ = type == BINARY_G0 ? '0' : '1';
+
+    for (uint8_t a = 0; a < COUNT(axis_codes); a++) {
+      if (!TEST(mask, a)) continue;
+      values[a] = int32_t(uint32_t(payload[0]) | uint32_t(payload[1]) << 8 | uint32_t(payload[2]) << 16 | uint32_t(payload[3]) << 24);
+      payload += 4;
+      *p++ = ' ';
+      *p++ = axis_codes[a];
+      offsets[a] = p - slot->gcode;
+      p = fixed_to_str(p, values[a]);
+    }
+    *p = '\0';
+
+    check_serial_command(slot->gcode);
+
+    #if ENABLED(PREPARSED_COMMANDS)
+
+      slot->s_port = port;
+      slot->send_ok = true;
+
+      parsed_gcode_t &parsed = slot->parsed;
+      parsed.command_letter = 'G';
+      parsed.codenum        = type == BINARY_G0 ? 0 : 1;
+      parsed.subcode        = 0;
+      parsed.command_ofs    = 0;
+      parsed.string_ofs     = 0xFF;
+      parsed.end_ofs        = p - slot->gcode;
+      parsed.codebits       = 0;
+      parsed.valbits        = 0;
+      ZERO(parsed.param);
+
+      // Values in letter order, as the parser keeps them
+      static const uint8_t letter_order[] = { 3, 4, 0, 1, 2 }; // E F X Y Z
+      uint8_t n = 0;
+      for (uint8_t i = 0; i < COUNT(letter_order); i++) {
+        const uint8_t a = letter_order[i];
+        if (!TEST(mask, a)) continue;
+        const uint8_t ind = LETTER_BIT(axis_codes[a]);
+        SBI32(parsed.codebits, ind);
+        parsed.param[ind] = offsets[a];
+        if (n < PREPARSED_VALUES) {
+          parsed.values[n++] = values[a] / 10000.0f;
+          SBI32(parsed.valbits, ind);
+        }
+      }
+
+      buffer_ring.commit();
+
+    #else
+
+      commit(slot, true, port);
+
+    #endif
+
+  }
+
+#endif // BINARY_PROTOCOL
+
 #if HAS_SD_SUPPORT
 
   void Commands::get_sdcard() {
 
-    static char sd_line_buffer[MAX_CMD_SIZE];
     static bool stop_buffering = false,
                 sd_comment_mode = false;
 
@@ -504,9 +853,14 @@ void Commands::get_serial() {
 
     if (buffer_ring.isEmpty()) stop_buffering = false;
 
+    /**
+     * Lines are read straight into the free slot of the buffer_ring,
+     * a line is always complete when this function returns.
+     */
     uint16_t sd_count = 0;
     bool card_eof = card.eof();
     while (!buffer_ring.isFull() && !card_eof && !stop_buffering) {
+      gcode_t * const slot = buffer_ring.reserve();
       const int16_t n = card.get();
       char sd_char = (char)n;
       card_eof = card.eof();
@@ -516,13 +870,25 @@ void Commands::get_serial() {
           || sd_char == '\n'  || sd_char == '\r'
           || ((sd_char == '#' || sd_char == ':') && !sd_comment_mode)
       ) {
+        if (sd_char == '#') stop_buffering = true;
+
+        sd_comment_mode = false; // for new command
+
+        // Add the line to the buffer_ring before anything at the end of the file can run idle()
+        if (sd_count) {
+          slot->gcode[sd_count] = '\0'; // terminate string
+          sd_count = 0; // clear sd line
+          commit(slot, false, -2); // Port -2 for SD non answer and no send ok.
+        }
+        else
+          printer.check_periodical_actions();
+
         if (card_eof) {
 
           card.printingHasFinished();
 
-          if (IS_SD_PRINTING())
-            sd_count = 0; // If a sub-file was printing, continue from call point
-          else {
+          // If a sub-file was printing, continue from call point
+          if (!IS_SD_PRINTING()) {
             SERIAL_EM(MSG_FILE_PRINTED);
             #if ENABLED(PRINTER_EVENT_LEDS)
               LCD_MESSAGEPGM(MSG_INFO_COMPLETED_PRINTS);
@@ -545,17 +911,6 @@ void Commands::get_serial() {
         else if (n == -1) {
           SERIAL_LM(ER, MSG_SD_ERR_READ);
         }
-        if (sd_char == '#') stop_buffering = true;
-
-        sd_comment_mode = false; // for new command
-
-        // Skip empty lines and comments
-        if (!sd_count) { printer.check_periodical_actions(); continue; }
-
-        sd_line_buffer[sd_count] = '\0'; // terminate string
-        sd_count = 0; // clear sd line buffer
-
-        enqueue(sd_line_buffer, false, -2); // Port -2 for SD non answer and no send ok.
 
       }
       else if (sd_count >= MAX_CMD_SIZE - 1) {
@@ -566,10 +921,23 @@ void Commands::get_serial() {
       }
       else {
         if (sd_char == ';') sd_comment_mode = true;
-        if (!sd_comment_mode) sd_line_buffer[sd_count++] = sd_char;
+        if (!sd_comment_mode) {
+          #if HAS_SD_RESTART
+            if (!sd_count) slot->sdpos = card.getIndex();
+          #endif
+          slot->gcode[sd_count++] = sd_char;
+        }
+        #if ENABLED(SD_READ_AHEAD)
+          else card.skip_comment();
+        #endif
       }
     }
 
+    #if ENABLED(SD_READ_AHEAD)
+      // Nothing to do until a command is done, read the next blocks now
+      if (buffer_ring.isFull()) card.read_ahead();
+    #endif
+
     printer.progress = card.percentDone();
   }
 
@@ -577,7 +945,8 @@ void Commands::get_serial() {
 
 void Commands::process_next() {
 
-  gcode_t cmd = buffer_ring.peek();
+  // Parsed in place, the slot stays in the buffer_ring until advance_queue() discards it
+  gcode_t &cmd = buffer_ring.peek_ref();
 
   if (printer.debugEcho()) {
     SERIAL_PORT(cmd.s_port);
@@ -587,15 +956,21 @@ void Commands::process_next() {
   printer.move_watch.start(); // Keep steppers powered
 
   // Parse the next command in the buffer_ring
-  parser.parse(cmd.gcode);
+  #if ENABLED(PREPARSED_COMMANDS)
+    if (cmd.parsed.command_letter)
+      parser.load(cmd.gcode, cmd.parsed);
+    else
+      parser.parse(cmd.gcode);  // Queued during an M28
+  #else
+    parser.parse(cmd.gcode);
+  #endif
   process_parsed();
 
 }
 
 void Commands::unknown_error() {
   #if NUM_SERIAL > 1
-    gcode_t tmp = buffer_ring.peek();
-    SERIAL_PORT(tmp.s_port);
+    SERIAL_PORT(buffer_ring.peek_ref().s_port);
   #endif
   SERIAL_SMV(ECHO, MSG_UNKNOWN_COMMAND, parser.command_ptr);
   SERIAL_CHR('"');
@@ -608,6 +983,15 @@ void Commands::gcode_line_error(PGM_P err, const int8_t port) {
   SERIAL_STR(ER);
   SERIAL_STR(err);
   SERIAL_EV(gcode_LastN);
+  #if ENABLED(SERIAL_WINDOW)
+    // Keep the lines after it, they are held until the line comes again
+    if (window_mode) {
+      serial_count[port] = 0;
+      SERIAL_PORT(-1);
+      request_resend(port);
+      return;
+    }
+  #endif
   while (Com::serialRead(port) != -1);
   flush_and_request_resend();
   serial_count[port] = 0;
@@ -615,15 +999,32 @@ void Commands::gcode_line_error(PGM_P err, const int8_t port) {
 }
 
 bool Commands::enqueue(const char * cmd, bool say_ok/*=false*/, int8_t port/*=-2*/) {
-  if (*cmd == ';' || buffer_ring.isFull()) return false;
-  gcode_t temp_cmd;
-  strcpy(temp_cmd.gcode, cmd);
-  temp_cmd.s_port = port;
-  temp_cmd.send_ok = say_ok;
-  buffer_ring.enqueue(temp_cmd);
+  if (*cmd == ';') return false;
+  gcode_t * const slot = buffer_ring.reserve();
+  if (!slot) return false;
+  strcpy(slot->gcode, cmd);
+  #if HAS_SD_RESTART
+    slot->sdpos = SDPOS_NONE; // Port -2 is not only the SD card
+  #endif
+  commit(slot, say_ok, port);
   return true;
 }
 
+void Commands::commit(gcode_t * const slot, const bool say_ok, const int8_t port) {
+  slot->s_port = port;
+  slot->send_ok = say_ok;
+  #if ENABLED(PREPARSED_COMMANDS)
+    #if HAS_SD_SUPPORT
+      // Lines for an M28 file are written, never run
+      if (card.isSaving())
+        slot->parsed.command_letter = '\0';
+      else
+    #endif
+        parser.preparse(slot->gcode, slot->parsed);
+  #endif
+  buffer_ring.commit();
+}
+
 bool Commands::drain_injected_P() {
   if (injected_commands_P != NULL) {
     size_t i = 0;
@@ -29,12 +29,51 @@
 
 #include "parser.h"
 
+#if ENABLED(SERIAL_WINDOW)
+  /**
+   * A line received after a missing one, in window mode
+   */
+  struct held_line_t {
+    long    N;                  // Line number, 0 for a free entry
+    int8_t  port;
+    uint8_t length;             // Binary payload length, 0 for a text line
+    char    data[MAX_CMD_SIZE];
+  };
+  #define LOOP_SERIAL_WINDOW(VAR) for (uint8_t VAR = 0; VAR < SERIAL_WINDOW_LINES; VAR++)
+#endif
+
+#if ENABLED(BINARY_PROTOCOL)
+  /**
+   * Binary frame: BINARY_SYNC at the start of a line, N low and high byte,
+   * payload length, payload, CRC16 low and high byte of N, length and payload.
+   */
+  #define BINARY_SYNC       0xB5
+  #define BINARY_HEADER     4
+  #define BINARY_FRAME_SIZE (BINARY_HEADER + MAX_CMD_SIZE + 2)
+
+  enum BinaryFrameEnum : uint8_t {
+    BINARY_GCODE, // G-code line, without N and checksum
+    BINARY_G0,    // Axis mask (X Y Z E F) and int32 values in 1/10000 mm or mm/min
+    BINARY_G1
+  };
+#endif
+
+#if HAS_SD_RESTART
+  #define SDPOS_NONE 0xFFFFFFFFUL
+#endif
+
 struct gcode_t {
   char    gcode[MAX_CMD_SIZE];  // Char for gcode
   bool    send_ok = true;       // Send "ok" after commands by default
   int8_t  s_port  = -1;         // Serial port for print information:
                                 //    -1 for all port
                                 //    -2 for SD or null port
+  #if HAS_SD_RESTART
+    uint32_t sdpos;             // File position of an SD command, SDPOS_NONE for the others
+  #endif
+  #if ENABLED(PREPARSED_COMMANDS)
+    parsed_gcode_t parsed;      // Parsed when queued
+  #endif
 };
 
 class Commands {
@@ -69,6 +108,19 @@ class Commands {
 
     static int serial_count[NUM_SERIAL];
 
+    #if ENABLED(SERIAL_WINDOW)
+      static bool         window_mode;  // Set by M110 W1
+      static long         resend_N,     // Line asked again
+                          lost_N;       // Last line lost for lack of room
+      static int8_t       lost_port;
+      static held_line_t  held[SERIAL_WINDOW_LINES];
+    #endif
+
+    #if ENABLED(BINARY_PROTOCOL)
+      static uint8_t  binary_frame[NUM_SERIAL][BINARY_FRAME_SIZE];
+      static uint16_t binary_count[NUM_SERIAL];
+    #endif
+
     /**
      * Next Injected Command pointer. NULL if no commands are being injected.
      * Used by MK4duo internally to ensure that commands initiated from within
@@ -194,6 +246,46 @@ class Commands {
      */
     static void get_serial();
 
+    /**
+     * Alert about moves while stopped and handle the
+     * e-stop commands of a line from the serial port.
+     */
+    static void check_serial_command(const char * const command);
+
+    /**
+     * M110 from the serial port is done when it comes, so
+     * the lines sent after it are checked with the new N
+     */
+    static void set_line_number(const char * const m110, const long line_N);
+
+    #if ENABLED(SERIAL_WINDOW)
+      /**
+       * Window mode: ask again only for the line gcode_LastN + 1
+       */
+      static void request_resend(const int8_t port);
+
+      /**
+       * Window mode: keep a line that comes after a missing one, skip a line
+       * already queued. Return false if not in window mode.
+       */
+      static bool hold_line(const long N, const int8_t port, const void * const data, const uint8_t length);
+
+      /**
+       * Queue the held lines that follow gcode_LastN
+       */
+      static void drain_held();
+    #endif
+
+    #if ENABLED(BINARY_PROTOCOL)
+      /**
+       * Read the rest of a binary frame and queue its command.
+       * Return false on error, after the resend request.
+       */
+      static bool get_binary(const uint8_t port);
+      static void queue_binary(uint8_t * const payload, const uint8_t length, const int8_t port);
+      static void queue_binary_move(const uint8_t * payload, const uint8_t port);
+    #endif
+
     /**
      * Get commands from the SD Card until the command buffer is full
      * or until the end of the file is reached. The special character '#'
@@ -220,6 +312,11 @@ class Commands {
      */
     static bool enqueue(const char * cmd, bool say_ok=false, int8_t port=-2);
 
+    /**
+     * Add a command written in place in the slot from buffer_ring.reserve()
+     */
+    static void commit(gcode_t * const slot, const bool say_ok, const int8_t port);
+
     /**
      * Inject the next "immediate" command, when possible, onto the front of the buffer_ring.
      * Return true if any immediate commands remain to inject.
@@ -0,0 +1,56 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * mcode
+ *
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ */
+
+#if ENABLED(STEP_TRACE)
+
+  #define CODE_M45
+
+  /**
+   * M45: Step trace
+   *
+   *  S1 - Start recording the step events
+   *  S0 - Wait for the moves to finish and stop recording
+   *
+   *  Without parameters report the trace status
+   */
+  inline void gcode_M45(void) {
+
+    if (parser.seen('S')) {
+      if (parser.value_bool())
+        steptrace.start();
+      else {
+        planner.synchronize();
+        steptrace.stop();
+      }
+    }
+    else
+      steptrace.report();
+
+  }
+
+#endif // STEP_TRACE
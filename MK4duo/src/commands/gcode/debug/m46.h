@@ -0,0 +1,50 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * mcode
+ *
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ */
+
+#if ENABLED(PLANNER_STATS)
+
+  #define CODE_M46
+
+  /**
+   * M46: Planner statistics
+   *
+   *  R - Reset the counters
+   *
+   *  Without parameters report blocks queued, time spent in recalculate()
+   *  and how many blocks were started with less than 3 moves planned
+   */
+  inline void gcode_M46(void) {
+
+    if (parser.seen('R'))
+      planner.reset_stats();
+    else
+      planner.print_stats();
+
+  }
+
+#endif // PLANNER_STATS
@@ -45,6 +45,7 @@
   /**
    * M800: Resume from Restart Job
    *   - With 'S' go to the Restart/Cancel menu
+   *   - With 'L' start the layer again from its beginning (SD_JOB_INDEX)
    *   - With no parameters run restart commands
    */
   inline void gcode_M800(void) {
@@ -55,7 +56,7 @@
           lcdui.goto_screen(menu_sdcard_restart);
         else
       #endif
-        restart.resume_job();
+        restart.resume_job(parser.seen('L'));
     }
     else {
       #if ENABLED(DEBUG_RESTART)
@@ -94,6 +94,8 @@
 // Debug Commands
 #include "debug/m43.h"
 #include "debug/m44_pre_table.h"          // Debug Code Info
+#include "debug/m45.h"                    // Step trace
+#include "debug/m46.h"                    // Planner statistics
 
 // Delta Commands
 #include "delta/g33_type1.h"              // Autocalibration 7 point
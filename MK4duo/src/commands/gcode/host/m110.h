@@ -30,7 +30,13 @@
 
 /**
  * M110: Set Current Line Number
+ *
+ *  N<line>   Line number
+ *  W<0|1>    Window mode for the host streaming (SERIAL_WINDOW)
+ *
+ * From the serial port it is done when the line comes in
  */
 inline void gcode_M110(void) {
+  if (commands.buffer_ring.peek_ref().s_port >= 0) return;
   if (parser.seenval('N')) commands.gcode_LastN = parser.value_long();
 }
@@ -116,6 +116,20 @@ inline void gcode_M115(void) {
     SERIAL_CAP("EMERGENCY_PARSER:0");
   #endif
 
+  // SERIAL_WINDOW (M110 W1)
+  #if ENABLED(SERIAL_WINDOW)
+    SERIAL_CAP("SERIAL_WINDOW:1");
+  #else
+    SERIAL_CAP("SERIAL_WINDOW:0");
+  #endif
+
+  // BINARY_PROTOCOL
+  #if ENABLED(BINARY_PROTOCOL)
+    SERIAL_CAP("BINARY_PROTOCOL:1");
+  #else
+    SERIAL_CAP("BINARY_PROTOCOL:0");
+  #endif
+
   // CHAMBER_TEMPERATURE (M141, M191)
   #if CHAMBERS > 0
     SERIAL_CAP("CHAMBER_TEMPERATURE:1");
@@ -48,8 +48,24 @@ void gcode_M73_M532() {
  * Example:
  *   M73 P25 ; Set progress to 25%
  *
+ * With no parameters, and the layer index of the SD print file,
+ * report the progress, the layer and the estimated time left.
  */
-inline void gcode_M73(void) { gcode_M73_M532(); }
+inline void gcode_M73(void) {
+  #if ENABLED(SD_JOB_INDEX)
+    if (!parser.seen('P') && !parser.seen('L') && card.isFileOpen() && job_index.ready()) {
+      char buffer[21];
+      duration_t left = job_index.time_left(card.getIndex());
+      left.toString(buffer);
+      SERIAL_MV("Progress:", int(card.percentDone()));
+      SERIAL_MV("% Layer:", int(printer.currentLayer));
+      SERIAL_MV("/", int(printer.maxLayer));
+      SERIAL_EMT(" Left:", buffer);
+      return;
+    }
+  #endif
+  gcode_M73_M532();
+}
 
 /**
  * M532: X<percent> L<curLayer> - update current print state progress (X=0..100) and layer L
@@ -33,11 +33,94 @@
   #define N_ARC_CORRECTION 1
 #endif
 
+#if ENABLED(ARC_ADAPTIVE_SEGMENTS)
+
+  /**
+   * Length of the segments of an arc
+   *
+   * A chord of length L leaves the circle of radius r by
+   *   e = r - SQRT(r^2 - (L/2)^2), so L = 2 * SQRT(e * (2r - e))
+   * and ARC_SEGMENT_TOLERANCE gives the longest chord.
+   *
+   * The chord can't be shorter than the planner can follow:
+   *  - A full queue must hold the distance to stop from fr_mm_s,
+   *    or the lookahead slows down every block.
+   *  - With less than half queue each block must last at least
+   *    min_segment_time_us, or the queue runs out (see SLOWDOWN).
+   * These win over the tolerance: a smooth arc a little out of
+   * tolerance is better than a stuttering one.
+   */
+  float arc_segment_mm(const float &radius, const float &fr_mm_s) {
+
+    float segment_mm = radius > 0.5f * (ARC_SEGMENT_TOLERANCE)
+      ? 2.0f * SQRT((ARC_SEGMENT_TOLERANCE) * (2.0f * radius - (ARC_SEGMENT_TOLERANCE)))
+      : MAX_MM_PER_ARC_SEGMENT;
+    NOMORE(segment_mm, MAX_MM_PER_ARC_SEGMENT);
+
+    NOLESS(segment_mm, sq(fr_mm_s) / (2.0f * mechanics.data.acceleration * (BLOCK_BUFFER_SIZE - 2)));
+
+    if (planner.movesplanned() < (BLOCK_BUFFER_SIZE) / 2)
+      NOLESS(segment_mm, fr_mm_s * mechanics.data.min_segment_time_us * 0.000001f);
+
+    return MAX(segment_mm, MIN_MM_PER_ARC_SEGMENT);
+  }
+
+#endif // ARC_ADAPTIVE_SEGMENTS
+
+#if ENABLED(ARC_STEP_INTERPOLATION)
+
+  /**
+   * The stepper can't stop an arc at the software endstops, so the box
+   * of the arc must be within them: the ends, and the points on the
+   * axes of the circle that the arc goes through.
+   */
+  bool arc_within_limits(const float (&center)[2], const float &r_P, const float &r_Q, const float &angular_travel,
+    const float &start_L, const float &end_L, const AxisEnum p_axis, const AxisEnum q_axis, const AxisEnum l_axis
+  ) {
+    const float radius = HYPOT(r_P, r_Q),
+                start_angle = ATAN2(r_Q, r_P),
+                end_angle = start_angle + angular_travel;
+
+    float low[XYZ], high[XYZ];
+    low[p_axis]  = MIN(center[0] + r_P, center[0] + radius * COS(end_angle));
+    high[p_axis] = MAX(center[0] + r_P, center[0] + radius * COS(end_angle));
+    low[q_axis]  = MIN(center[1] + r_Q, center[1] + radius * SIN(end_angle));
+    high[q_axis] = MAX(center[1] + r_Q, center[1] + radius * SIN(end_angle));
+    low[l_axis]  = MIN(start_L, end_L);
+    high[l_axis] = MAX(start_L, end_L);
+
+    for (uint8_t i = 0; i < 4; i++) {
+      // Turn from the start to the point at i * 90 degrees, the way the arc goes
+      float turn = FMOD(angular_travel < 0 ? start_angle - i * RADIANS(90) : i * RADIANS(90) - start_angle, RADIANS(360));
+      if (turn < 0) turn += RADIANS(360);
+      if (turn > ABS(angular_travel)) continue;
+      switch (i) {
+        case 0: high[p_axis] = center[0] + radius; break;
+        case 1: high[q_axis] = center[1] + radius; break;
+        case 2: low[p_axis]  = center[0] - radius; break;
+        case 3: low[q_axis]  = center[1] - radius; break;
+      }
+    }
+
+    float limited_low[XYZ], limited_high[XYZ];
+    COPY_ARRAY(limited_low, low);
+    COPY_ARRAY(limited_high, high);
+    endstops.apply_motion_limits(limited_low);
+    endstops.apply_motion_limits(limited_high);
+
+    LOOP_XYZ(axis) if (limited_low[axis] != low[axis] || limited_high[axis] != high[axis]) return false;
+    return true;
+  }
+
+#endif // ARC_STEP_INTERPOLATION
+
 /**
  * Plan an arc in 2 dimensions
  *
- * The arc is approximated by generating many small linear segments.
+ * With ARC_STEP_INTERPOLATION the stepper traces the arc in a single block if it can.
+ * Otherwise the arc is approximated by generating many small linear segments.
  * The length of each segment is configured in MM_PER_ARC_SEGMENT (Default 1mm)
+ * or, with ARC_ADAPTIVE_SEGMENTS, comes from the radius and the feedrate.
  * Arcs should only be made relatively large (over 5mm), as larger arcs with
  * larger segments will tend to be more efficient. Your slicer should have
  * options for G2/G3 arc generation. In future these options may be GCode tunable.
@@ -97,8 +180,28 @@ void plan_arc(
               mm_of_travel = linear_travel ? HYPOT(flat_mm, linear_travel) : ABS(flat_mm);
   if (mm_of_travel < 0.001f) return;
 
-  uint16_t segments = FLOOR(mm_of_travel / (MM_PER_ARC_SEGMENT));
-  if (segments == 0) segments = 1;
+  const float fr_mm_s = MMS_SCALED(mechanics.feedrate_mm_s);
+
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    // Let the stepper trace the whole arc if it can, or cut it in lines
+    const float center[2] = { center_P, center_Q };
+    if (arc_within_limits(center, r_P, r_Q, angular_travel, mechanics.current_position[l_axis], cart[l_axis], p_axis, q_axis, l_axis)
+      && planner.buffer_arc(cart, center, angular_travel, p_axis, q_axis, fr_mm_s, tools.active_extruder)
+    ) {
+      COPY_ARRAY(mechanics.current_position, cart);
+      return;
+    }
+  #endif
+
+  #if ENABLED(ARC_ADAPTIVE_SEGMENTS)
+    uint16_t segments = MIN(CEIL(mm_of_travel / arc_segment_mm(radius, fr_mm_s)), 65535.0f);
+  #else
+    uint16_t segments = FLOOR(mm_of_travel / (MM_PER_ARC_SEGMENT));
+  #endif
+  NOLESS(segments, min_segments);
+
+  // Length of each segment for the planner
+  const float segment_mm = mm_of_travel / segments;
 
   /**
    * Vector rotation by transformation matrix: r is the original vector, r_T is the rotated vector,
@@ -131,8 +234,14 @@ void plan_arc(
   const float theta_per_segment = angular_travel / segments,
               linear_per_segment = linear_travel / segments,
               extruder_per_segment = extruder_travel / segments,
-              sin_T = theta_per_segment,
-              cos_T = 1 - 0.5f * sq(theta_per_segment); // Small angle approximation
+              #if ENABLED(ARC_ADAPTIVE_SEGMENTS)
+                // Long segments of small arcs give large angles
+                sin_T = SIN(theta_per_segment),
+                cos_T = COS(theta_per_segment);
+              #else
+                sin_T = theta_per_segment,
+                cos_T = 1 - 0.5f * sq(theta_per_segment); // Small angle approximation
+              #endif
 
   // Initialize the linear axis
   raw[l_axis] = mechanics.current_position[l_axis];
@@ -140,10 +249,8 @@ void plan_arc(
   // Initialize the extruder axis
   raw[E_AXIS] = mechanics.current_position[E_AXIS];
 
-  const float fr_mm_s = MMS_SCALED(mechanics.feedrate_mm_s);
-
   #if ENABLED(SCARA_FEEDRATE_SCALING)
-    const float inv_duration = fr_mm_s / MM_PER_ARC_SEGMENT;
+    const float inv_duration = fr_mm_s / segment_mm;
   #endif
 
   millis_t next_idle_ms = millis() + 200UL;
@@ -201,7 +308,7 @@ void plan_arc(
       bedlevel.apply_leveling(raw);
     #endif
 
-    if (!planner.buffer_line(raw, fr_mm_s, tools.active_extruder, MM_PER_ARC_SEGMENT
+    if (!planner.buffer_line(raw, fr_mm_s, tools.active_extruder, segment_mm
       #if ENABLED(SCARA_FEEDRATE_SCALING)
         , inv_duration
       #endif
@@ -219,7 +326,7 @@ void plan_arc(
     bedlevel.apply_leveling(raw);
   #endif
 
-  planner.buffer_line(raw, fr_mm_s, tools.active_extruder, MM_PER_ARC_SEGMENT
+  planner.buffer_line(raw, fr_mm_s, tools.active_extruder, segment_mm
     #if ENABLED(SCARA_FEEDRATE_SCALING)
       , inv_duration
     #endif
@@ -60,7 +60,41 @@
       #endif
     }
 
-    if (parser.seen('D')) laser.raster_num_pixels = base64_decode(laser.raster_data, parser.string_arg + 1, laser.raster_raw_length);
+    if (parser.seen('D')) {
+      char * const data = parser.string_arg + 1;
+      // The text is limited by the command, the decoded line by the raster pool
+      int raw_length = MIN(laser.raster_raw_length, MIN((int)strlen(data), LASER_MAX_RASTER_LINE));
+      NOMORE(raw_length, ((RASTER_SLICE_MAX_LENGTH) / 3) * 4);
+
+      // Decode the line in a slice of the raster pool, shared by all the blocks of the move
+      raster_pool.release(laser.raster_slice);
+      laser.raster_slice = RASTER_SLICE_NONE;
+      const uint16_t slice = raster_pool.alloc(MIN((raw_length * 3) / 4 + 1, RASTER_SLICE_MAX_LENGTH));
+      uint8_t * const pixels = raster_pool.pixels(slice);
+      laser.raster_num_pixels = raw_length > 0 ? base64_decode(pixels, data, raw_length) : 0;
+      raster_pool.shrink(slice, laser.raster_num_pixels);
+
+      // Scale the image intensity based on the raster power.
+      // 100% power on a pixel basis is 255, convert back to 255 = 100.
+      #if ENABLED(LASER_REMAP_INTENSITY)
+        const int NewRange = (laser.rasterlaserpower * 255.0 / 100.0 - LASER_REMAP_INTENSITY);
+      #else
+        const int NewRange = (laser.rasterlaserpower * 255.0 / 100.0);
+      #endif
+      for (int i = 0; i < laser.raster_num_pixels; i++) {
+        #if ENABLED(LASER_REMAP_INTENSITY)
+          float NewValue = (float)((((float)pixels[i] * NewRange) / 255.0) + LASER_REMAP_INTENSITY);
+          // If less than 7%, turn off the laser tube.
+          if (NewValue <= LASER_REMAP_INTENSITY) NewValue = 0;
+        #else
+          const float NewValue = (float)(((float)pixels[i] * NewRange) / 255.0);
+        #endif
+        pixels[i] = NewValue;
+      }
+
+      laser.raster_slice = slice;
+    }
+    laser.raster_next_pixel = 0;
 
     switch (laser.raster_direction) {
       case 0: // Negative X
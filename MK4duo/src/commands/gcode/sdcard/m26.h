@@ -32,10 +32,29 @@
 
 /**
  * M26: Set SD Card file index
+ *
+ *  S<pos>    File position
+ *  L<layer>  Start of a layer of the layer index, from 1, with its E position and feedrate
  */
 inline void gcode_M26(void) {
-  if (card.isDetected() && parser.seenval('S'))
+  if (!card.isDetected()) return;
+
+  if (parser.seenval('S'))
     card.setIndex(parser.value_long());
+
+  #if ENABLED(SD_JOB_INDEX)
+    if (parser.seenval('L')) {
+      job_layer_t layer;
+      if (!job_index.get_layer(parser.value_int() - 1, layer)) {
+        SERIAL_LM(ER, "No layer");
+        return;
+      }
+      card.setIndex(layer.pos);
+      mechanics.current_position[E_AXIS] = layer.e;
+      mechanics.sync_plan_position_e();
+      mechanics.feedrate_mm_s = MMM_TO_MMS(layer.feedrate);
+    }
+  #endif
 }
 
 #endif // HAS_SD_SUPPORT
@@ -58,6 +58,12 @@ uint16_t GCodeParser::codenum;
   char *GCodeParser::command_args; // start of parameters
 #endif
 
+#if ENABLED(PREPARSED_COMMANDS)
+  const parsed_gcode_t *GCodeParser::preparsed;
+  bool  GCodeParser::value_preparsed;
+  float GCodeParser::value_fval;
+#endif
+
 // Create a global instance of the GCodeParser singleton
 GCodeParser parser;
 
@@ -78,6 +84,10 @@ void GCodeParser::reset() {
     codebits = 0;                     // No codes yet
     //ZERO(param);                    // No parameters (should be safe to comment out this line)
   #endif
+  #if ENABLED(PREPARSED_COMMANDS)
+    preparsed = NULL;                 // Values come from the line
+    value_preparsed = false;
+  #endif
 }
 // Populate all fields by parsing a single line of GCode
 // 58 bytes of SRAM are used to speed up seen/value
@@ -246,6 +256,177 @@ void GCodeParser::parse(char *p) {
   }
 }
 
+#if ENABLED(PREPARSED_COMMANDS)
+
+  /**
+   * Parse a line going into the command queue. A command may be
+   * running from the current state, so it is restored at the end.
+   * parse() cuts the checksum off in place, so it works on a copy:
+   * the queued line may still go to an M28 file with its checksum.
+   */
+  void GCodeParser::preparse(const char * const line, parsed_gcode_t &out) {
+
+    char copy[MAX_CMD_SIZE];
+    strncpy(copy, line, sizeof(copy) - 1);
+    copy[sizeof(copy) - 1] = '\0';
+
+    char * const  old_command_ptr     = command_ptr,
+         * const  old_string_arg      = string_arg,
+         * const  old_value_ptr       = value_ptr;
+    const char    old_command_letter  = command_letter;
+    const uint16_t old_codenum        = codenum;
+    #if USE_GCODE_SUBCODES
+      const uint8_t old_subcode       = subcode;
+    #endif
+    const uint32_t old_codebits       = codebits;
+    uint8_t old_param[26];
+    memcpy(old_param, param, sizeof(param));
+    const parsed_gcode_t * const old_preparsed = preparsed;
+    const bool    old_value_preparsed = value_preparsed;
+    const float   old_value_fval      = value_fval;
+
+    parse(copy);
+
+    out.command_letter  = command_letter;
+    out.codenum         = codenum;
+    #if USE_GCODE_SUBCODES
+      out.subcode       = subcode;
+    #else
+      out.subcode       = 0;
+    #endif
+    out.command_ofs     = command_ptr - copy;
+    out.string_ofs      = string_arg ? string_arg - copy : 0xFF;
+    out.end_ofs         = strlen(copy);
+    out.codebits        = codebits;
+    memcpy(out.param, param, sizeof(param));
+
+    // Convert the numbers now, in letter order
+    out.valbits = 0;
+    uint8_t n = 0;
+    for (uint8_t ind = 0; ind < COUNT(param) && n < PREPARSED_VALUES; ind++) {
+      if (!TEST32(codebits, ind) || !param[ind]) continue;
+      char * const ptr = command_ptr + param[ind];
+      if (!valid_float(ptr)) continue;
+      value_ptr = ptr;
+      out.values[n++] = value_float();
+      SBI32(out.valbits, ind);
+    }
+
+    command_ptr     = old_command_ptr;
+    string_arg      = old_string_arg;
+    value_ptr       = old_value_ptr;
+    command_letter  = old_command_letter;
+    codenum         = old_codenum;
+    #if USE_GCODE_SUBCODES
+      subcode       = old_subcode;
+    #endif
+    codebits        = old_codebits;
+    memcpy(param, old_param, sizeof(param));
+    preparsed       = old_preparsed;
+    value_preparsed = old_value_preparsed;
+    value_fval      = old_value_fval;
+  }
+
+  void GCodeParser::load(char * const line, const parsed_gcode_t &in) {
+    line[in.end_ofs] = '\0';
+    command_ptr     = line + in.command_ofs;
+    string_arg      = in.string_ofs == 0xFF ? NULL : line + in.string_ofs;
+    command_letter  = in.command_letter;
+    codenum         = in.codenum;
+    #if USE_GCODE_SUBCODES
+      subcode       = in.subcode;
+    #endif
+    codebits        = in.codebits;
+    memcpy(param, in.param, sizeof(param));
+    preparsed       = &in;
+    value_preparsed = false;
+  }
+
+#endif // PREPARSED_COMMANDS
+
+/**
+ * G-code numbers are [-+]?[0-9]*(.[0-9]*)? with a few digits, so the
+ * digits are collected in an integer mantissa and divided once by a power
+ * of ten. Mantissa up to 2^24 and 10^10 are exact in a float, so the single
+ * division gives the correctly rounded result, the same as strtof.
+ * Longer numbers go to strtof.
+ */
+#define FAST_FLOAT_MANTISSA 16777216UL  // 2^24
+#define FAST_FLOAT_DECIMALS 10
+#define FAST_LONG_DIGITS     9          // Any 9 digits fit in int32_t
+
+static const float pow10_table[FAST_FLOAT_DECIMALS + 1] PROGMEM = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+// strtof without the exponent, 'E' is a parameter letter
+static float slow_float(char * const p) {
+  char *e = p;
+  for (;;) {
+    const char c = *e;
+    if (c == '\0' || c == ' ') break;
+    if (c == 'E' || c == 'e') {
+      *e = '\0';
+      const float ret = strtof(p, NULL);
+      *e = c;
+      return ret;
+    }
+    ++e;
+  }
+  return strtof(p, NULL);
+}
+
+float GCodeParser::parse_float(char * const p) {
+  const char *s = p;
+  const bool neg = (*s == '-');
+  if (neg || *s == '+') ++s;
+
+  uint32_t mantissa = 0;
+  uint8_t decimals = 0;
+  for (; NUMERIC(*s); ++s) {
+    if (mantissa > FAST_FLOAT_MANTISSA) return slow_float(p);
+    mantissa = mantissa * 10 + (*s - '0');
+  }
+  if (*s == '.') {
+    for (++s; NUMERIC(*s); ++s, ++decimals) {
+      if (mantissa > FAST_FLOAT_MANTISSA) return slow_float(p);
+      mantissa = mantissa * 10 + (*s - '0');
+    }
+  }
+  if (mantissa > FAST_FLOAT_MANTISSA || decimals > FAST_FLOAT_DECIMALS) return slow_float(p);
+
+  float ret = float(mantissa);
+  if (decimals) ret /= pgm_read_float(&pow10_table[decimals]);
+  return neg ? -ret : ret;
+}
+
+// Magnitude of an integer value, false if it needs strtol
+static bool scan_integer(const char * const p, bool &neg, uint32_t &mag) {
+  const char *s = p;
+  neg = (*s == '-');
+  if (neg || *s == '+') ++s;
+  mag = 0;
+  for (uint8_t digits = 0; NUMERIC(*s); ++s) {
+    if (mag && ++digits >= FAST_LONG_DIGITS) return false; // Leading zeros don't count
+    mag = mag * 10 + (*s - '0');
+  }
+  return true;
+}
+
+int32_t GCodeParser::parse_long(const char * const p) {
+  bool neg;
+  uint32_t mag;
+  if (!scan_integer(p, neg, mag)) return strtol(p, NULL, 10);
+  return neg ? -int32_t(mag) : int32_t(mag);
+}
+
+uint32_t GCodeParser::parse_ulong(const char * const p) {
+  bool neg;
+  uint32_t mag;
+  if (!scan_integer(p, neg, mag)) return strtoul(p, NULL, 10);
+  return neg ? -mag : mag;
+}
+
 pin_t GCodeParser::value_pin() {
   const pin_t pin = (int8_t)value_int();
   return printer.pin_is_protected(pin) ? NoPin : pin;
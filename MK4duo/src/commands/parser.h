@@ -36,11 +36,37 @@
  *  - FASTER_GCODE_PARSER:
  *    - Flags existing params (1 bit each)
  *    - Stores value offsets (1 byte each)
+ *  - PREPARSED_COMMANDS:
+ *    - Parse a queued line ahead of time into a parsed_gcode_t
+ *    - Load it back without scanning the line again
  *  - Provide accessors for parameters:
  *    - Parameter exists
  *    - Parameter has value
  *    - Parameter value in different units and types
  */
+#if ENABLED(PREPARSED_COMMANDS)
+
+  /**
+   * Parser state kept with a queued line.
+   * Offsets are from the start of the line, values[] holds
+   * the converted numbers in letter order, one for each valbits.
+   * The line is left untouched until load() cuts it at end_ofs.
+   */
+  struct parsed_gcode_t {
+    char      command_letter; // '\0' for a line not preparsed
+    uint16_t  codenum;
+    uint8_t   subcode,
+              command_ofs,
+              string_ofs,   // 0xFF for no string_arg
+              end_ofs;      // Where parse() ends the line (checksum, M32 '#')
+    uint32_t  codebits,
+              valbits;
+    uint8_t   param[26];
+    float     values[PREPARSED_VALUES];
+  };
+
+#endif
+
 class GCodeParser {
 
   public: /** Public Parameters */
@@ -78,6 +104,12 @@ class GCodeParser {
       static char *command_args;  // Args start here, for slow scan
     #endif
 
+    #if ENABLED(PREPARSED_COMMANDS)
+      static const parsed_gcode_t *preparsed; // Set by load, NULL after parse
+      static bool   value_preparsed;          // Set by seen, value_fval is valid
+      static float  value_fval;
+    #endif
+
   public: /** Public Function */
 
     #if ENABLED(DEBUG_GCODE_PARSER)
@@ -127,6 +159,15 @@ class GCodeParser {
         const bool b = TEST32(codebits, ind);
         if (b) {
           char * const ptr = command_ptr + param[ind];
+          #if ENABLED(PREPARSED_COMMANDS)
+            if (preparsed && TEST32(preparsed->valbits, ind)) {
+              value_ptr = ptr;
+              value_fval = preparsed->values[__builtin_popcountl(preparsed->valbits & (_BV32(ind) - 1))];
+              value_preparsed = true;
+              return true;
+            }
+            value_preparsed = false;
+          #endif
           value_ptr = param[ind] && valid_float(ptr) ? ptr : (char*)NULL;
         }
         return b;
@@ -197,35 +238,35 @@ class GCodeParser {
     // This uses 54 bytes of SRAM to speed up seen/value
     static void parse(char * p);
 
+    #if ENABLED(PREPARSED_COMMANDS)
+      // Parse a line into its own state, keeping the current one
+      static void preparse(const char * const line, parsed_gcode_t &out);
+      // Make a preparsed line the current command
+      static void load(char * const line, const parsed_gcode_t &in);
+    #endif
+
     // Code value pointer was set
     FORCE_INLINE static bool has_value() { return value_ptr != NULL; }
 
     // Seen a parameter with a value
     static inline bool seenval(const char c) { return seen(c) && has_value(); }
 
+    // Number scanners for G-code values, with strtof/strtol as fallback
+    static float    parse_float(char * const p);
+    static int32_t  parse_long(const char * const p);
+    static uint32_t parse_ulong(const char * const p);
+
     // Float removes 'E' to prevent scientific notation interpretation
     static inline float value_float() {
-      if (value_ptr) {
-        char *e = value_ptr;
-        for (;;) {
-          const char c = *e;
-          if (c == '\0' || c == ' ') break;
-          if (c == 'E' || c == 'e') {
-            *e = '\0';
-            const float ret = strtof(value_ptr, NULL);
-            *e = c;
-            return ret;
-          }
-          ++e;
-        }
-        return strtof(value_ptr, NULL);
-      }
-      return 0;
+      #if ENABLED(PREPARSED_COMMANDS)
+        if (value_preparsed) return value_fval;
+      #endif
+      return value_ptr ? parse_float(value_ptr) : 0;
     }
 
     // Code value as a long or ulong
-    static inline int32_t   value_long()  { return value_ptr ? strtol(value_ptr, NULL, 10) : 0L; }
-    static inline uint32_t  value_ulong() { return value_ptr ? strtoul(value_ptr, NULL, 10) : 0UL; }
+    static inline int32_t   value_long()  { return value_ptr ? parse_long(value_ptr) : 0L; }
+    static inline uint32_t  value_ulong() { return value_ptr ? parse_ulong(value_ptr) : 0UL; }
 
     // Code value for use as time
     static inline millis_t  value_millis()              { return value_ulong(); }
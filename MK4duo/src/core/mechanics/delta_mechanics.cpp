@@ -187,7 +187,11 @@ void Delta_Mechanics::get_cartesian_from_steppers() {
     const uint16_t segments = MAX(1U, data.segments_per_second * seconds);
 
     // Now compute the number of lines needed
-    uint16_t numLines = (segments + data.segments_per_line - 1) / data.segments_per_line;
+    #if ENABLED(DELTA_ADAPTIVE_SEGMENTS)
+      uint16_t numLines = MIN(adaptive_lines(current_position, difference), segments);
+    #else
+      uint16_t numLines = (segments + data.segments_per_line - 1) / data.segments_per_line;
+    #endif
 
     // The approximate length of each segment
     const float inv_numLines = 1.0f / float(numLines),
@@ -212,6 +216,11 @@ void Delta_Mechanics::get_cartesian_from_steppers() {
     float raw[XYZE];
     COPY_ARRAY(raw, current_position);
 
+    // Tower positions of the next lines, worked out in batches
+    const float segment_xyz[XYZ] = { segment_distance[X_AXIS], segment_distance[Y_AXIS], segment_distance[Z_AXIS] };
+    float towers[TRANSFORM_BATCH][ABC];
+    uint8_t batched = 0, next = 0;
+
     // Calculate and execute the segments
     while (--numLines) {
 
@@ -223,7 +232,14 @@ void Delta_Mechanics::get_cartesian_from_steppers() {
 
       LOOP_XYZE(i) raw[i] += segment_distance[i];
 
-      if (!planner.buffer_line(raw, _feedrate_mm_s, tools.active_extruder, cartesian_segment_mm))
+      if (next == batched) {
+        const float raw_xyz[XYZ] = { raw[X_AXIS], raw[Y_AXIS], raw[Z_AXIS] };
+        batched = MIN(numLines, TRANSFORM_BATCH);
+        next = 0;
+        Transform_line(raw_xyz, segment_xyz, batched, towers);
+      }
+
+      if (!planner.buffer_line(raw, towers[next++], _feedrate_mm_s, tools.active_extruder, cartesian_segment_mm))
         break;
 
     }
@@ -236,6 +252,75 @@ void Delta_Mechanics::get_cartesian_from_steppers() {
 
 #endif // DISABLED(AUTO_BED_LEVELING_UBL)
 
+#if ENABLED(DELTA_ADAPTIVE_SEGMENTS)
+
+  #if ENABLED(DELTA_STEP_INTERPOLATION)
+
+    /**
+     * The towers follow a parabola through the ends and the middle of
+     * the line, the effector leaves the straight line by an error that
+     * grows with the cube of the line length. The parabola through the
+     * ends and the middle of the whole move is measured at 1/4 and 3/4,
+     * the worst of them gives the lines.
+     */
+    uint16_t Delta_Mechanics::adaptive_lines(const float (&start)[XYZE], const float (&difference)[XYZE]) {
+
+      const float start_xyz[XYZ] = { start[X_AXIS], start[Y_AXIS], start[Z_AXIS] },
+                  half[XYZ] = { difference[X_AXIS] * 0.5f, difference[Y_AXIS] * 0.5f, difference[Z_AXIS] * 0.5f };
+      float towers[3][ABC];
+      Transform_line(start_xyz, half, 3, towers);
+
+      float max_error = 0;
+      for (uint8_t p = 1; p <= 3; p += 2) {
+        // Parabola through the ends and the middle, at 1/4 or 3/4
+        const uint8_t near = p < 2 ? 0 : 2, far = 2 - near;
+        float curve[ABC], path[XYZ];
+        LOOP_ABC(i) curve[i] = 0.375f * towers[near][i] + 0.75f * towers[1][i] - 0.125f * towers[far][i];
+        InverseTransform(curve, path);
+        const float t = p * 0.25f,
+                    error = SQRT(sq(path[X_AXIS] - start[X_AXIS] - difference[X_AXIS] * t) + sq(path[Y_AXIS] - start[Y_AXIS] - difference[Y_AXIS] * t) + sq(path[Z_AXIS] - start[Z_AXIS] - difference[Z_AXIS] * t));
+        NOLESS(max_error, error);
+      }
+
+      return MAX(1, CEIL(cbrtf(max_error * (1.0f / (DELTA_SEGMENT_MAX_ERROR)))));
+    }
+
+  #else
+
+    /**
+     * The effector leaves the straight line by an error that grows with the
+     * square of the line length, as the towers move linearly between the
+     * ends. It is measured on the whole move and on its two halves (times 4,
+     * for the whole length) at 5 points: the worst of them gives the lines.
+     */
+    uint16_t Delta_Mechanics::adaptive_lines(const float (&start)[XYZE], const float (&difference)[XYZE]) {
+
+      const float start_xyz[XYZ] = { start[X_AXIS], start[Y_AXIS], start[Z_AXIS] },
+                  quarter[XYZ] = { difference[X_AXIS] * 0.25f, difference[Y_AXIS] * 0.25f, difference[Z_AXIS] * 0.25f };
+      float towers[5][ABC];
+      Transform_line(start_xyz, quarter, 5, towers);
+
+      // Whole move around point 2, halves around points 1 and 3
+      static const uint8_t around[3][3] = { { 0, 2, 4 }, { 0, 1, 2 }, { 2, 3, 4 } };
+      float max_error = 0;
+      for (uint8_t s = 0; s < 3; s++) {
+        const float * const a = towers[around[s][0]],
+                    * const m = towers[around[s][1]],
+                    * const b = towers[around[s][2]];
+        float line[XYZ], path[XYZ];
+        InverseTransform(m, line);
+        InverseTransform(0.5f * (a[A_AXIS] + b[A_AXIS]), 0.5f * (a[B_AXIS] + b[B_AXIS]), 0.5f * (a[C_AXIS] + b[C_AXIS]), path);
+        const float error = SQRT(sq(path[X_AXIS] - line[X_AXIS]) + sq(path[Y_AXIS] - line[Y_AXIS]) + sq(path[Z_AXIS] - line[Z_AXIS]));
+        NOLESS(max_error, s ? 4 * error : error);
+      }
+
+      return MAX(1, CEIL(SQRT(max_error * (1.0f / (DELTA_SEGMENT_MAX_ERROR)))));
+    }
+
+  #endif // DELTA_STEP_INTERPOLATION
+
+#endif // DELTA_ADAPTIVE_SEGMENTS
+
 /**
  *  Plan a move to (X, Y, Z) and set the current_position
  *  The final current_position may not be the one that was requested
@@ -390,6 +475,63 @@ void Delta_Mechanics::Transform(const float (&raw)[XYZE]) {
   Transform(raw_xyz);
 }
 
+/**
+ * Delta Transform of the points of a line
+ *
+ * The square of the rod height above point n is a quadratic in n,
+ *   rod2 - HYPOT2(dx - n * sx, dy - n * sy) = d2 + n * (2 * dot - n * s2)
+ * so it takes 2 products per tower, and s2 is the same for all of them.
+ *
+ * With DELTA_FAST_SQRT the square roots are the number times its inverse
+ * square root, from two Newton steps. A point starts from the inverse
+ * square root of the one before, or from Q_rsqrt when it is too far.
+ */
+void Delta_Mechanics::Transform_line(const float (&start)[XYZ], const float (&step)[XYZ], const uint8_t count, float (*towers)[ABC]) {
+
+  #if HOTENDS > 1
+    // Delta hotend offsets must be applied in Cartesian space
+    const float x0 = start[X_AXIS] - tools.hotend_offset[X_AXIS][tools.active_extruder],
+                y0 = start[Y_AXIS] - tools.hotend_offset[Y_AXIS][tools.active_extruder];
+  #else
+    const float x0 = start[X_AXIS], y0 = start[Y_AXIS];
+  #endif
+
+  const float s2 = HYPOT2(step[X_AXIS], step[Y_AXIS]);
+
+  float d2[ABC], dot2[ABC];
+  #if ENABLED(DELTA_FAST_SQRT)
+    float y[ABC];
+  #endif
+  LOOP_ABC(i) {
+    const float dx = towerX[i] - x0, dy = towerY[i] - y0;
+    d2[i]   = delta_diagonal_rod_2[i] - HYPOT2(dx, dy);
+    dot2[i] = 2.0f * (dx * step[X_AXIS] + dy * step[Y_AXIS]);
+    #if ENABLED(DELTA_FAST_SQRT)
+      y[i] = Q_rsqrt(d2[i]);
+    #endif
+  }
+
+  for (uint8_t n = 0; n < count; n++) {
+    const float z = start[Z_AXIS] + n * step[Z_AXIS];
+    LOOP_ABC(i) {
+      const float d = d2[i] + n * (dot2[i] - n * s2);
+      #if ENABLED(DELTA_FAST_SQRT)
+        float t = d * sq(y[i]);
+        if (!WITHIN(t, 0.998f, 1.002f)) {
+          y[i] = Q_rsqrt(d);
+          t = d * sq(y[i]);
+        }
+        y[i] *= 1.5f - 0.5f * t;
+        y[i] *= 1.5f - 0.5f * d * sq(y[i]);
+        towers[n][i] = z + d * y[i];
+      #else
+        towers[n][i] = z + SQRT(d);
+      #endif
+    }
+  }
+
+}
+
 void Delta_Mechanics::recalc_delta_settings() {
 
   // Get a minimum radius for clamping
@@ -1087,19 +1229,19 @@ void Delta_Mechanics::Set_clip_start_height() {
   delta_clip_start_height = data.height - ABS(distance - delta[A_AXIS]);
 }
 
-#if ENABLED(DELTA_FAST_SQRT) && ENABLED(__AVR__)
+#if ENABLED(DELTA_FAST_SQRT)
 
   /**
    * Fast inverse SQRT from Quake III Arena
    * See: https://en.wikipedia.org/wiki/Fast_inverse_square_root
    */
   float Delta_Mechanics::Q_rsqrt(float number) {
-    long i;
+    int32_t i;
     float x2, y;
     const float threehalfs = 1.5f;
     x2 = number * 0.5f;
     y  = number;
-    i  = * ( long * ) &y;                         // evil floating point bit level hacking
+    i  = * ( int32_t * ) &y;                         // evil floating point bit level hacking
     i  = 0x5F3759DF - ( i >> 1 );
     y  = * ( float * ) &i;
     y  = y * ( threehalfs - ( x2 * y * y ) );     // 1st iteration
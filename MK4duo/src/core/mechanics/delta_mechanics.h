@@ -132,6 +132,14 @@ class Delta_Mechanics : public Mechanics {
     static void Transform(const float (&raw)[XYZE]);
     static void recalc_delta_settings();
 
+    /**
+     * Tower positions of count points on a line, start + n * step,
+     * stored in towers[n]. Same as Transform for every point, with
+     * the terms shared by the points worked out once.
+     */
+    static constexpr uint8_t TRANSFORM_BATCH = 8;
+    static void Transform_line(const float (&start)[XYZ], const float (&step)[XYZ], const uint8_t count, float (*towers)[ABC]);
+
     /**
      * Home Delta
      */
@@ -202,7 +210,14 @@ class Delta_Mechanics : public Mechanics {
      */
     static void Set_clip_start_height();
 
-    #if ENABLED(DELTA_FAST_SQRT) && ENABLED(__AVR__)
+    #if ENABLED(DELTA_ADAPTIVE_SEGMENTS)
+      /**
+       * Number of lines for a move, from its path error
+       */
+      static uint16_t adaptive_lines(const float (&start)[XYZE], const float (&difference)[XYZE]);
+    #endif
+
+    #if ENABLED(DELTA_FAST_SQRT)
       static float Q_rsqrt(float number);
     #endif
 
@@ -250,6 +250,28 @@
 #if DISABLED(N_ARC_CORRECTION)
   #error "DEPENDENCY ERROR: Missing setting N_ARC_CORRECTION."
 #endif
+#if ENABLED(ARC_ADAPTIVE_SEGMENTS)
+  #if DISABLED(ARC_SEGMENT_TOLERANCE)
+    #error "DEPENDENCY ERROR: Missing setting ARC_SEGMENT_TOLERANCE."
+  #elif DISABLED(MIN_MM_PER_ARC_SEGMENT)
+    #error "DEPENDENCY ERROR: Missing setting MIN_MM_PER_ARC_SEGMENT."
+  #elif DISABLED(MAX_MM_PER_ARC_SEGMENT)
+    #error "DEPENDENCY ERROR: Missing setting MAX_MM_PER_ARC_SEGMENT."
+  #elif DISABLED(ARC_SUPPORT)
+    #error "DEPENDENCY ERROR: ARC_ADAPTIVE_SEGMENTS requires ARC_SUPPORT."
+  #endif
+#endif
+#if ENABLED(ARC_STEP_INTERPOLATION)
+  #if DISABLED(ARC_SUPPORT)
+    #error "DEPENDENCY ERROR: ARC_STEP_INTERPOLATION requires ARC_SUPPORT."
+  #elif NOMECH(CARTESIAN)
+    #error "DEPENDENCY ERROR: ARC_STEP_INTERPOLATION is only for Cartesian."
+  #elif ENABLED(__AVR__)
+    #error "DEPENDENCY ERROR: ARC_STEP_INTERPOLATION requires a 32 bit board."
+  #elif ENABLED(HYSTERESIS_FEATURE)
+    #error "DEPENDENCY ERROR: ARC_STEP_INTERPOLATION is not compatible with HYSTERESIS_FEATURE."
+  #endif
+#endif
 #if DISABLED(DEFAULT_AXIS_STEPS_PER_UNIT)
   #error "DEPENDENCY ERROR: Missing setting DEFAULT_AXIS_STEPS_PER_UNIT."
 #endif
@@ -539,6 +561,13 @@
     #endif
   #endif
 
+  /**
+   * Step interpolation
+   */
+  #if ENABLED(DELTA_STEP_INTERPOLATION) && ENABLED(__AVR__)
+    #error "DEPENDENCY ERROR: DELTA_STEP_INTERPOLATION needs a 32 bit board."
+  #endif
+
   /**
    * Babystepping
    */
@@ -571,6 +600,10 @@
 
 #endif // MECH(DELTA)
 
+#if ENABLED(DELTA_STEP_INTERPOLATION) && NOMECH(DELTA)
+  #error "DEPENDENCY ERROR: DELTA_STEP_INTERPOLATION is only for Delta."
+#endif
+
 // Scara settings
 #if IS_SCARA
 
@@ -209,13 +209,25 @@ void Scara_Mechanics::get_cartesian_from_steppers() {
     float raw[XYZE];
     COPY_ARRAY(raw, current_position);
 
+    // Arm angles of the next segments, worked out in batches
+    const float segment_xyz[XYZ] = { segment_distance[X_AXIS], segment_distance[Y_AXIS], segment_distance[Z_AXIS] };
+    float angles[TRANSFORM_BATCH][ABC];
+    uint8_t batched = 0, next = 0;
+
     // Calculate and execute the segments
     while (--segments) {
 
       printer.check_periodical_actions();
 
       LOOP_XYZE(i) raw[i] += segment_distance[i];
-      Transform(raw);
+
+      if (next == batched) {
+        const float raw_xyz[XYZ] = { raw[X_AXIS], raw[Y_AXIS], raw[Z_AXIS] };
+        batched = MIN(segments, TRANSFORM_BATCH);
+        next = 0;
+        Transform_line(raw_xyz, segment_xyz, batched, angles);
+      }
+      COPY_ARRAY(delta, angles[next++]);
 
       // Adjust Z if bed leveling is enabled
       #if ENABLED(AUTO_BED_LEVELING_BILINEAR)
@@ -370,6 +382,74 @@ void Scara_Mechanics::Transform(const float raw[XYZ]) {
 
 }
 
+/**
+ * Add the turn from the vector (re_p, im_p) to (re, im) to angle, when it
+ * is small enough for the first terms of the atan series. Error < 3e-8 rad.
+ */
+FORCE_INLINE static bool add_small_turn(float &angle, const float re_p, const float im_p, const float re, const float im) {
+  const float c = re * re_p + im * im_p,  // |v| |v_p| cos(turn)
+              s = im * re_p - re * im_p;  // |v| |v_p| sin(turn)
+  if (!(c > 0 && ABS(s) <= 0.25f * c)) return false;  // Also false for NaN
+  const float t = s / c, t2 = sq(t);
+  angle += t * (1.0f - t2 * (1.0f / 3.0f - t2 * (1.0f / 5.0f - t2 * (1.0f / 7.0f - t2 * (1.0f / 9.0f)))));
+  return true;
+}
+
+/**
+ * SCARA Transform of the points of a line
+ *
+ * The squared distance of point n from the centre is a quadratic in n,
+ *   HYPOT2(sx + n * dx, sy + n * dy) = r2 + n * (2 * dot + n * d2)
+ * and the cosine of the elbow takes one product from it.
+ *
+ * The three angles of Transform only turn a little from a point to the
+ * next, so after the first point each one is carried on by the turn of
+ * its vector, with no ATAN2. A large turn, or a point out of reach, takes
+ * the ATAN2 again. The first point of every call is exact, so the error
+ * of the series never adds up over more than count points.
+ */
+void Scara_Mechanics::Transform_line(const float (&start)[XYZ], const float (&step)[XYZ], const uint8_t count, float (*angles)[ABC]) {
+
+  const float sx = start[X_AXIS] - SCARA_OFFSET_X,
+              sy = start[Y_AXIS] - SCARA_OFFSET_Y,
+              r2 = HYPOT2(sx, sy),
+              d2 = HYPOT2(step[X_AXIS], step[Y_AXIS]),
+              dot2 = 2.0f * (sx * step[X_AXIS] + sy * step[Y_AXIS]),
+              inv_L1_L2_2 = 1.0f / (2.0f * L1 * L2);
+
+  // Centre-to-End, Center-to-Elbow and elbow angles with their vectors at the point before
+  float end_a = 0, elbow_a = 0, psi = 0,
+        x_p = 0, y_p = 0, SK1_p = 0, SK2_p = 0, C2_p = 0, S2_p = 0;
+
+  for (uint8_t n = 0; n < count; n++) {
+    const float x = sx + n * step[X_AXIS],
+                y = sy + n * step[Y_AXIS],
+                C2 = (r2 + n * (dot2 + n * d2) - (L1_2 + L2_2)) * inv_L1_L2_2,
+                S2 = SQRT(1 - sq(C2)),
+                SK1 = L1 + L2 * C2,
+                SK2 = L2 * S2;
+
+    if (n && add_small_turn(end_a, y_p, x_p, y, x)) {
+      // Keep the range of ATAN2(x, y)
+      if (end_a > M_PI) end_a -= 2.0f * M_PI;
+      else if (end_a <= -M_PI) end_a += 2.0f * M_PI;
+    }
+    else
+      end_a = ATAN2(x, y);
+
+    if (!n || !add_small_turn(elbow_a, SK2_p, SK1_p, SK2, SK1)) elbow_a = ATAN2(SK1, SK2);
+    if (!n || !add_small_turn(psi, C2_p, S2_p, C2, S2)) psi = ATAN2(S2, C2);
+
+    const float THETA = elbow_a - end_a;
+    angles[n][A_AXIS] = DEGREES(THETA);
+    angles[n][B_AXIS] = DEGREES(THETA + psi);
+    angles[n][C_AXIS] = start[Z_AXIS] + n * step[Z_AXIS];
+
+    x_p = x; y_p = y; SK1_p = SK1; SK2_p = SK2; C2_p = C2; S2_p = S2;
+  }
+
+}
+
 #if MECH(MORGAN_SCARA)
   bool Scara_Mechanics::move_to_cal(uint8_t delta_a, uint8_t delta_b) {
     if (printer.isRunning()) {
@@ -426,7 +506,7 @@ void Scara_Mechanics::home() {
   endstops.setEnabled(true); // Enable endstops for next homing move
 
   bool come_back = parser.boolval('B');
-  REMEMBER(feedrate_mm_s);
+  REMEMBER(fr, feedrate_mm_s);
   COPY_ARRAY(stored_position[1], current_position);
 
   if (printer.debugFeature()) DEBUG_POS(">>> home_scara", current_position);
@@ -463,7 +543,7 @@ void Scara_Mechanics::home() {
     feedrate_mm_s = homing_feedrate_mm_s[X_AXIS];
     COPY_ARRAY(destination, stored_position[1]);
     prepare_move_to_destination();
-    RESTORE(feedrate_mm_s);
+    RESTORE(fr);
   }
 
   #if HAS_NEXTION_LCD && ENABLED(NEXTION_GFX)
@@ -578,7 +658,7 @@ void Scara_Mechanics::set_axis_is_at_home(const AxisEnum axis) {
     if (axis == X_AXIS || axis == Y_AXIS) {
 
       float homeposition[XYZ];
-      LOOP_XYZ(i) homeposition[i] = base_home_pos[(AxisEnum)i];
+      LOOP_XYZ(i) homeposition[i] = data.base_home_pos[(AxisEnum)i];
 
       /**
        * Get Home position SCARA arm angles using inverse kinematics,
@@ -602,7 +682,7 @@ void Scara_Mechanics::set_axis_is_at_home(const AxisEnum axis) {
     else
   #endif
   {
-    current_position[axis] = base_home_pos[axis];
+    current_position[axis] = data.base_home_pos[axis];
   }
 
   /**
@@ -744,6 +824,7 @@ void Scara_Mechanics::report_current_position_detail() {
     print_M204();
     print_M205();
     print_M206();
+    print_M228();
   }
 
   void Scara_Mechanics::print_M92() {
@@ -859,6 +940,17 @@ void Scara_Mechanics::report_current_position_detail() {
     #endif
   }
 
+  void Scara_Mechanics::print_M228() {
+    SERIAL_LM(CFG, "Set axis max travel:");
+    SERIAL_SMV(CFG, "  M228 X", LINEAR_UNIT(data.base_pos[X_AXIS].max), 3);
+    SERIAL_MV(" Y", LINEAR_UNIT(data.base_pos[Y_AXIS].max), 3);
+    SERIAL_EMV(" Z", LINEAR_UNIT(data.base_pos[Z_AXIS].max), 3);
+    SERIAL_LM(CFG, "Set axis min travel:");
+    SERIAL_SMV(CFG, "  M228 S1 X", LINEAR_UNIT(data.base_pos[X_AXIS].min), 3);
+    SERIAL_MV(" Y", LINEAR_UNIT(data.base_pos[Y_AXIS].min), 3);
+    SERIAL_EMV(" Z", LINEAR_UNIT(data.base_pos[Z_AXIS].min), 3);
+  }
+
 #endif // DISABLED(DISABLE_M503)
 
 /** Private Function */
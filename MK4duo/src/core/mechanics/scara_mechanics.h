@@ -107,6 +107,14 @@ class Scara_Mechanics : public Mechanics {
     static void InverseTransform(const float point[XYZ], float cartesian[XYZ]) { InverseTransform(point[X_AXIS], point[Y_AXIS], cartesian); }
     static void Transform(const float raw[XYZ]);
 
+    /**
+     * Arm angles of count points on a line, start + n * step,
+     * stored in angles[n]. Same as Transform for every point, with
+     * the terms shared by the points worked out once.
+     */
+    static constexpr uint8_t TRANSFORM_BATCH = 8;
+    static void Transform_line(const float (&start)[XYZ], const float (&step)[XYZ], const uint8_t count, float (*angles)[ABC]);
+
     /**
      * MORGAN SCARA function
      */
@@ -159,6 +167,7 @@ class Scara_Mechanics : public Mechanics {
       static void print_M204();
       static void print_M205();
       static void print_M206();
+      static void print_M228();
     #endif
 
   private: /** Private Function */
@@ -98,7 +98,7 @@ float Planner::previous_speed[NUM_AXIS]   = { 0.0 },
       Planner::previous_nominal_speed_sqr = 0.0;
 
 #if ENABLED(DISABLE_INACTIVE_EXTRUDER)
-  uint8_t Planner::g_uc_extruder_last_move[EXTRUDERS] = { 0 };
+  uint16_t Planner::g_uc_extruder_last_move[EXTRUDERS] = { 0 };
 #endif
 
 #if ENABLED(XY_FREQUENCY_LIMIT)
@@ -120,6 +120,11 @@ float Planner::previous_speed[NUM_AXIS]   = { 0.0 },
   float Planner::position_cart[XYZE] = { 0.0 };
 #endif
 
+#if ENABLED(DELTA_STEP_INTERPOLATION)
+  float Planner::mid_position[ABC]  = { 0.0 };
+  bool  Planner::has_mid_position   = false;
+#endif
+
 #if ENABLED(ABORT_ON_ENDSTOP_HIT)
   #if ENABLED(ABORT_ON_ENDSTOP_HIT_DEFAULT)
     bool Planner::abort_on_endstop_hit = ABORT_ON_ENDSTOP_HIT_DEFAULT;
@@ -137,6 +142,19 @@ float Planner::previous_speed[NUM_AXIS]   = { 0.0 },
   volatile uint32_t Planner::block_buffer_runtime_us = 0;
 #endif
 
+#if ENABLED(PLANNER_STATS)
+  planner_stats_t Planner::stats = { 0, 0, 0, 0, 0, 0, BLOCK_BUFFER_SIZE };
+#endif
+
+#if ENABLED(SEGMENT_MERGING)
+  segment_merge_t Planner::merge;
+#endif
+
+#if ENABLED(ARC_STEP_INTERPOLATION)
+  arc_move_t  Planner::arc_move;
+  bool        Planner::has_arc_move = false;
+#endif
+
 /**
  * Class and Instance Methods
  */
@@ -820,6 +838,16 @@ void Planner::quick_stop() {
   const bool isr_enabled = STEPPER_ISR_ENABLED();
   if (isr_enabled) DISABLE_STEPPER_INTERRUPT();
 
+  #if ENABLED(SEGMENT_MERGING)
+    merge.count = 0;
+  #endif
+
+  #if ENABLED(LASER) && ENABLED(LASER_RASTER)
+    // Give back the raster pixels of the dropped blocks
+    for (uint8_t b = block_buffer_tail; b != block_buffer_head; b = next_block_index(b))
+      raster_pool.release(block_buffer[b].laser_raster_slice);
+  #endif
+
   // Drop all queue entries
   block_buffer_nonbusy = block_buffer_planned = block_buffer_head = block_buffer_tail;
 
@@ -892,7 +920,29 @@ float Planner::get_axis_position_mm(const AxisEnum axis) {
   return axis_steps * mechanics.steps_to_mm[axis];
 }
 
+#if ENABLED(PLANNER_STATS)
+
+  void Planner::reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    stats.min_planned = BLOCK_BUFFER_SIZE;
+  }
+
+  void Planner::print_stats() {
+    SERIAL_SMV(ECHO, "Planner blocks:", stats.blocks);
+    SERIAL_MV(" Recalculate:", stats.recalculate_count);
+    SERIAL_MV(" Avg us:", stats.recalculate_count ? stats.recalculate_us / stats.recalculate_count : 0UL);
+    SERIAL_MV(" Max us:", stats.recalculate_max_us);
+    SERIAL_MV(" Starved:", stats.starved);
+    SERIAL_MV(" Merged:", stats.merged);
+    SERIAL_EMV(" Min planned:", stats.blocks ? stats.min_planned : 0);
+  }
+
+#endif
+
 void Planner::synchronize() {
+  #if ENABLED(SEGMENT_MERGING)
+    flush_segment();
+  #endif
   while (has_blocks_queued() || cleaning_buffer_flag) {
     printer.idle();
     printer.keepalive(InProcess);
@@ -963,7 +1013,17 @@ bool Planner::buffer_steps(const int32_t (&target)[XYZE]
   block_buffer_head = next_buffer_head;
 
   // Recalculate and optimize trapezoidal speed profiles
-  recalculate();
+  #if ENABLED(PLANNER_STATS)
+    const uint32_t recalculate_start = micros();
+    recalculate();
+    const uint32_t recalculate_us = micros() - recalculate_start;
+    stats.blocks++;
+    stats.recalculate_count++;
+    stats.recalculate_us += recalculate_us;
+    NOLESS(stats.recalculate_max_us, recalculate_us);
+  #else
+    recalculate();
+  #endif
 
   // Movement successfully queued!
   return true;
@@ -1143,6 +1203,18 @@ bool Planner::fill_block(block_t * const block, bool split_move,
   #endif
   delta_mm[E_AXIS] = esteps_float * mechanics.steps_to_mm[E_AXIS_N(extruder)];
 
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    if (has_arc_move) {
+      // The plane axes of an arc go back and forth. They take the steps and the
+      // first directions traced by buffer_arc, and the whole arc for the speed limits.
+      for (uint8_t i = 0; i < 2; i++) {
+        block->steps[arc_move.axis[i]] = arc_move.steps[i];
+        delta_mm[arc_move.axis[i]] = arc_move.flat_mm;
+      }
+      block->direction_bits = (dirb & ~(_BV(arc_move.axis[0]) | _BV(arc_move.axis[1]))) | arc_move.direction_bits;
+    }
+  #endif
+
   if (block->steps[X_AXIS] < MIN_STEPS_PER_SEGMENT && block->steps[Y_AXIS] < MIN_STEPS_PER_SEGMENT && block->steps[Z_AXIS] < MIN_STEPS_PER_SEGMENT) {
     block->millimeters = ABS(delta_mm[E_AXIS]);
   }
@@ -1171,9 +1243,47 @@ bool Planner::fill_block(block_t * const block, bool split_move,
   block->steps[E_AXIS] = esteps;
   block->step_event_count = MAX(block->steps[X_AXIS], block->steps[Y_AXIS], block->steps[Z_AXIS], esteps);
 
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    // An arc turns once at every event
+    block->arc_eps = 0;
+    if (has_arc_move) {
+      block->step_event_count = arc_move.events;
+      block->arc_u    = arc_move.u;
+      block->arc_w    = arc_move.w;
+      block->arc_eps  = arc_move.eps;
+      for (uint8_t i = 0; i < 2; i++) {
+        block->arc_axis[i] = arc_move.axis[i];
+        block->arc_frac[i] = arc_move.frac[i];
+      }
+    }
+  #endif
+
   // Bail if this is a zero-length block
   if (printer.mode == PRINTER_MODE_FFF && block->step_event_count < MIN_STEPS_PER_SEGMENT) return false;
 
+  #if ENABLED(DELTA_STEP_INTERPOLATION)
+    // The towers go on a parabola through the middle of the line. Within
+    // one step of the straight line each way a tower never goes back, and
+    // an event for every step of its fastest point must be there.
+    ZERO(block->bow);
+    if (has_mid_position) {
+      int32_t bow[ABC];
+      uint32_t events = block->step_event_count;
+      LOOP_XYZ(axis) {
+        const int32_t steps = block->steps[axis];
+        bow[axis] = LROUND(4.0f * (mid_position[axis] * mechanics.data.axis_steps_per_mm[axis] - 0.5f * (position[axis] + target[axis])));
+        if (TEST(dirb, axis)) bow[axis] = -bow[axis];
+        bow[axis] = constrain(bow[axis], -steps, steps);
+        NOLESS(events, block->steps[axis] + ABS(bow[axis]));
+      }
+      // The stepper works with twice the events squared in 32 bit
+      if (events <= 32767) {
+        LOOP_XYZ(axis) block->bow[axis] = bow[axis];
+        block->step_event_count = events;
+      }
+    }
+  #endif
+
   // For a mixing extruder, get a magnified step_event_count for each
   #if ENABLED(COLOR_MIXING_EXTRUDER)
     mixer.populate_block(block->b_color);
@@ -1414,32 +1524,24 @@ bool Planner::fill_block(block_t * const block, bool split_move,
     // When operating in PULSED or RASTER modes, laser pulsing must operate in sync with movement.
     // Calculate steps between laser firings (steps_l) and consider that when determining largest
     // interval between steps for X, Y, Z, E, L to feed to the motion control code.
-    if (laser.mode == RASTER || laser.mode == PULSED) {
+    if (laser.mode == RASTER || laser.mode == PULSED)
       block->steps_l = ABS(block->millimeters * laser.ppm);
-      #if ENABLED(LASER_RASTER)
-        for (uint8_t i = 0; i < LASER_MAX_RASTER_LINE; i++) {
-          // Scale the image intensity based on the raster power.
-          // 100% power on a pixel basis is 255, convert back to 255 = 100.
-          #if ENABLED(LASER_REMAP_INTENSITY)
-            const int NewRange = (laser.rasterlaserpower * 255.0 / 100.0 - LASER_REMAP_INTENSITY);
-            float     NewValue = (float)(((((float)laser.raster_data[i] - 0) * NewRange) / 255.0) + LASER_REMAP_INTENSITY);
-          #else
-            const int NewRange = (laser.rasterlaserpower * 255.0 / 100.0);
-            float     NewValue = (float)(((((float)laser.raster_data[i] - 0) * NewRange) / 255.0));
-          #endif
-
-          #if ENABLED(LASER_REMAP_INTENSITY)
-            // If less than 7%, turn off the laser tube.
-            if (NewValue <= LASER_REMAP_INTENSITY) NewValue = 0;
-          #endif
-
-          block->laser_raster_data[i] = NewValue;
-        }
-      #endif
-    }
     else
       block->steps_l = 0;
 
+    #if ENABLED(LASER_RASTER)
+      // Raster blocks share the pixels of the G7 line, a line split in
+      // several blocks goes on from the pixel where the previous block stopped.
+      if (laser.mode == RASTER) {
+        block->laser_raster_slice = laser.raster_slice;
+        block->laser_raster_start = laser.raster_next_pixel;
+        laser.raster_next_pixel += block->steps_l;
+        raster_pool.attach(block->laser_raster_slice);
+      }
+      else
+        block->laser_raster_slice = RASTER_SLICE_NONE;
+    #endif
+
     block->step_event_count = MAX(block->step_event_count, block->steps_l);
 
     if (laser.diagnostics && block->laser_status == LASER_ON)
@@ -1577,6 +1679,15 @@ bool Planner::fill_block(block_t * const block, bool split_move,
     block->nominal_speed_sqr *= sq(speed_factor);
   }
 
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    // At the junction the plane axes go the way the arc enters
+    if (has_arc_move) for (uint8_t i = 0; i < 2; i++) {
+      const AxisEnum axis = arc_move.axis[i];
+      delta_mm[axis] = arc_move.entry[i] * arc_move.flat_mm;
+      current_speed[axis] = delta_mm[axis] * inverse_secs * speed_factor;
+    }
+  #endif
+
   // Compute and limit the acceleration rate for the trapezoid generator.
   const float steps_per_mm = block->step_event_count * inverse_millimeters;
   uint32_t accel;
@@ -1640,6 +1751,11 @@ bool Planner::fill_block(block_t * const block, bool split_move,
 
         // Check for unusual high e_D ratio to detect if a retract move was combined with the last print move due to min. steps per segment. Never execute this with advance!
         // This assumes no one will use a retract length of 0mm < retr_length < ~0.2mm and no one will print 100mm wide lines using 3mm filament or 35mm wide lines using 1.75mm filament.
+        #if ENABLED(ARC_STEP_INTERPOLATION)
+          // The chord of an arc is shorter than its path
+          if (has_arc_move) block->e_D_ratio = (target_float[E_AXIS] - position_float[E_AXIS]) / block->millimeters;
+        #endif
+
         if (block->e_D_ratio > 3.0f)
           block->use_advance_lead = false;
         else {
@@ -1683,6 +1799,21 @@ bool Planner::fill_block(block_t * const block, bool split_move,
     }
   #endif
 
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    // Keep the centripetal acceleration of an arc within the acceleration of the block.
+    // A block without acceleration (e.g. limited to 0 by LIN_ADVANCE) is left as a line.
+    if (has_arc_move && block->acceleration > 0) {
+      const float limit_sqr = block->acceleration * arc_move.radius_mm * sq(block->millimeters / arc_move.flat_mm);
+      if (block->nominal_speed_sqr > limit_sqr) {
+        const float factor = SQRT(limit_sqr / block->nominal_speed_sqr);
+        LOOP_XYZE(i) current_speed[i] *= factor;
+        block->nominal_rate = MAX(uint32_t(1), uint32_t(block->nominal_rate * factor));
+        block->nominal_speed_sqr = limit_sqr;
+        speed_factor *= factor;
+      }
+    }
+  #endif
+
   float vmax_junction_sqr; // Initial limit on the segment entry velocity (mm/s)^2
 
   #if ENABLED(JUNCTION_DEVIATION)
@@ -1756,11 +1887,27 @@ bool Planner::fill_block(block_t * const block, bool split_move,
       vmax_junction_sqr = 0;
 
     COPY_ARRAY(previous_unit_vec, unit_vec);
+    #if ENABLED(ARC_STEP_INTERPOLATION)
+      // The next block joins an arc where it leaves it
+      if (has_arc_move) for (uint8_t i = 0; i < 2; i++)
+        previous_unit_vec[arc_move.axis[i]] = arc_move.exit[i] * arc_move.flat_mm * inverse_millimeters;
+    #endif
 
   #endif // ENABLED(JUNCTION_DEVIATION)
 
   #if HAS_CLASSIC_JERK
 
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      // The towers of a bowed block enter and leave it faster or slower than its mean speed
+      float exit_speed[NUM_AXIS];
+      COPY_ARRAY(exit_speed, current_speed);
+      LOOP_XYZ(i) if (block->bow[i]) {
+        const float bend = float(block->bow[i]) / float(block->steps[i]);
+        current_speed[i] *= 1.0f + bend;
+        exit_speed[i]    *= 1.0f - bend;
+      }
+    #endif
+
     const float nominal_speed = SQRT(block->nominal_speed_sqr);
 
     // Exit speed limited by a jerk to full halt of a previous last segment
@@ -1876,7 +2023,15 @@ bool Planner::fill_block(block_t * const block, bool split_move,
   block->flag |= block->nominal_speed_sqr <= v_allowable_sqr ? BLOCK_FLAG_RECALCULATE | BLOCK_FLAG_NOMINAL_LENGTH : BLOCK_FLAG_RECALCULATE;
 
   // Update previous path unit_vector and nominal speed
-  COPY_ARRAY(previous_speed, current_speed);
+  #if ENABLED(DELTA_STEP_INTERPOLATION) && HAS_CLASSIC_JERK
+    COPY_ARRAY(previous_speed, exit_speed);
+  #else
+    COPY_ARRAY(previous_speed, current_speed);
+  #endif
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    if (has_arc_move) for (uint8_t i = 0; i < 2; i++)
+      previous_speed[arc_move.axis[i]] = arc_move.exit[i] * arc_move.flat_mm * inverse_secs * speed_factor;
+  #endif
   previous_nominal_speed_sqr = block->nominal_speed_sqr;
 
   // Update the position (only when a move was queued)
@@ -1901,6 +2056,11 @@ bool Planner::fill_block(block_t * const block, bool split_move,
  * Add a block to the buffer that just updates the position
  */
 void Planner::buffer_sync_block() {
+
+  #if ENABLED(SEGMENT_MERGING)
+    flush_segment();
+  #endif
+
   // Wait for the next available block
   uint8_t next_buffer_head;
   block_t * const block = get_next_free_block(next_buffer_head);
@@ -1910,6 +2070,10 @@ void Planner::buffer_sync_block() {
 
   block->flag = BLOCK_FLAG_SYNC_POSITION;
 
+  #if ENABLED(LASER) && ENABLED(LASER_RASTER)
+    block->laser_raster_slice = RASTER_SLICE_NONE;
+  #endif
+
   block->position[A_AXIS] = position[A_AXIS];
   block->position[B_AXIS] = position[B_AXIS];
   block->position[C_AXIS] = position[C_AXIS];
@@ -1927,6 +2091,10 @@ void Planner::buffer_sync_block() {
 
   block_buffer_head = next_buffer_head;
 
+  #if ENABLED(PLANNER_STATS)
+    stats.blocks++;
+  #endif
+
   stepper.wake_up();
 }
 
@@ -1952,6 +2120,131 @@ bool Planner::buffer_segment(const float &a, const float &b, const float &c, con
   // If we are cleaning, do not accept queuing of movements
   if (cleaning_buffer_flag) return false;
 
+  #if ENABLED(SEGMENT_MERGING)
+
+    const float target[XYZE] = { a, b, c, e };
+
+    if (merge.count) {
+      if (can_merge_segment(target, fr_mm_s, extruder)) {
+        // The held segment now ends at the new target
+        COPY_ARRAY(merge.vertex[merge.count - 1], merge.end);
+        COPY_ARRAY(merge.end, target);
+        merge.millimeters = 0.0;
+        merge.count++;
+        #if ENABLED(PLANNER_STATS)
+          stats.merged++;
+        #endif
+        if (merge.count == SEGMENT_MERGE_MAX) flush_segment();
+        return true;
+      }
+      flush_segment();
+    }
+
+    if (can_hold_segment(target)) {
+      merge.count       = 1;
+      merge.extruder    = extruder;
+      merge.fr_mm_s     = fr_mm_s;
+      merge.millimeters = millimeters;
+      LOOP_XYZ(axis) merge.start[axis] = position[axis] * mechanics.steps_to_mm[axis];
+      merge.start[E_AXIS] = position[E_AXIS] * mechanics.steps_to_mm[E_AXIS_N(extruder)];
+      COPY_ARRAY(merge.end, target);
+      return true;
+    }
+
+  #endif
+
+  return queue_segment(a, b, c, e
+    #if IS_KINEMATIC && ENABLED(JUNCTION_DEVIATION)
+      , delta_mm_cart
+    #endif
+    , fr_mm_s, extruder, millimeters
+  );
+}
+
+#if ENABLED(SEGMENT_MERGING)
+
+  void Planner::flush_segment() {
+    if (!merge.count) return;
+    merge.count = 0;
+    if (!cleaning_buffer_flag)
+      queue_segment(merge.end[X_AXIS], merge.end[Y_AXIS], merge.end[Z_AXIS], merge.end[E_AXIS], merge.fr_mm_s, merge.extruder, merge.millimeters);
+  }
+
+  /**
+   * Hold back a short XYZ segment, the next segments may be merged in it.
+   * The stepper must have something to do meanwhile.
+   */
+  bool Planner::can_hold_segment(const float (&target)[XYZE]) {
+
+    #if ENABLED(LASER)
+      if (printer.mode == PRINTER_MODE_LASER) return false;
+    #endif
+
+    if (movesplanned() < SEGMENT_MERGE_MIN_PLANNED) return false;
+
+    float length_sqr = 0.0;
+    LOOP_XYZ(axis) length_sqr += sq(target[axis] - position[axis] * mechanics.steps_to_mm[axis]);
+    return length_sqr > 0.0 && length_sqr <= sq(SEGMENT_MERGE_LENGTH);
+  }
+
+  /**
+   * A segment can be merged in the held one if it is short, goes on in
+   * the same direction and with the same feedrate and extrusion per mm,
+   * and the merged line passes near all the points it replaces.
+   */
+  bool Planner::can_merge_segment(const float (&target)[XYZE], const float &fr_mm_s, const uint8_t extruder) {
+
+    if (extruder != merge.extruder || fr_mm_s != merge.fr_mm_s) return false;
+
+    float held[XYZ], segment[XYZ], merged[XYZ],
+          held_sqr = 0.0, segment_sqr = 0.0, merged_sqr = 0.0, dot = 0.0;
+    LOOP_XYZ(axis) {
+      held[axis]    = merge.end[axis] - merge.start[axis];
+      segment[axis] = target[axis] - merge.end[axis];
+      merged[axis]  = target[axis] - merge.start[axis];
+      held_sqr     += sq(held[axis]);
+      segment_sqr  += sq(segment[axis]);
+      merged_sqr   += sq(merged[axis]);
+      dot          += held[axis] * segment[axis];
+    }
+
+    if (segment_sqr == 0.0 || segment_sqr > sq(SEGMENT_MERGE_LENGTH) || dot <= 0.0) return false;
+
+    // Extrusion per mm of the held and the new segment
+    const float held_ratio    = (merge.end[E_AXIS] - merge.start[E_AXIS]) / SQRT(held_sqr),
+                segment_ratio = (target[E_AXIS] - merge.end[E_AXIS]) / SQRT(segment_sqr);
+    if (ABS(segment_ratio - held_ratio) > (SEGMENT_MERGE_E_RATIO) * MAX(ABS(held_ratio), ABS(segment_ratio))) return false;
+
+    // Distance of the replaced points from the merged line
+    const float inv_merged_sqr = 1.0f / merged_sqr;
+    for (uint8_t v = 0; v < merge.count; v++) {
+      const float * const point = v < merge.count - 1 ? merge.vertex[v] : merge.end;
+      float offset[XYZ], offset_sqr = 0.0, projection = 0.0;
+      LOOP_XYZ(axis) {
+        offset[axis] = point[axis] - merge.start[axis];
+        offset_sqr  += sq(offset[axis]);
+        projection  += offset[axis] * merged[axis];
+      }
+      if (offset_sqr - sq(projection) * inv_merged_sqr > sq(SEGMENT_MERGE_TOLERANCE)) return false;
+    }
+
+    return true;
+  }
+
+#endif // SEGMENT_MERGING
+
+/**
+ * Planner::queue_segment
+ *
+ * Queue a linear movement in axis units, after the merging stage.
+ */
+bool Planner::queue_segment(const float &a, const float &b, const float &c, const float &e
+  #if IS_KINEMATIC && ENABLED(JUNCTION_DEVIATION)
+    , const float (&delta_mm_cart)[XYZE]
+  #endif
+  , const float &fr_mm_s, const uint8_t extruder, const float &millimeters
+) {
+
   // The target position of the tool in absolute steps
   // Calculate target position in absolute steps
   const int32_t target[XYZE] = {
@@ -1974,7 +2267,7 @@ bool Planner::buffer_segment(const float &a, const float &b, const float &c, con
   }
 
   /* <-- add a slash to enable
-    SERIAL_MV("  buffer_segment FR:", fr_mm_s);
+    SERIAL_MV("  queue_segment FR:", fr_mm_s);
     #if IS_KINEMATIC
       SERIAL_MV(" A:", a);
       SERIAL_MV(" (", position[A_AXIS]);
@@ -2035,7 +2328,11 @@ bool Planner::buffer_segment(const float &a, const float &b, const float &c, con
  *  millimeters  - the length of the movement, if known
  *  inv_duration - the reciprocal if the duration of the movement, if known (kinematic only if feeedrate scaling is enabled)
  */
-bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, const float &e, const float &fr_mm_s, const uint8_t extruder, const float millimeters/*=0.0*/) {
+bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, const float &e, const float &fr_mm_s, const uint8_t extruder, const float millimeters/*=0.0*/
+  #if IS_KINEMATIC
+    , const float * const machine/*=NULL*/
+  #endif
+) {
 
   float raw[XYZE] = { rx, ry, rz, e };
   #if HAS_POSITION_MODIFIERS
@@ -2057,7 +2354,64 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
     if (mm == 0.0)
       mm = (delta_mm_cart[X_AXIS] != 0.0 || delta_mm_cart[Y_AXIS] != 0.0) ? SQRT(sq(delta_mm_cart[X_AXIS]) + sq(delta_mm_cart[Y_AXIS]) + sq(delta_mm_cart[Z_AXIS])) : ABS(delta_mm_cart[Z_AXIS]);
 
-    mechanics.Transform(raw);
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      // The stepper moves the towers on a parabola through the middle of the line
+      has_mid_position = delta_mm_cart[X_AXIS] || delta_mm_cart[Y_AXIS];
+      if (has_mid_position) {
+        float mid[XYZE] = {
+          position_cart[X_AXIS] + 0.5f * delta_mm_cart[X_AXIS],
+          position_cart[Y_AXIS] + 0.5f * delta_mm_cart[Y_AXIS],
+          position_cart[Z_AXIS] + 0.5f * delta_mm_cart[Z_AXIS],
+          e
+        };
+        #if HAS_POSITION_MODIFIERS
+          apply_modifiers(mid);
+        #endif
+        mechanics.Transform(mid);
+        COPY_ARRAY(mid_position, mechanics.delta);
+      }
+    #endif
+
+    if (machine && raw[X_AXIS] == rx && raw[Y_AXIS] == ry) {
+      // The modifiers moved the point in Z only, so are the towers (or Z)
+      const float dz = raw[Z_AXIS] - rz;
+      #if MECH(DELTA)
+        LOOP_ABC(i) mechanics.delta[i] = machine[i] + dz;
+      #else
+        mechanics.delta[A_AXIS] = machine[A_AXIS];
+        mechanics.delta[B_AXIS] = machine[B_AXIS];
+        mechanics.delta[C_AXIS] = machine[C_AXIS] + dz;
+      #endif
+    }
+    else
+      mechanics.Transform(raw);
+
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      // A tower that turns back within the line gets two lines, split where it turns
+      static bool split_line = false;
+      if (has_mid_position && !split_line) {
+        LOOP_XYZ(axis) {
+          const float h0 = position[axis] * mechanics.steps_to_mm[axis],
+                      dh = mechanics.delta[axis] - h0,
+                      c  = 4.0f * (mid_position[axis] - h0) - 2.0f * dh;
+          if (ABS(dh) < ABS(c)) {
+            const float t = 0.5f + 0.5f * dh / c;
+            if (WITHIN(t, 0.05f, 0.95f)) {
+              split_line = true;
+              const bool queued = buffer_line(
+                position_cart[X_AXIS] + t * delta_mm_cart[X_AXIS],
+                position_cart[Y_AXIS] + t * delta_mm_cart[Y_AXIS],
+                position_cart[Z_AXIS] + t * delta_mm_cart[Z_AXIS],
+                position_cart[E_AXIS] + t * (e - position_cart[E_AXIS]),
+                fr_mm_s, extruder, millimeters * t
+              ) && buffer_line(rx, ry, rz, e, fr_mm_s, extruder, millimeters * (1.0f - t), machine);
+              split_line = false;
+              return queued;
+            }
+          }
+        }
+      }
+    #endif
 
     #if ENABLED(SCARA_FEEDRATE_SCALING)
       // For SCARA scale the feed rate from mm/s to degrees/s
@@ -2068,12 +2422,18 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
       const float feedrate = fr_mm_s;
     #endif
 
-    if (buffer_segment(mechanics.delta[A_AXIS], mechanics.delta[B_AXIS], mechanics.delta[C_AXIS], raw[E_AXIS]
+    const bool queued = buffer_segment(mechanics.delta[A_AXIS], mechanics.delta[B_AXIS], mechanics.delta[C_AXIS], raw[E_AXIS]
       #if ENABLED(JUNCTION_DEVIATION)
         , delta_mm_cart
       #endif
       , feedrate, extruder, mm
-    )) {
+    );
+
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      has_mid_position = false;
+    #endif
+
+    if (queued) {
       position_cart[X_AXIS] = rx;
       position_cart[Y_AXIS] = ry;
       position_cart[Z_AXIS] = rz;
@@ -2091,6 +2451,158 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
 
 }
 
+#if ENABLED(ARC_STEP_INTERPOLATION)
+
+  /**
+   * Planner::buffer_arc
+   *
+   * Queue a whole arc in a single block. The stepper turns the plane axes
+   * around the centre at every event and the other axes go on a line.
+   * The planner traces the arc first with the same integer math, to get
+   * the steps, the first directions and the end the stepper will reach.
+   * The next move takes up the few steps of difference from the target.
+   */
+  bool Planner::buffer_arc(const float (&cart)[XYZE], const float (&center)[2], const float &angular_travel,
+    const AxisEnum p_axis, const AxisEnum q_axis, const float &fr_mm_s, const uint8_t extruder
+  ) {
+
+    // If we are cleaning, do not accept queuing of movements
+    if (cleaning_buffer_flag) return false;
+
+    // Leveling bends the arc, the dry run and simulation modes leave it to the lines
+    #if HAS_LEVELING
+      if (bedlevel.flag.leveling_active) return false;
+    #endif
+    if (printer.debugDryrun() || printer.debugSimulation()) return false;
+
+    // A circle of steps needs the same steps per mm on both axes
+    const float steps_per_mm = mechanics.data.axis_steps_per_mm[p_axis];
+    if (steps_per_mm != mechanics.data.axis_steps_per_mm[q_axis]) return false;
+
+    #if ENABLED(SEGMENT_MERGING)
+      flush_segment();
+    #endif
+
+    const AxisEnum l_axis = AxisEnum(X_AXIS + Y_AXIS + Z_AXIS - p_axis - q_axis);
+
+    float raw[XYZE];
+    COPY_ARRAY(raw, cart);
+    #if HAS_POSITION_MODIFIERS
+      apply_modifiers(raw);
+    #endif
+
+    // The modifiers move the whole arc, the radius is the one of the start step
+    const float center_P = (center[0] + raw[p_axis] - cart[p_axis]) * steps_per_mm,
+                center_Q = (center[1] + raw[q_axis] - cart[q_axis]) * steps_per_mm,
+                radius = HYPOT(position[p_axis] - center_P, position[q_axis] - center_Q);
+
+    // u and w in 1/65536 step must stay within 32 bit
+    if (!WITHIN(radius, 4, 30000)) return false;
+
+    // Aim from the start step at the target: the previous move may end a step or two away
+    float aim = ATAN2(raw[q_axis] * steps_per_mm - center_Q, raw[p_axis] * steps_per_mm - center_P)
+              - ATAN2(position[q_axis] - center_Q, position[p_axis] - center_P) - angular_travel;
+    aim -= RADIANS(360) * FLOOR(aim / RADIANS(360) + 0.5f);
+    const float turn = angular_travel + aim;
+
+    // Centre step and fraction, the start step comes out exact
+    int32_t center_step[2] = { int32_t(FLOOR(center_P)), int32_t(FLOOR(center_Q)) };
+    uint32_t center_frac[2] = { uint32_t(LROUND((center_P - center_step[0]) * 65536.0f)), uint32_t(LROUND((center_Q - center_step[1]) * 65536.0f)) };
+    for (uint8_t i = 0; i < 2; i++) {
+      if (center_frac[i] > 0xFFFF) { center_step[i]++; center_frac[i] = 0; }
+      arc_move.frac[i] = center_frac[i];
+    }
+    arc_move.axis[0] = p_axis;
+    arc_move.axis[1] = q_axis;
+    arc_move.u = (position[p_axis] - center_step[0]) * 65536 - int32_t(center_frac[0]);
+    arc_move.w = (position[q_axis] - center_step[1]) * 65536 - int32_t(center_frac[1]);
+
+    // Up to 0.9 step at every event. Double precision for eps, or large arcs miss the end.
+    const uint32_t events = CEIL(ABS(turn) * radius / 0.9f);
+    const int32_t eps = lround(4294967296.0 * 2.0 * sin(0.5 * turn / events));
+    if (!eps) return false;
+
+    // Trace the arc as the stepper will
+    int32_t u = arc_move.u, w = arc_move.w,
+            step[2] = { position[p_axis] - center_step[0], position[q_axis] - center_step[1] };
+    uint8_t moved = 0;
+    arc_move.steps[0] = arc_move.steps[1] = 0;
+    arc_move.direction_bits = 0;
+    for (uint32_t n = events; n--;) {
+      arc_turn(u, w, eps);
+      const int32_t next[2] = { arc_index(u, center_frac[0]), arc_index(w, center_frac[1]) };
+      for (uint8_t i = 0; i < 2; i++) {
+        const int32_t d = next[i] - step[i];
+        if (!d) continue;
+        if (ABS(d) > 1) return false;
+        if (!TEST(moved, i)) {
+          SBI(moved, i);
+          if (d < 0) SBI(arc_move.direction_bits, arc_move.axis[i]);
+        }
+        arc_move.steps[i]++;
+        step[i] = next[i];
+      }
+    }
+
+    int32_t target[XYZE];
+    target[p_axis] = center_step[0] + step[0];
+    target[q_axis] = center_step[1] + step[1];
+    target[l_axis] = static_cast<int32_t>(FLOOR(raw[l_axis] * mechanics.data.axis_steps_per_mm[l_axis] + 0.5f));
+    target[E_AXIS] = static_cast<int32_t>(FLOOR(raw[E_AXIS] * mechanics.data.axis_steps_per_mm[E_AXIS_N(extruder)] + 0.5f));
+
+    // The start step is up to 0.7 step off the circle and the target is rounded,
+    // farther from the target the G-code end is not on the circle
+    if (ABS(target[p_axis] - static_cast<int32_t>(FLOOR(raw[p_axis] * steps_per_mm + 0.5f))) > 2
+     || ABS(target[q_axis] - static_cast<int32_t>(FLOOR(raw[q_axis] * steps_per_mm + 0.5f))) > 2
+    ) return false;
+
+    // The other axes and the laser pulses can't have more steps than the events
+    if (uint32_t(ABS(target[l_axis] - position[l_axis])) > events
+     || ABS(target[E_AXIS] - position[E_AXIS]) * tools.e_factor[extruder] > events
+    ) return false;
+
+    arc_move.events     = events;
+    arc_move.eps        = eps;
+    arc_move.radius_mm  = radius * mechanics.steps_to_mm[p_axis];
+    arc_move.flat_mm    = arc_move.radius_mm * ABS(turn);
+
+    const float millimeters = HYPOT(arc_move.flat_mm, (target[l_axis] - position[l_axis]) * mechanics.steps_to_mm[l_axis]);
+
+    #if ENABLED(LASER)
+      if ((laser.mode == RASTER || laser.mode == PULSED) && millimeters * laser.ppm > events) return false;
+    #endif
+
+    // Unit tangents at the ends, the way the arc turns
+    const float entry_r = (eps > 0 ? 1.0f : -1.0f) / HYPOT(float(arc_move.u), float(arc_move.w)),
+                exit_r  = (eps > 0 ? 1.0f : -1.0f) / HYPOT(float(u), float(w));
+    arc_move.entry[0] = -arc_move.w * entry_r;
+    arc_move.entry[1] =  arc_move.u * entry_r;
+    arc_move.exit[0]  = -w * exit_r;
+    arc_move.exit[1]  =  u * exit_r;
+
+    #if HAS_POSITION_FLOAT
+      float target_float[XYZE];
+      target_float[p_axis] = target[p_axis] * mechanics.steps_to_mm[p_axis];
+      target_float[q_axis] = target[q_axis] * mechanics.steps_to_mm[q_axis];
+      target_float[l_axis] = raw[l_axis];
+      target_float[E_AXIS] = raw[E_AXIS];
+    #endif
+
+    has_arc_move = true;
+    const bool queued = buffer_steps(target
+      #if HAS_POSITION_FLOAT
+        , target_float
+      #endif
+      , fr_mm_s, extruder, millimeters
+    );
+    has_arc_move = false;
+
+    if (queued) stepper.wake_up();
+    return queued;
+  }
+
+#endif // ARC_STEP_INTERPOLATION
+
 /**
  * Directly set the planner ABC position (and stepper positions)
  * converting mm (or angles for SCARA) into steps.
@@ -2099,6 +2611,10 @@ bool Planner::buffer_line(const float &rx, const float &ry, const float &rz, con
  */
 void Planner::set_machine_position_mm(const float &a, const float &b, const float &c, const float &e) {
 
+  #if ENABLED(SEGMENT_MERGING)
+    flush_segment();
+  #endif
+
   position[A_AXIS] = static_cast<int32_t>(FLOOR(a * mechanics.data.axis_steps_per_mm[A_AXIS] + 0.5f));
   position[B_AXIS] = static_cast<int32_t>(FLOOR(b * mechanics.data.axis_steps_per_mm[B_AXIS] + 0.5f));
   position[C_AXIS] = static_cast<int32_t>(FLOOR(c * mechanics.data.axis_steps_per_mm[C_AXIS] + 0.5f));
@@ -2148,6 +2664,10 @@ void Planner::set_position_mm(const float &rx, const float &ry, const float &rz,
 
 void Planner::set_e_position_mm(const float &e) {
 
+  #if ENABLED(SEGMENT_MERGING)
+    flush_segment();
+  #endif
+
   const uint8_t axis_index = E_AXIS + tools.active_extruder;
 
   #if ENABLED(FWRETRACT)
@@ -2490,6 +3010,11 @@ void Planner::reverse_pass() {
     // Only consider non sync blocks
     if (!TEST(current->flag, BLOCK_BIT_SYNC_POSITION)) {
       reverse_pass_kernel(current, next);
+
+      // The entry speed did not change, so the exit speed of all the previous
+      // blocks is the same of the last pass and their entry speeds can't change.
+      if (!TEST(current->flag, BLOCK_BIT_RECALCULATE)) return;
+
       next = current;
     }
 
@@ -2557,11 +3082,20 @@ void Planner::forward_pass() {
  * Recalculate the trapezoid speed profiles for all blocks in the plan
  * according to the entry_factor for each junction. Must be called by
  * recalculate() after updating the blocks.
+ *
+ * The passes never change the entry speed of the planned block, nor the
+ * blocks before it, so their trapezoids are still valid and the scan starts
+ * from the block that was the planned one before the passes.
  */
-void Planner::recalculate_trapezoids() {
+void Planner::recalculate_trapezoids(const uint8_t planned_block_index) {
 
   uint8_t block_index = block_buffer_tail;
 
+  // The ISR could consume the planned block while we were doing the passes,
+  // in that case start from the tail.
+  if (BLOCK_MOD(planned_block_index - block_index) < BLOCK_MOD(block_buffer_head - block_index))
+    block_index = planned_block_index;
+
   // As there could be a sync block in the head of the queue, and the next loop must not
   // recalculate the head block (as it needs to be specially handled), scan backwards until
   // we find the first non SYNC block
@@ -2670,13 +3204,16 @@ void Planner::recalculate() {
   // Initialize block index to the last block in the planner buffer.
   const uint8_t block_index = prev_block_index(block_buffer_head);
 
+  // The passes can move the planned pointer forward, keep where they started
+  const uint8_t planned_block_index = block_buffer_planned;
+
   // If there is just one block, no planning can be done. Avoid it!
-  if (block_index != block_buffer_planned) {
+  if (block_index != planned_block_index) {
     reverse_pass();
     forward_pass();
   }
 
-  recalculate_trapezoids();
+  recalculate_trapezoids(planned_block_index);
 }
 
 #if ENABLED(HYSTERESIS_FEATURE)
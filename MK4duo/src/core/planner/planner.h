@@ -43,12 +43,25 @@ typedef struct {
 
   volatile uint8_t flag;                    // Block flags (See BlockFlagEnum enum above) - Modified by ISR and main thread!
 
-  // Fields used by the motion planner to manage acceleration
-  float nominal_speed_sqr,                  // The nominal speed for this block in (mm/sec)^2
-        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
-        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
-        millimeters,                        // The total travel of this block in mm
-        acceleration;                       // acceleration mm/sec^2
+  /**
+   * Fields used by the Stepper ISR, the 8 bit ones first so they pack with the flag
+   */
+  uint8_t direction_bits;                   // The direction bit set for this block
+
+  #if EXTRUDERS > 1
+    uint8_t active_extruder;                // The extruder to move (if E move)
+  #else
+    static constexpr uint8_t active_extruder = 0;
+  #endif
+
+  #if ENABLED(LIN_ADVANCE)
+    bool use_advance_lead;
+  #endif
+
+  #if ENABLED(LASER)
+    uint8_t   laser_mode;                   // CONTINUOUS, PULSED, RASTER
+    bool      laser_status;                 // LASER_OFF, LASER_ON
+  #endif
 
   // Data used by all move blocks
   union {
@@ -60,14 +73,15 @@ typedef struct {
 
   uint32_t step_event_count;                // The number of step events required to complete this block
 
-  #if EXTRUDERS > 1
-    uint8_t active_extruder;                // The extruder to move (if E move)
-  #else
-    static constexpr uint8_t active_extruder = 0;
+  #if ENABLED(DELTA_STEP_INTERPOLATION)
+    int16_t bow[ABC];                       // Tower steps beyond the straight line, 4 times the middle one, along the direction
   #endif
 
-  #if ENABLED(COLOR_MIXING_EXTRUDER)
-    mixer_color_t b_color[MIXING_STEPPERS]; // Normalized color for the mixing steppers
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    int32_t   arc_u, arc_w,                 // Start of the arc from its centre, in 1/65536 step
+              arc_eps;                      // 2^32 times 2 * sin(turn / 2) at every event. 0 for a line
+    uint16_t  arc_frac[2];                  // Fraction of step of the centre, in 1/65536 step
+    uint8_t   arc_axis[2];                  // The axes of the plane of the arc
   #endif
 
   // Settings for the trapezoid generator
@@ -84,43 +98,118 @@ typedef struct {
     uint32_t  acceleration_rate;            // The acceleration rate used for acceleration calculation
   #endif
 
-  uint8_t direction_bits;                   // The direction bit set for this block
+  uint32_t  nominal_rate,                   // The nominal step rate for this block in step_events/sec
+            initial_rate,                   // The jerk-adjusted step rate at start of block
+            final_rate;                     // The minimal rate at exit
 
   // Advance extrusion
   #if ENABLED(LIN_ADVANCE)
-    bool      use_advance_lead;
     uint16_t  advance_speed,                // STEP timer value for extruder speed offset ISR
               max_adv_steps,                // max. advance steps to get cruising speed pressure (not always nominal_speed!)
               final_adv_steps;              // advance steps due to exit speed
-    float     e_D_ratio;
   #endif
 
-  uint32_t  nominal_rate,                   // The nominal step rate for this block in step_events/sec
-            initial_rate,                   // The jerk-adjusted step rate at start of block
-            final_rate,                     // The minimal rate at exit
-            acceleration_steps_per_s2;      // acceleration steps/sec^2
-
-  #if ENABLED(BARICUDA)
-    uint8_t valve_pressure, e_to_p_pressure;
+  #if ENABLED(COLOR_MIXING_EXTRUDER)
+    mixer_color_t b_color[MIXING_STEPPERS]; // Normalized color for the mixing steppers
   #endif
 
-  uint32_t segment_time_us;
-
   #if ENABLED(LASER)
-    uint8_t   laser_mode;       // CONTINUOUS, PULSED, RASTER
-    bool      laser_status;     // LASER_OFF, LASER_ON
-    float     laser_ppm,        // pulses per millimeter, for pulsed and raster firing modes
-              laser_intensity;  // Laser firing instensity in clock cycles for the PWM timer
-    uint32_t  laser_duration,   // Laser firing duration in microseconds, for pulsed and raster firing modes
-              steps_l;          // Step count between firings of the laser, for pulsed firing mode
+    float     laser_intensity;              // Laser firing instensity in clock cycles for the PWM timer
+    uint32_t  laser_duration,               // Laser firing duration in microseconds, for pulsed and raster firing modes
+              steps_l;                      // Step count between firings of the laser, for pulsed firing mode
 
     #if ENABLED(LASER_RASTER)
-      unsigned char laser_raster_data[LASER_MAX_RASTER_LINE];
+      uint16_t  laser_raster_slice,           // Raster pool slice with the pixels of the line
+                laser_raster_start;           // First pixel of the slice fired by this block
     #endif
   #endif
 
+  /**
+   * Fields used only by the planner, the Stepper ISR never reads them
+   */
+  float nominal_speed_sqr,                  // The nominal speed for this block in (mm/sec)^2
+        entry_speed_sqr,                    // Entry speed at previous-current junction in (mm/sec)^2
+        max_entry_speed_sqr,                // Maximum allowable junction entry speed in (mm/sec)^2
+        millimeters,                        // The total travel of this block in mm
+        acceleration;                       // acceleration mm/sec^2
+
+  uint32_t  acceleration_steps_per_s2,      // acceleration steps/sec^2
+            segment_time_us;
+
+  #if ENABLED(LIN_ADVANCE)
+    float e_D_ratio;
+  #endif
+
+  #if ENABLED(LASER)
+    float laser_ppm;                        // pulses per millimeter, for pulsed and raster firing modes
+  #endif
+
+  #if ENABLED(BARICUDA)
+    uint8_t valve_pressure, e_to_p_pressure;
+  #endif
+
 } block_t;
 
+#if ENABLED(PLANNER_STATS)
+
+  /**
+   * struct planner_stats_t
+   *
+   * Throughput counters of the planner, reported by M46
+   */
+  typedef struct {
+    uint32_t  blocks,                       // Blocks queued, move and sync
+              recalculate_count,            // Calls to recalculate()
+              recalculate_us,               // Total time spent in recalculate()
+              recalculate_max_us,           // Longest recalculate()
+              starved,                      // Blocks started with less than 3 moves planned
+              merged;                       // Segments merged in the previous one
+    uint8_t   min_planned;                  // Fewest moves planned when a block was started
+  } planner_stats_t;
+
+#endif
+
+#if ENABLED(ARC_STEP_INTERPOLATION)
+
+  /**
+   * struct arc_move_t
+   *
+   * The arc traced by the planner for the block it is filling
+   */
+  typedef struct {
+    AxisEnum  axis[2];                                // The axes of the plane
+    int32_t   u, w, eps;                              // As in block_t
+    uint16_t  frac[2];
+    uint32_t  steps[2],                               // Steps of the plane axes, both ways
+              events;                                 // Turns from the start to the end
+    uint8_t   direction_bits;                         // First direction of the plane axes
+    float     radius_mm,
+              flat_mm,                                // Length of the arc in the plane
+              entry[2], exit[2];                      // Unit tangents at the ends
+  } arc_move_t;
+
+#endif
+
+#if ENABLED(SEGMENT_MERGING)
+
+  /**
+   * struct segment_merge_t
+   *
+   * The short segment held back by the planner while the next
+   * segments can be merged in it
+   */
+  typedef struct {
+    uint8_t   count,                                  // Segments merged, 0 if none is held
+              extruder;
+    float     fr_mm_s,
+              millimeters,                            // Length given by the caller, only for a single segment
+              start[XYZE],                            // Start of the held segment
+              end[XYZE],                              // End of the last merged segment
+              vertex[SEGMENT_MERGE_MAX - 1][XYZ];     // Inner ends, to check the chord error
+  } segment_merge_t;
+
+#endif
+
 #define BLOCK_MOD(n) ((n)&(BLOCK_BUFFER_SIZE-1))
 
 class Planner {
@@ -165,6 +254,11 @@ class Planner {
       static float position_cart[XYZE];
     #endif
 
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      static float  mid_position[ABC];  // Tower heights at the middle of the line buffer_line is queuing
+      static bool   has_mid_position;
+    #endif
+
     #if ENABLED(ABORT_ON_ENDSTOP_HIT)
       static bool abort_on_endstop_hit;
     #endif
@@ -174,6 +268,10 @@ class Planner {
                     hysteresis_correction;
     #endif
 
+    #if ENABLED(PLANNER_STATS)
+      static planner_stats_t stats;
+    #endif
+
   private: /** Private Parameters */
 
     /**
@@ -201,7 +299,7 @@ class Planner {
       /**
        * Counters to manage disabling inactive extruders
        */
-      static uint8_t g_uc_extruder_last_move[EXTRUDERS];
+      static uint16_t g_uc_extruder_last_move[EXTRUDERS];
     #endif // DISABLE_INACTIVE_EXTRUDER
 
     #if ENABLED(XY_FREQUENCY_LIMIT)
@@ -217,6 +315,15 @@ class Planner {
       volatile static uint32_t block_buffer_runtime_us; // Theoretical block buffer runtime in µs
     #endif
 
+    #if ENABLED(SEGMENT_MERGING)
+      static segment_merge_t merge;
+    #endif
+
+    #if ENABLED(ARC_STEP_INTERPOLATION)
+      static arc_move_t arc_move;
+      static bool       has_arc_move;
+    #endif
+
   public: /** Public Function */
 
     static void reset_acceleration_rates();
@@ -227,6 +334,11 @@ class Planner {
      */
     static void check_axes_activity();
 
+    #if ENABLED(PLANNER_STATS)
+      static void reset_stats();
+      static void print_stats();
+    #endif
+
     #if ENABLED(FWRETRACT)
 
       static void apply_retract(float &rz, float &e);
@@ -374,6 +486,13 @@ class Planner {
       , const float &fr_mm_s, const uint8_t extruder, const float &millimeters=0.0
     );
 
+    #if ENABLED(SEGMENT_MERGING)
+      /**
+       * Queue the segment held back for merging, if any
+       */
+      static void flush_segment();
+    #endif
+
     FORCE_INLINE static bool buffer_segment(const float (&abce)[ABCE]
       #if IS_KINEMATIC && ENABLED(JUNCTION_DEVIATION)
         , const float (&delta_mm_cart)[XYZE]
@@ -399,7 +518,11 @@ class Planner {
      *  extruder    - target extruder
      *  millimeters - the length of the movement, if known
      */
-    static bool buffer_line(const float &rx, const float &ry, const float &rz, const float &e, const float &fr_mm_s, const uint8_t extruder, const float millimeters=0.0);
+    static bool buffer_line(const float &rx, const float &ry, const float &rz, const float &e, const float &fr_mm_s, const uint8_t extruder, const float millimeters=0.0
+      #if IS_KINEMATIC
+        , const float * const machine=NULL
+      #endif
+    );
 
     FORCE_INLINE static bool buffer_line(const float (&cart)[XYZE], const float &fr_mm_s, const uint8_t extruder, const float millimeters=0.0
       #if ENABLED(SCARA_FEEDRATE_SCALING)
@@ -413,6 +536,56 @@ class Planner {
       );
     }
 
+    #if ENABLED(ARC_STEP_INTERPOLATION)
+
+      /**
+       * Planner::buffer_arc
+       *
+       * Add a whole G2/G3 arc to the buffer as a single block, traced by the stepper.
+       *
+       *  cart           - target position in mm
+       *  center         - centre of the arc in the p and q axes
+       *  angular_travel - turn in radians, negative for clockwise
+       *  p_axis, q_axis - the axes of the plane
+       *  fr_mm_s        - (target) speed of the move
+       *  extruder       - target extruder
+       *
+       * Returns false if the arc must be cut in lines
+       */
+      static bool buffer_arc(const float (&cart)[XYZE], const float (&center)[2], const float &angular_travel,
+        const AxisEnum p_axis, const AxisEnum q_axis, const float &fr_mm_s, const uint8_t extruder
+      );
+
+      /**
+       * One event of an arc: turn the point (u, w) around the centre with three
+       * shears, as the Minsky circle algorithm (HAKMEM item 149) split in half
+       * steps. With eps = 2 * sin(t / 2) it turns by exactly t, stays within
+       * eps^2 * r / 8 of the circle and needs no trigonometry. Each shear can
+       * be undone in integers, so the point never drifts in or out.
+       * u, w are in 1/65536 step, eps is in 1/2^32.
+       */
+      FORCE_INLINE static void arc_turn(int32_t &u, int32_t &w, const int32_t eps) {
+        u -= int32_t((int64_t(eps) * w + 0x100000000LL) >> 33);
+        w += int32_t((int64_t(eps) * u + 0x80000000LL) >> 32);
+        u -= int32_t((int64_t(eps) * w + 0x100000000LL) >> 33);
+      }
+
+      // The step of an axis for u or w, from the centre step
+      FORCE_INLINE static int32_t arc_index(const int32_t uw, const uint16_t frac) { return (uw + int32_t(frac) + 0x8000) >> 16; }
+
+    #endif
+
+    #if IS_KINEMATIC
+      /**
+       * As above, with the machine position of the point already known,
+       * e.g. from mechanics.Transform_line(). It is used as long as the
+       * position modifiers move the point in Z only.
+       */
+      FORCE_INLINE static bool buffer_line(const float (&cart)[XYZE], const float (&machine)[ABC], const float &fr_mm_s, const uint8_t extruder, const float millimeters=0.0) {
+        return buffer_line(cart[X_AXIS], cart[Y_AXIS], cart[Z_AXIS], cart[E_AXIS], fr_mm_s, extruder, millimeters, machine);
+      }
+    #endif
+
     /**
      * Set the planner.position and individual stepper positions.
      * Used by G92, G28, G29, and other procedures.
@@ -489,8 +662,12 @@ class Planner {
      * NB: There MUST be a current block to call this function!!
      */
     FORCE_INLINE static void discard_current_block() {
-      if (has_blocks_queued())
+      if (has_blocks_queued()) {
+        #if ENABLED(LASER) && ENABLED(LASER_RASTER)
+          raster_pool.release(block_buffer[block_buffer_tail].laser_raster_slice);
+        #endif
         block_buffer_tail = next_block_index(block_buffer_tail);
+      }
     }
 
     /**
@@ -525,6 +702,11 @@ class Planner {
           block_buffer_runtime_us -= block->segment_time_us; // We can't be sure how long an active block will take, so don't count it.
         #endif
 
+        #if ENABLED(PLANNER_STATS)
+          if (nr_moves < 3) stats.starved++;
+          NOMORE(stats.min_planned, nr_moves);
+        #endif
+
         // As this block is busy, advance the nonbusy block pointer
         block_buffer_nonbusy = next_block_index(block_buffer_tail);
 
@@ -645,13 +827,25 @@ class Planner {
 
     static void calculate_trapezoid_for_block(block_t* const block, const float &entry_factor, const float &exit_factor);
 
+    static bool queue_segment(const float &a, const float &b, const float &c, const float &e
+      #if IS_KINEMATIC && ENABLED(JUNCTION_DEVIATION)
+        , const float (&delta_mm_cart)[XYZE]
+      #endif
+      , const float &fr_mm_s, const uint8_t extruder, const float &millimeters
+    );
+
+    #if ENABLED(SEGMENT_MERGING)
+      static bool can_hold_segment(const float (&target)[XYZE]);
+      static bool can_merge_segment(const float (&target)[XYZE], const float &fr_mm_s, const uint8_t extruder);
+    #endif
+
     static void reverse_pass_kernel(block_t* const current, const block_t* const next);
     static void forward_pass_kernel(const block_t* const previous, block_t* const current, const uint8_t block_index);
 
     static void reverse_pass();
     static void forward_pass();
 
-    static void recalculate_trapezoids();
+    static void recalculate_trapezoids(const uint8_t planned_block_index);
 
     static void recalculate();
 
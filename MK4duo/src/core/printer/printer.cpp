@@ -301,6 +301,14 @@ void Printer::loop() {
 
       card.checkautostart();
 
+      #if ENABLED(GCODE_INFO_INDEX)
+        card.update_info_index();
+      #endif
+
+      #if ENABLED(SD_JOB_INDEX)
+        job_index.update();
+      #endif
+
       if (card.isAbortSDprinting()) {
         card.setAbortSDprinting(false);
 
@@ -336,6 +344,7 @@ void Printer::loop() {
 
     commands.get_available();
     commands.advance_queue();
+
     endstops.report_state();
     idle();
 
@@ -541,6 +550,12 @@ void Printer::idle(const bool ignore_stepper_queue/*=false*/) {
 
   handle_safety_watch();
 
+  // Queue the segment held for merging before the planner runs dry.
+  // An empty command queue is not enough, a host sends the next move after the ok.
+  #if ENABLED(SEGMENT_MERGING)
+    if (planner.movesplanned() < SEGMENT_MERGE_MIN_PLANNED) planner.flush_segment();
+  #endif
+
   if (max_inactivity_watch.stopwatch && max_inactivity_watch.elapsed()) {
     SERIAL_LMT(ER, MSG_KILL_INACTIVE_TIME, parser.command_ptr);
     kill(PSTR(MSG_KILLED));
@@ -548,6 +563,11 @@ void Printer::idle(const bool ignore_stepper_queue/*=false*/) {
 
   sound.spin();
 
+  // Finish the erase of the old FLASH pages while no move is running
+  #if HAS_EEPROM_FLASH
+    if (!planner.has_blocks_queued()) memorystore.spin();
+  #endif
+
   #if HAS_MAX31855 || HAS_MAX6675
     thermalManager.getTemperature_SPI();
   #endif
@@ -568,6 +588,10 @@ void Printer::idle(const bool ignore_stepper_queue/*=false*/) {
     rfid522.spin();
   #endif
 
+  #if ENABLED(STEP_TRACE)
+    steptrace.spin();
+  #endif
+
   // Prevent steppers timing-out in the middle of M600
   #if ENABLED(ADVANCED_PAUSE_FEATURE) && ENABLED(PAUSE_PARK_NO_STEPPER_TIMEOUT)
     #define MOVE_AWAY_TEST !advancedpause.did_pause_print
@@ -130,6 +130,20 @@ uint32_t  Stepper::advance_dividend[XYZE] = { 0 },
           Stepper::decelerate_after       = 0,  // The point from where we need to start decelerating
           Stepper::step_event_count       = 0;  // The total event count for the current block
 
+#if ENABLED(DELTA_STEP_INTERPOLATION)
+  int32_t Stepper::advance_bow[ABC]       = { 0 };
+#endif
+
+#if ENABLED(ARC_STEP_INTERPOLATION)
+  bool      Stepper::arc_active           = false;
+  int32_t   Stepper::arc_u                = 0,
+            Stepper::arc_w                = 0,
+            Stepper::arc_eps              = 0,
+            Stepper::arc_step[2]          = { 0 };
+  uint16_t  Stepper::arc_frac[2]          = { 0 };
+  AxisEnum  Stepper::arc_axis[2]          = { X_AXIS, Y_AXIS };
+#endif
+
 #if EXTRUDERS > 1 || ENABLED(COLOR_MIXING_EXTRUDER)
   uint8_t Stepper::active_extruder        = 0,
           Stepper::active_extruder_driver = 0;
@@ -518,6 +532,11 @@ void Stepper::Step() {
     // Advance pulses if not enough time to wait for the next ISR
   } while (next_isr_ticks < min_ticks);
 
+  #if ENABLED(STEP_TRACE)
+    // The timer restarts from 0 at the next ISR
+    steptrace.add_ticks(next_isr_ticks);
+  #endif
+
   // Schedule next interrupt
   HAL_timer_set_count(STEPPER_TIMER, hal_timer_t(next_isr_ticks));
 
@@ -1277,6 +1296,14 @@ void Stepper::pulse_phase_step() {
     // Start an active pulse
     pulse_tick_start();
 
+    #if ENABLED(STEP_TRACE)
+      if (steptrace.active) {
+        uint8_t step_bits = 0;
+        LOOP_XYZE(i) if (delta_error[i] >= 0) SBI(step_bits, i);
+        steptrace.record(step_bits, last_direction_bits);
+      }
+    #endif
+
     if (minimum_pulse) {
       // Just wait for the requested pulse time.
       while (HAL_timer_get_current_count(STEPPER_TIMER) < pulse_end) { /* nada */ }
@@ -1297,7 +1324,7 @@ void Stepper::pulse_phase_step() {
           if (current_block->laser_mode == RASTER && current_block->laser_status == LASER_ON) { // Raster Firing Mode
             // For some reason, when comparing raster power to ppm line burns the rasters were around 2% more powerful
             // going from darkened paper to burning through paper.
-            laser.fire(current_block->laser_raster_data[counter_raster]);
+            laser.fire(raster_pool.pixel(current_block->laser_raster_slice, current_block->laser_raster_start + counter_raster));
             counter_raster++;
           }
         #endif // LASER_RASTER
@@ -1463,6 +1490,10 @@ uint32_t Stepper::block_phase_step() {
           return interval; // No more queued movements!
       }
 
+      #if ENABLED(STEP_TRACE)
+        steptrace.block_start();
+      #endif
+
       // Flag all moving axes for proper endstop handling
 
       #if IS_CORE
@@ -1540,6 +1571,10 @@ uint32_t Stepper::block_phase_step() {
 
       uint8_t oversampling = 0;                           // Assume we won't use it
 
+      #if ENABLED(DELTA_STEP_INTERPOLATION)
+        const bool bowed = current_block->bow[A_AXIS] || current_block->bow[B_AXIS] || current_block->bow[C_AXIS];
+      #endif
+
       #if ENABLED(ADAPTIVE_STEP_SMOOTHING)
         // At this point, we must decide if we can use Stepper movement axis smoothing.
         uint32_t max_rate = current_block->nominal_rate;  // Get the maximum rate (maximum event speed)
@@ -1548,6 +1583,14 @@ uint32_t Stepper::block_phase_step() {
           if (max_rate >= HAL_frequency_limit[0]) break;
           ++oversampling;
         }
+        #if ENABLED(DELTA_STEP_INTERPOLATION)
+          // A parabola needs twice the events squared within 32 bit
+          if (bowed) while (oversampling && (current_block->step_event_count << oversampling) > 32767) --oversampling;
+        #endif
+        #if ENABLED(ARC_STEP_INTERPOLATION)
+          // An arc turns once at every event
+          if (current_block->arc_eps) oversampling = 0;
+        #endif
         oversampling_factor = oversampling;
       #endif
 
@@ -1571,6 +1614,41 @@ uint32_t Stepper::block_phase_step() {
       // Calculate Bresenham divisor
       advance_divisor = step_event_count << 1;
 
+      #if ENABLED(DELTA_STEP_INTERPOLATION)
+        /**
+         * The towers of a bowed block go on a parabola: after n of the N
+         * events a tower is at steps * n / N + bow * n * (N - n) / N^2
+         * along its direction. In units of 1 / (2 * N^2) step the dividend
+         * of event n is 2 * N * steps + 2 * bow * (N - 2n - 1), it changes
+         * by -4 * bow at every event and stays exact in 32 bit.
+         */
+        LOOP_XYZ(i) advance_bow[i] = -4 * int32_t(current_block->bow[i]);
+        if (bowed) {
+          const uint32_t N = step_event_count;
+          LOOP_XYZ(i) advance_dividend[i] = (N * current_block->steps[i] + int32_t(current_block->bow[i]) * int32_t(N - 1)) << 1;
+          advance_dividend[E_AXIS] = (N * current_block->steps[E_AXIS]) << 1;
+          advance_divisor = (N * N) << 1;
+          delta_error[X_AXIS] = delta_error[Y_AXIS] = delta_error[Z_AXIS] = delta_error[E_AXIS] = -int32_t(N * N);
+        }
+      #endif
+
+      #if ENABLED(ARC_STEP_INTERPOLATION)
+        // The plane axes of an arc are stepped by arc_tick(), not by Bresenham
+        arc_active = current_block->arc_eps != 0;
+        if (arc_active) {
+          arc_u   = current_block->arc_u;
+          arc_w   = current_block->arc_w;
+          arc_eps = current_block->arc_eps;
+          for (uint8_t i = 0; i < 2; i++) {
+            arc_axis[i] = AxisEnum(current_block->arc_axis[i]);
+            arc_frac[i] = current_block->arc_frac[i];
+            advance_dividend[arc_axis[i]] = 0;
+          }
+          arc_step[0] = planner.arc_index(arc_u, arc_frac[0]);
+          arc_step[1] = planner.arc_index(arc_w, arc_frac[1]);
+        }
+      #endif
+
       // No step events completed so far
       step_events_completed = 0;
 
@@ -1679,10 +1757,64 @@ uint32_t Stepper::block_phase_step() {
   return interval;
 }
 
+#if ENABLED(ARC_STEP_INTERPOLATION)
+
+  /**
+   * Step a plane axis of the arc if its step changed, after turning it
+   * around if needed. Bresenham only looks at the sign of delta_error.
+   */
+  FORCE_INLINE void Stepper::arc_axis_tick(const uint8_t i, const int32_t step) {
+
+    const AxisEnum axis = arc_axis[i];
+
+    if (step == arc_step[i]) {
+      delta_error[axis] = -1;
+      return;
+    }
+
+    const bool reverse = step < arc_step[i];
+    arc_step[i] = step;
+
+    if (reverse != motor_direction(axis)) {
+      if (reverse) SBI(last_direction_bits, axis); else CBI(last_direction_bits, axis);
+      switch (axis) {
+        #if HAS_X_DIR
+          case X_AXIS: set_X_dir(reverse ? isStepDir(X_AXIS) : !isStepDir(X_AXIS)); break;
+        #endif
+        #if HAS_Y_DIR
+          case Y_AXIS: set_Y_dir(reverse ? isStepDir(Y_AXIS) : !isStepDir(Y_AXIS)); break;
+        #endif
+        #if HAS_Z_DIR
+          case Z_AXIS: set_Z_dir(reverse ? isStepDir(Z_AXIS) : !isStepDir(Z_AXIS)); break;
+        #endif
+        default: break;
+      }
+      count_direction[axis] = reverse ? -1 : 1;
+      if (direction_delay >= 50) HAL::delayNanoseconds(direction_delay);
+    }
+
+    delta_error[axis] = 0;
+  }
+
+  FORCE_INLINE void Stepper::arc_tick() {
+    planner.arc_turn(arc_u, arc_w, arc_eps);
+    arc_axis_tick(0, planner.arc_index(arc_u, arc_frac[0]));
+    arc_axis_tick(1, planner.arc_index(arc_w, arc_frac[1]));
+  }
+
+#endif // ARC_STEP_INTERPOLATION
+
 FORCE_INLINE void Stepper::pulse_tick_start() {
 
+  #if ENABLED(ARC_STEP_INTERPOLATION)
+    if (arc_active) arc_tick();
+  #endif
+
   #if HAS_X_STEP
     delta_error[X_AXIS] += advance_dividend[X_AXIS];
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      advance_dividend[X_AXIS] += advance_bow[X_AXIS];
+    #endif
     if (delta_error[X_AXIS] >= 0) {
       start_X_step();
       count_position[X_AXIS] += count_direction[X_AXIS];
@@ -1691,6 +1823,9 @@ FORCE_INLINE void Stepper::pulse_tick_start() {
 
   #if HAS_Y_STEP
     delta_error[Y_AXIS] += advance_dividend[Y_AXIS];
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      advance_dividend[Y_AXIS] += advance_bow[Y_AXIS];
+    #endif
     if (delta_error[Y_AXIS] >= 0) {
       start_Y_step();
       count_position[Y_AXIS] += count_direction[Y_AXIS];
@@ -1699,6 +1834,9 @@ FORCE_INLINE void Stepper::pulse_tick_start() {
 
   #if HAS_Z_STEP
     delta_error[Z_AXIS] += advance_dividend[Z_AXIS];
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      advance_dividend[Z_AXIS] += advance_bow[Z_AXIS];
+    #endif
     if (delta_error[Z_AXIS] >= 0) {
       start_Z_step();
       count_position[Z_AXIS] += count_direction[Z_AXIS];
@@ -2197,6 +2335,10 @@ void Stepper::_set_position(const int32_t &a, const int32_t &b, const int32_t &c
         E_STEP_WRITE(active_extruder_driver, !INVERT_E_STEP_PIN);
       #endif
 
+      #if ENABLED(STEP_TRACE)
+        steptrace.record(_BV(E_AXIS), LA_steps < 0 ? (last_direction_bits | _BV(E_AXIS)) : (last_direction_bits & ~_BV(E_AXIS)), STEP_TRACE_ADVANCE);
+      #endif
+
       if (minimum_pulse) {
         // Just wait for the requested pulse time.
         while (HAL_timer_get_current_count(STEPPER_TIMER) < pulse_end) { /* nada */ }
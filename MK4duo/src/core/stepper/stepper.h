@@ -101,6 +101,19 @@ class Stepper {
                     decelerate_after,       // The point from where we need to start decelerating
                     step_event_count;       // The total event count for the current block
 
+    #if ENABLED(DELTA_STEP_INTERPOLATION)
+      static int32_t advance_bow[ABC];      // Change of the tower dividends at every event, for the parabola
+    #endif
+
+    #if ENABLED(ARC_STEP_INTERPOLATION)
+      static bool     arc_active;           // The current block is an arc, arc_tick() steps its plane axes
+      static int32_t  arc_u, arc_w,         // Point of the arc from its centre, as in block_t
+                      arc_eps,              // Turn at every event
+                      arc_step[2];          // Steps of the plane axes from the centre
+      static uint16_t arc_frac[2];
+      static AxisEnum arc_axis[2];
+    #endif
+
     #if EXTRUDERS > 1 || ENABLED(COLOR_MIXING_EXTRUDER)
       static uint8_t  active_extruder,        // Active extruder
                       active_extruder_driver; // Active extruder driver
@@ -358,6 +371,14 @@ class Stepper {
      */
     static void pulse_tick_stop();
 
+    #if ENABLED(ARC_STEP_INTERPOLATION)
+      /**
+       * Turn the arc by one event and set the steps of its plane axes
+       */
+      static void arc_tick();
+      static void arc_axis_tick(const uint8_t i, const int32_t step);
+    #endif
+
     /**
      * Start step X Y Z
      */
@@ -65,8 +65,10 @@
 
   #if ENABLED(LASER_RASTER)
 
-    unsigned char Laser::raster_data[LASER_MAX_RASTER_LINE] = { 0 },
-                  Laser::rasterlaserpower                   = 0;
+    unsigned char Laser::rasterlaserpower     = 0;
+
+    uint16_t      Laser::raster_slice         = RASTER_SLICE_NONE,
+                  Laser::raster_next_pixel    = 0;
 
     float         Laser::raster_aspect_ratio  = 0.0,
                   Laser::raster_mm_per_pulse  = 0.0;
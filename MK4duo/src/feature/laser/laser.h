@@ -66,8 +66,10 @@
 
       #if ENABLED(LASER_RASTER)
 
-        static unsigned char  raster_data[LASER_MAX_RASTER_LINE],
-                              rasterlaserpower;
+        static unsigned char  rasterlaserpower;
+
+        static uint16_t       raster_slice,       // Raster pool slice of the last G7 D line
+                              raster_next_pixel;  // First pixel of the next raster block
 
         static float          raster_aspect_ratio,
                               raster_mm_per_pulse;
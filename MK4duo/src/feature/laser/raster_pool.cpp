@@ -0,0 +1,134 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * raster_pool.cpp
+ *
+ * Decoded G7 raster lines, shared by the planner blocks that fire them.
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(LASER) && ENABLED(LASER_RASTER)
+
+  RasterPool raster_pool;
+
+  uint32_t          RasterPool::pool[(LASER_RASTER_POOL_SIZE) / 4]  = { 0 };
+  volatile uint16_t RasterPool::head                                = 0,
+                    RasterPool::tail                                = 0;
+
+  void RasterPool::clear() {
+    const bool isr_enabled = STEPPER_ISR_ENABLED();
+    if (isr_enabled) DISABLE_STEPPER_INTERRUPT();
+    head = tail = 0;
+    if (isr_enabled) ENABLE_STEPPER_INTERRUPT();
+  }
+
+  uint16_t RasterPool::alloc(const uint16_t length) {
+    const uint16_t size = slice_size(length);
+    uint16_t slice;
+    while ((slice = try_alloc(size)) == RASTER_SLICE_NONE) printer.idle();
+
+    raster_slice_t &h = header(slice);
+    h.length  = length;
+    h.refs    = 1;
+    h.wrap    = false;
+
+    // Publish the slice to the Stepper ISR
+    head = (slice + size) % (LASER_RASTER_POOL_SIZE);
+    return slice;
+  }
+
+  void RasterPool::shrink(const uint16_t slice, const uint16_t length) {
+    raster_slice_t &h = header(slice);
+    if (length >= h.length) return;
+    // Only the last slice can give back its room
+    if (head == (slice + slice_size(h.length)) % (LASER_RASTER_POOL_SIZE))
+      head = (slice + slice_size(length)) % (LASER_RASTER_POOL_SIZE);
+    h.length = length;
+  }
+
+  void RasterPool::attach(const uint16_t slice) {
+    if (slice == RASTER_SLICE_NONE) return;
+    const bool isr_enabled = STEPPER_ISR_ENABLED();
+    if (isr_enabled) DISABLE_STEPPER_INTERRUPT();
+    header(slice).refs++;
+    if (isr_enabled) ENABLE_STEPPER_INTERRUPT();
+  }
+
+  void RasterPool::release(const uint16_t slice) {
+    if (slice == RASTER_SLICE_NONE) return;
+    const bool isr_enabled = STEPPER_ISR_ENABLED();
+    if (isr_enabled) DISABLE_STEPPER_INTERRUPT();
+    raster_slice_t &h = header(slice);
+    if (h.refs && !--h.refs) free_released();
+    if (isr_enabled) ENABLE_STEPPER_INTERRUPT();
+  }
+
+  /**
+   * Find size contiguous bytes after the head, or at the start of the pool
+   * leaving a wrap marker at the head. The head never reaches the tail,
+   * head == tail means the pool is empty.
+   */
+  uint16_t RasterPool::try_alloc(const uint16_t size) {
+
+    const uint16_t h = head, t = tail;
+
+    // Empty pool, restart from the start for the largest room
+    if (h == t) {
+      clear();
+      return size < (LASER_RASTER_POOL_SIZE) ? 0 : RASTER_SLICE_NONE;
+    }
+
+    if (h >= t) {
+      const uint16_t end = h + size;
+      if (end < (LASER_RASTER_POOL_SIZE) || (end == (LASER_RASTER_POOL_SIZE) && t)) return h;
+      if (size < t) {
+        raster_slice_t &marker = header(h);
+        marker.length = 0;
+        marker.refs   = 0;
+        marker.wrap   = true;
+        return 0;
+      }
+    }
+    else if (h + size < t)
+      return h;
+
+    return RASTER_SLICE_NONE;
+  }
+
+  // Move the tail over the slices nobody uses any more
+  void RasterPool::free_released() {
+    uint16_t t = tail;
+    while (t != head) {
+      const raster_slice_t &h = header(t);
+      if (h.wrap)
+        t = 0;
+      else if (h.refs)
+        break;
+      else
+        t = (t + slice_size(h.length)) % (LASER_RASTER_POOL_SIZE);
+    }
+    tail = t;
+  }
+
+#endif // LASER && LASER_RASTER
@@ -0,0 +1,108 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * raster_pool.h
+ *
+ * Decoded G7 raster lines, shared by the planner blocks that fire them.
+ *
+ * A slice is a 4 byte header (pixel count, references) followed by the
+ * pixels. Slices are allocated in a ring in G7 order and freed from the
+ * oldest one when no block and no G7 use them any more, so travel moves
+ * don't carry any pixel and a raster line split in many blocks is stored
+ * only once.
+ */
+
+#if ENABLED(LASER) && ENABLED(LASER_RASTER)
+
+  #define RASTER_SLICE_NONE 0xFFFF
+
+  // Longest line in a slice: the whole pool but the header and the gap that keeps the head off the tail
+  #define RASTER_SLICE_MAX_LENGTH ((LASER_RASTER_POOL_SIZE) - 8)
+
+  typedef struct {
+    uint16_t  length;   // Pixels in the slice
+    uint8_t   refs,     // G7 and planner blocks using the slice
+              wrap;     // Marker: the next slice is at the start of the pool
+  } raster_slice_t;
+
+  class RasterPool {
+
+    public: /** Constructor */
+
+      RasterPool() {}
+
+    private: /** Private Parameters */
+
+      static uint32_t pool[(LASER_RASTER_POOL_SIZE) / 4];   // 32 bit for the alignment of the headers
+
+      static volatile uint16_t  head,   // Next free byte, written by the main thread
+                                tail;   // Oldest slice in use, written by the Stepper ISR
+
+    public: /** Public Function */
+
+      static void clear();
+
+      /**
+       * Allocate a slice for length pixels with one reference,
+       * waiting for the blocks to free enough room.
+       */
+      static uint16_t alloc(const uint16_t length);
+
+      // Give back the unused pixels of the last allocated slice
+      static void shrink(const uint16_t slice, const uint16_t length);
+
+      // Add a reference, main thread only
+      static void attach(const uint16_t slice);
+
+      // Drop a reference and free the released slices, from the main thread or the Stepper ISR
+      static void release(const uint16_t slice);
+
+      FORCE_INLINE static uint8_t* pixels(const uint16_t slice) {
+        return (uint8_t*)pool + slice + sizeof(raster_slice_t);
+      }
+
+      // Pixel of the slice, off (0) outside the line
+      FORCE_INLINE static uint8_t pixel(const uint16_t slice, const uint16_t index) {
+        if (slice == RASTER_SLICE_NONE || index >= header(slice).length) return 0;
+        return pixels(slice)[index];
+      }
+
+    private: /** Private Function */
+
+      FORCE_INLINE static raster_slice_t& header(const uint16_t slice) {
+        return *(raster_slice_t*)((uint8_t*)pool + slice);
+      }
+
+      FORCE_INLINE static uint16_t slice_size(const uint16_t length) {
+        return sizeof(raster_slice_t) + ((length + 3) & ~3);
+      }
+
+      static uint16_t try_alloc(const uint16_t size);
+      static void free_released();
+
+  };
+
+  extern RasterPool raster_pool;
+
+#endif // LASER && LASER_RASTER
@@ -51,6 +51,19 @@
       #endif
     #endif
   #endif
+  #if ENABLED(LASER_RASTER)
+    #ifndef LASER_RASTER_POOL_SIZE
+      #error "DEPENDENCY ERROR: Missing setting LASER_RASTER_POOL_SIZE."
+    #elif (LASER_RASTER_POOL_SIZE) % 4 != 0
+      #error "DEPENDENCY ERROR: LASER_RASTER_POOL_SIZE must be a multiple of 4."
+    #elif LASER_RASTER_POOL_SIZE > 32768
+      #error "DEPENDENCY ERROR: LASER_RASTER_POOL_SIZE must be 32768 or less."
+    #elif LASER_RASTER_POOL_SIZE < 2 * ((LASER_MAX_RASTER_LINE) * 3 / 4 + 8)
+      #error "DEPENDENCY ERROR: LASER_RASTER_POOL_SIZE must hold at least two decoded raster lines."
+    #elif LASER_MAX_RASTER_LINE > (MAX_CMD_SIZE) - 4
+      #error "DEPENDENCY ERROR: LASER_MAX_RASTER_LINE must fit in a command. Raise MAX_CMD_SIZE."
+    #endif
+  #endif
 #endif
 
 #endif /* _LASER_SANITYCHECK_H_ */
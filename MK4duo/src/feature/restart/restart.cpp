@@ -33,6 +33,17 @@ restart_job_t Restart::job_info;
 
 bool Restart::enabled;
 
+/** Private Parameters */
+uint16_t  Restart::gen        = 0,
+          Restart::seq        = 0,
+          Restart::state_crc  = 0;
+
+#define RESTART_JOURNAL_START RESTART_SLOT_SIZE * 2
+#define RESTART_FILE_SIZE     (RESTART_JOURNAL_START + RESTART_JOURNAL_RECORDS * sizeof(restart_record_t))
+
+static_assert(sizeof(restart_checkpoint_t) <= RESTART_SLOT_SIZE, "restart_job_t does not fit in RESTART_SLOT_SIZE.");
+static_assert(sizeof(restart_record_t) == 32, "restart_record_t must be 32 bytes.");
+
 /** Public Function */
 void Restart::init_job() { memset(&job_info, 0, sizeof(job_info)); }
 
@@ -60,38 +71,92 @@ void Restart::check() {
 }
 
 void Restart::purge_job() {
+  close();
   init_job();
   card.delete_restart_file();
 }
 
+/**
+ * The newest checkpoint with a good CRC, then the records
+ * that follow it in order, up to the first one that is not whole.
+ */
 void Restart::load_job() {
-  #if ENABLED(DEBUG_RESTART)
-    debug_info(PSTR("Load"));
-  #endif
+  init_job();
   if (exists()) {
     open(true);
-    (void)job_file.read(&job_info, sizeof(job_info));
+
+    uint16_t slot_gen[2] = { 0, 0 };
+    LOOP_L_N(s, 2)
+      if (!job_file.seekSet(s * RESTART_SLOT_SIZE) || job_file.read(&slot_gen[s], sizeof(slot_gen[s])) != int(sizeof(slot_gen[s])))
+        slot_gen[s] = s ^ 1;  // Never good, the generation of slot 0 is even
+    const uint8_t newer = int16_t(slot_gen[1] - slot_gen[0]) > 0 ? 1 : 0;
+
+    bool found = false;
+    LOOP_L_N(i, 2) {
+      const uint8_t s = newer ^ i;
+      const uint32_t slot = s * RESTART_SLOT_SIZE;
+      uint16_t crc = 0xFFFF, file_crc = 0;
+      crc16(&crc, &slot_gen[s], sizeof(slot_gen[s]));
+      if ((slot_gen[s] & 1) == s
+        && job_file.seekSet(slot + offsetof(restart_checkpoint_t, job))
+        && job_file.read(&job_info, sizeof(job_info)) == int(sizeof(job_info))
+        && job_file.seekSet(slot + offsetof(restart_checkpoint_t, crc))
+        && job_file.read(&file_crc, sizeof(file_crc)) == int(sizeof(file_crc))
+      ) {
+        crc16(&crc, &job_info, sizeof(job_info));
+        if (crc == file_crc) {
+          gen = slot_gen[s];
+          found = true;
+          break;
+        }
+      }
+    }
+
+    if (found) {
+      restart_record_t record;
+      job_file.seekSet(RESTART_JOURNAL_START);
+      for (seq = 0; seq < RESTART_JOURNAL_RECORDS; seq++) {
+        if (job_file.read(&record, sizeof(record)) != int(sizeof(record))) break;
+        uint16_t crc = 0xFFFF;
+        crc16(&crc, &record, offsetof(restart_record_t, crc));
+        if (crc != record.crc || record.gen != gen || record.seq != seq) break;
+        job_info.sdpos = record.sdpos;
+        COPY_ARRAY(job_info.current_position, record.current_position);
+        job_info.feedrate = record.feedrate;
+        job_info.print_job_counter_elapsed = record.print_job_counter_elapsed;
+      }
+      state_crc = state_checksum();
+    }
+    else
+      init_job();
+
     close();
   }
+  #if ENABLED(DEBUG_RESTART)
+    debug_info(PSTR("Load"));
+  #endif
 }
 
 void Restart::save_job(const bool force_save/*=false*/, const bool save_count/*=true*/) {
 
   static watch_t save_restart_watch((SD_RESTART_FILE_SAVE_TIME) * 1000UL);
 
-  if (save_restart_watch.elapsed() || force_save ||
+  #if SD_RESTART_FILE_SAVE_MOVES > 0
+    static uint16_t moves = 0;
+    const bool moves_save = ++moves >= SD_RESTART_FILE_SAVE_MOVES;
+  #else
+    constexpr bool moves_save = false;
+  #endif
+
+  if (save_restart_watch.elapsed() || force_save || moves_save ||
       // Save on every new Z height
       (mechanics.current_position[Z_AXIS] > job_info.current_position[Z_AXIS])
   ) {
 
     save_restart_watch.start();
-
-    if (!++job_info.valid_head) ++job_info.valid_head; // non-zero in sequence
-    job_info.valid_foot = job_info.valid_head;
-
-    // Mechanics state
-    COPY_ARRAY(job_info.current_position, mechanics.current_position);
-    job_info.feedrate = uint16_t(MMS_TO_MMM(mechanics.feedrate_mm_s));
+    #if SD_RESTART_FILE_SAVE_MOVES > 0
+      moves = 0;
+    #endif
 
     #if HOTENDS > 0
       LOOP_HOTEND()
@@ -131,33 +196,70 @@ void Restart::save_job(const bool force_save/*=false*/, const bool save_count/*=
       memcpy(&job_info.gradient, &mixer.gradient, sizeof(job_info.gradient));
     #endif
 
-    // Commands in the queue
-    job_info.buffer_head = commands.buffer_ring.head();
-    job_info.buffer_count = save_count ? commands.buffer_ring.count() : 0;
-    for (uint8_t index = 0; index < BUFSIZE; index++) {
-      gcode_t temp_cmd;
-      temp_cmd = commands.buffer_ring.peek(index);
-      strncpy(job_info.buffer_ring[index], temp_cmd.gcode, sizeof(job_info.buffer_ring[index]) - 1);
+    // SD file
+    if (!job_info.just_restart) {
+      card.getAbsFilename(job_info.fileName);
+      job_info.just_restart = true;
     }
 
+    // Mechanics state
+    COPY_ARRAY(job_info.current_position, mechanics.current_position);
+    job_info.feedrate = uint16_t(MMS_TO_MMM(mechanics.feedrate_mm_s));
+
     // Elapsed print job time
     job_info.print_job_counter_elapsed = print_job_counter.duration() * 1000UL;
 
-    // SD file e position
-    if (!job_info.just_restart) {
-      card.getAbsFilename(job_info.fileName);
-      job_info.just_restart = true;
-    }
+    // The first SD command in the queue, or the file position when the queue is not saved.
+    // Host, LCD and injected commands in the queue are kept to run again, up to the first one that doesn't fit.
     job_info.sdpos = card.getIndex();
+    char *queued = job_info.queued_commands;
+    const char * const queued_end = queued + sizeof(job_info.queued_commands) - 1;
+    if (save_count) {
+      bool sd_found = false, queued_full = false;
+      for (uint8_t h = commands.buffer_ring.head(), c = commands.buffer_ring.count(); c--; h = (h + 1) % BUFSIZE) {
+        const gcode_t &cmd = commands.buffer_ring.peek_ref(h);
+        if (cmd.s_port == -2 && cmd.sdpos != SDPOS_NONE) {
+          if (!sd_found) job_info.sdpos = cmd.sdpos;
+          sd_found = true;
+        }
+        else if (!queued_full) {
+          const size_t len = strlen(cmd.gcode) + 1;
+          if (queued + len <= queued_end) {
+            memcpy(queued, cmd.gcode, len);
+            queued += len;
+          }
+          else
+            queued_full = true;
+        }
+      }
+    }
+    // Zero to the end, the checkpoint is written only when the state changes
+    memset(queued, 0, queued_end + 1 - queued);
 
-    write_job();
+    write_job(force_save);
   }
 }
 
-void Restart::resume_job() {
+void Restart::resume_job(const bool layer_start/*=false*/) {
 
   char cmd[40], str1[16];
 
+  #if ENABLED(SD_JOB_INDEX)
+    // Print the layer again from the move to its height, with the E position there
+    if (layer_start) {
+      char *fn = job_info.fileName;
+      while (*fn == '/') fn++;
+      job_layer_t layer;
+      if (card.selectFile(fn, true) && job_index.find_layer(job_info.sdpos, layer)) {
+        job_info.sdpos = layer.pos;
+        job_info.current_position[E_AXIS] = layer.e;
+        job_info.feedrate = uint16_t(layer.feedrate);
+      }
+    }
+  #else
+    UNUSED(layer_start);
+  #endif
+
   #if HAS_LEVELING
     // Make sure leveling is off before any G92 and G28
     commands.process_now_P(PSTR("M420 S0 Z0"));
@@ -249,9 +351,12 @@ void Restart::resume_job() {
   sprintf_P(cmd, PSTR("G1 F%d"), job_info.feedrate);
   commands.process_now(cmd);
 
-  uint8_t h = job_info.buffer_head, c = job_info.buffer_count;
-  for (; c--; h = (h + 1) % BUFSIZE)
-    commands.process_now(job_info.buffer_ring[h]);
+  // Commands that were queued by the host, the LCD or injected
+  for (char *queued = job_info.queued_commands; *queued;) {
+    const size_t len = strlen(queued) + 1;  // The parser may cut the line
+    commands.process_now(queued);
+    queued += len;
+  }
 
   // Resume the SD file from the last position
   char *fn = job_info.fileName;
@@ -264,20 +369,87 @@ void Restart::resume_job() {
 }
 
 /** Private Function */
-void Restart::write_job() {
+
+/**
+ * A record for the position, a checkpoint when the rest of the state changed,
+ * the journal is full or it is forced. The file is made whole at first, so a
+ * save only writes its block and not the directory entry.
+ */
+void Restart::write_job(const bool force_checkpoint) {
   bool failed = false;
   #if ENABLED(DEBUG_RESTART)
     debug_info(PSTR("Write"));
   #endif
   open(false);
-  if (!job_file.seekSet(0)) failed = true;
-  if (!failed && !job_file.write(&job_info, sizeof(job_info)) == sizeof(job_info))
-    failed = true;
+  if (job_file.fileSize() < RESTART_FILE_SIZE) {
+    const uint8_t empty[32] = { 0 };
+    if (!job_file.seekEnd()) failed = true;
+    while (!failed && job_file.fileSize() < RESTART_FILE_SIZE)
+      if (job_file.write(empty, sizeof(empty)) != int(sizeof(empty))) failed = true;
+  }
+  if (!failed) {
+    if (force_checkpoint || seq >= RESTART_JOURNAL_RECORDS || state_checksum() != state_crc)
+      failed = !write_checkpoint();
+    else
+      failed = !write_record();
+  }
+  if (!failed) failed = !job_file.sync();
   #if ENABLED(DEBUG_RESTART)
     if (failed) SERIAL_EM("Restart job_file write failed.");
   #endif
 }
 
+// The other slot, so a checkpoint torn by a power cut leaves the last one
+bool Restart::write_checkpoint() {
+  if (!++job_info.valid_head) ++job_info.valid_head; // non-zero in sequence
+  job_info.valid_foot = job_info.valid_head;
+
+  const uint16_t next_gen = gen + 1;
+  const uint32_t slot = (next_gen & 1) * RESTART_SLOT_SIZE;
+  uint16_t crc = 0xFFFF;
+  crc16(&crc, &next_gen, sizeof(next_gen));
+  crc16(&crc, &job_info, sizeof(job_info));
+
+  if (!job_file.seekSet(slot + offsetof(restart_checkpoint_t, gen))
+    || job_file.write(&next_gen, sizeof(next_gen)) != int(sizeof(next_gen))
+    || !job_file.seekSet(slot + offsetof(restart_checkpoint_t, job))
+    || job_file.write(&job_info, sizeof(job_info)) != int(sizeof(job_info))
+    || !job_file.seekSet(slot + offsetof(restart_checkpoint_t, crc))
+    || job_file.write(&crc, sizeof(crc)) != int(sizeof(crc))
+  ) return false;
+
+  gen = next_gen;
+  seq = 0;
+  state_crc = state_checksum();
+  return true;
+}
+
+bool Restart::write_record() {
+  restart_record_t record;
+  record.gen = gen;
+  record.seq = seq;
+  record.sdpos = job_info.sdpos;
+  COPY_ARRAY(record.current_position, job_info.current_position);
+  record.print_job_counter_elapsed = job_info.print_job_counter_elapsed;
+  record.feedrate = job_info.feedrate;
+  record.crc = 0xFFFF;
+  crc16(&record.crc, &record, offsetof(restart_record_t, crc));
+
+  if (!job_file.seekSet(RESTART_JOURNAL_START + seq * sizeof(record))
+    || job_file.write(&record, sizeof(record)) != int(sizeof(record))
+  ) return false;
+
+  seq++;
+  return true;
+}
+
+// The state that only a checkpoint saves, from the file name to the journal fields
+uint16_t Restart::state_checksum() {
+  uint16_t crc = 0xFFFF;
+  crc16(&crc, job_info.fileName, offsetof(restart_job_t, sdpos) - offsetof(restart_job_t, fileName));
+  return crc;
+}
+
 #if ENABLED(DEBUG_RESTART)
 
   void Restart::debug_info(PGM_P const prefix) {
@@ -299,11 +471,12 @@ void Restart::write_job() {
           SERIAL_EMV("leveling: ", int(job_info.leveling));
           SERIAL_EMV(" z_fade_height: ", int(job_info.z_fade_height));
         #endif
-        SERIAL_EMV("buffer_head: ", job_info.buffer_head);
-        SERIAL_EMV("buffer_count: ", job_info.buffer_count);
-        for (uint8_t i = 0; i < job_info.buffer_count; i++) SERIAL_EMT("> ", job_info.buffer_ring[i]);
+        SERIAL_MV("checkpoint: ", gen);
+        SERIAL_EMV(" records: ", seq);
         SERIAL_EMT("Filename: ", job_info.fileName);
         SERIAL_EMV("sdpos: ", job_info.sdpos);
+        for (const char *queued = job_info.queued_commands; *queued; queued += strlen(queued) + 1)
+          SERIAL_EMT("> ", queued);
         SERIAL_EMV("print_job_counter_elapsed: ", job_info.print_job_counter_elapsed);
       }
       else
@@ -23,22 +23,33 @@
 
 /**
  * restart.h - Restart an SD print after power-loss
+ *
+ * The restart file is a journal: two checkpoint slots with the whole job
+ * state, used in turn, and after them a ring of small records with only
+ * what changes while printing (file position, position and feedrate, job
+ * time). A save writes a record, a checkpoint is written when the rest of
+ * the state changes or the ring is full. Checkpoints and records have a
+ * CRC and the generation of the checkpoint, so after a power cut the last
+ * record written whole is found, and a torn write only loses that save.
+ *
+ * The print goes on from the first SD command still queued. Commands queued
+ * by the host, the LCD or injected (e.g. M104 or M600) and not yet run are
+ * kept in the checkpoint and run again first, as many as fit.
  */
 
 #if HAS_SD_RESTART
 
 //#define DEBUG_RESTART
 
+#define RESTART_SLOT_SIZE       512   // Bytes of a checkpoint slot, a block of the card
+#define RESTART_JOURNAL_RECORDS 64    // Records after a checkpoint, 16 for each block
+#define RESTART_QUEUED_SIZE     96    // Bytes for the queued commands not from the SD
+
 typedef struct {
   uint8_t valid_head;
 
-  // SD file e position
+  // SD file
   char fileName[MAX_PATH_NAME_LENGHT];
-  uint32_t sdpos;
-
-  // Mechanics state
-  float     current_position[XYZE];
-  uint16_t  feedrate;
 
   #if HOTENDS > 0
     int16_t target_temperature[HOTENDS];
@@ -70,21 +81,42 @@ typedef struct {
     gradient_t gradient;
   #endif
 
-  // Command buffer
-  uint8_t buffer_head,
-          buffer_count;
-  char    buffer_ring[BUFSIZE][MAX_CMD_SIZE];
-
-  // Job elapsed time
-  millis_t print_job_counter_elapsed;
+  // Queued commands not from the SD, one after the other
+  // with their '\0', an empty one is the end
+  char queued_commands[RESTART_QUEUED_SIZE];
 
   // Utility
   bool just_restart;
 
+  // What the journal records update, the file position is
+  // the one of the first SD command not done, it runs again
+  uint32_t  sdpos;
+  float     current_position[XYZE];
+  uint16_t  feedrate;
+  millis_t  print_job_counter_elapsed;
+
   uint8_t valid_foot;
 
 } restart_job_t;
 
+// Checkpoint slot
+typedef struct {
+  uint16_t      gen;          // Generation, odd in slot 1 and even in slot 0
+  restart_job_t job;
+  uint16_t      crc;
+} restart_checkpoint_t;
+
+// Journal record
+typedef struct {
+  uint16_t  gen,              // Checkpoint it follows
+            seq;              // Place in the ring
+  uint32_t  sdpos;
+  float     current_position[XYZE];
+  millis_t  print_job_counter_elapsed;
+  uint16_t  feedrate,
+            crc;
+} restart_record_t;
+
 class Restart {
 
   public: /** Constructor */
@@ -99,6 +131,12 @@ class Restart {
 
     static bool enabled;
 
+  private: /** Private Parameters */
+
+    static uint16_t gen,              // Generation of the last checkpoint
+                    seq,              // Next record of the journal
+                    state_crc;        // CRC of the state in the last checkpoint
+
   public: /** Public Function */
 
     static void init_job();
@@ -115,13 +153,16 @@ class Restart {
     static void purge_job();
     static void load_job();
     static void save_job(const bool force_save=false, const bool save_count=true);
-    static void resume_job();
+    static void resume_job(const bool layer_start=false);
 
     static inline bool valid() { return job_info.valid_head && job_info.valid_head == job_info.valid_foot; }
 
   private: /** Private Function */
 
-    static void write_job();
+    static void write_job(const bool force_checkpoint);
+    static bool write_checkpoint();
+    static bool write_record();
+    static uint16_t state_checksum();
 
     #if ENABLED(DEBUG_RESTART)
       static void debug_info(PGM_P const prefix);
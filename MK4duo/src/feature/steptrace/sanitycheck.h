@@ -0,0 +1,45 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * sanitycheck.h
+ *
+ * Test configuration values for errors at compile-time.
+ */
+
+#ifndef _STEPTRACE_SANITYCHECK_H_
+#define _STEPTRACE_SANITYCHECK_H_
+
+#if ENABLED(STEP_TRACE)
+  #if DISABLED(STEP_TRACE_BUFFER_SIZE)
+    #error "DEPENDENCY ERROR: Missing setting STEP_TRACE_BUFFER_SIZE."
+  #elif !IS_POWER_OF_2(STEP_TRACE_BUFFER_SIZE)
+    #error "DEPENDENCY ERROR: STEP_TRACE_BUFFER_SIZE must be a power of 2."
+  #elif ENABLED(__AVR__) && STEP_TRACE_BUFFER_SIZE > 256
+    #error "DEPENDENCY ERROR: STEP_TRACE_BUFFER_SIZE must be 256 or less on AVR."
+  #endif
+  #if HAS_SD_SUPPORT && DISABLED(STEP_TRACE_FILE)
+    #error "DEPENDENCY ERROR: Missing setting STEP_TRACE_FILE."
+  #endif
+#endif
+
+#endif /* _STEPTRACE_SANITYCHECK_H_ */
@@ -0,0 +1,156 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * steptrace.cpp - Step event trace recorder
+ *
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(STEP_TRACE)
+
+StepTrace steptrace;
+
+// Public Parameters
+volatile bool StepTrace::active   = false;
+uint32_t      StepTrace::recorded = 0,
+              StepTrace::dropped  = 0;
+
+// Private Parameters
+steptrace_event_t           StepTrace::buffer[STEP_TRACE_BUFFER_SIZE];
+volatile steptrace_index_t  StepTrace::head           = 0,
+                            StepTrace::tail           = 0;
+uint16_t                    StepTrace::max_used       = 0;
+uint32_t                    StepTrace::time_base      = 0;
+uint8_t                     StepTrace::pending_flags  = 0;
+bool                        StepTrace::to_file        = false;
+
+#if HAS_SD_SUPPORT
+  SdFile StepTrace::trace_file;
+#endif
+
+/** Public Function */
+void StepTrace::start() {
+
+  if (active) return;
+
+  head = tail = 0;
+  recorded = dropped = 0;
+  max_used = 0;
+  pending_flags = 0;
+
+  to_file = false;
+  #if HAS_SD_SUPPORT
+    if (card.isDetected()) {
+      if (trace_file.open(card.fat.vwd(), STEP_TRACE_FILE, O_CREAT | O_WRITE | O_TRUNC))
+        to_file = true;
+      else
+        SERIAL_LMT(ER, MSG_SD_OPEN_FILE_FAIL, STEP_TRACE_FILE);
+    }
+  #endif
+
+  steptrace_header_t header;
+  header.magic      = STEP_TRACE_MAGIC;
+  header.version    = STEP_TRACE_VERSION;
+  header.axes       = XYZE;
+  header.event_size = sizeof(steptrace_event_t);
+  header.timer_rate = STEPPER_TIMER_RATE;
+  LOOP_XYZ(axis) header.steps_per_mm[axis] = mechanics.data.axis_steps_per_mm[axis];
+  header.steps_per_mm[E_AXIS] = mechanics.data.axis_steps_per_mm[E_AXIS + tools.active_extruder];
+  write(&header, sizeof(header));
+
+  active = true;
+
+  SERIAL_EM("Step trace started");
+}
+
+void StepTrace::stop() {
+
+  if (!active) return;
+
+  active = false;
+
+  // Drain what is left in the buffer
+  while (head != tail) spin();
+
+  #if HAS_SD_SUPPORT
+    if (to_file) trace_file.close();
+  #endif
+  to_file = false;
+
+  report();
+}
+
+void StepTrace::report() {
+  SERIAL_SM(ECHO, "Step trace:");
+  SERIAL_STR(active ? PSTR(" ON") : PSTR(" OFF"));
+  SERIAL_MV(" Recorded:", recorded);
+  SERIAL_MV(" Dropped:", dropped);
+  SERIAL_MV(" Max used:", max_used);
+  SERIAL_EMV("/", STEP_TRACE_BUFFER_SIZE);
+}
+
+void StepTrace::spin() {
+
+  const uint16_t count = used();
+  if (!count) return;
+
+  NOLESS(max_used, count);
+
+  // Write only the contiguous part, the rest on the next call
+  const steptrace_index_t t = tail;
+  uint16_t todo = MIN(count, STEP_TRACE_BUFFER_SIZE - t);
+  if (!to_file) NOMORE(todo, 8);
+
+  write(&buffer[t], todo * sizeof(steptrace_event_t));
+
+  tail = (t + todo) & (STEP_TRACE_BUFFER_SIZE - 1);
+  recorded += todo;
+}
+
+/** Private Function */
+uint16_t StepTrace::used() {
+  return (uint16_t)(STEP_TRACE_BUFFER_SIZE + head - tail) & (STEP_TRACE_BUFFER_SIZE - 1);
+}
+
+void StepTrace::write(const void * const data, const uint16_t size) {
+
+  #if HAS_SD_SUPPORT
+    if (to_file) {
+      trace_file.write(data, size);
+      return;
+    }
+  #endif
+
+  // One line for each event, the header is sent the same way
+  const uint8_t *bytes = (const uint8_t*)data;
+  for (uint16_t i = 0; i < size; i += sizeof(steptrace_event_t)) {
+    SERIAL_MSG("TRACE:");
+    for (uint16_t j = i; j < size && j < i + sizeof(steptrace_event_t); j++)
+      print_hex_byte(bytes[j]);
+    SERIAL_EOL();
+  }
+}
+
+#endif // STEP_TRACE
@@ -0,0 +1,142 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * steptrace.h - Step event trace recorder
+ *
+ * Every step pulse generated by the Stepper ISR is stored in a ring buffer
+ * with its time in stepper timer ticks, the stepped axes, the direction bits
+ * and the planner block index. The ring is drained from idle() to the file
+ * STEP_TRACE_FILE on the SD card, or to the serial as "TRACE:" hex lines.
+ *
+ * Use scripts/steptrace.py to replay a trace on the host.
+ *
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ */
+
+#if ENABLED(STEP_TRACE)
+
+#define STEP_TRACE_MAGIC    0x54534B4DUL  // "MKST"
+#define STEP_TRACE_VERSION  1
+
+// Event flags
+enum StepTraceFlagEnum : uint8_t {
+  STEP_TRACE_NEW_BLOCK  = 0x01, // First event of a block
+  STEP_TRACE_ADVANCE    = 0x02, // Linear Advance E step
+  STEP_TRACE_OVERFLOW   = 0x04  // Events were lost before this one
+};
+
+#if STEP_TRACE_BUFFER_SIZE > 256
+  typedef uint16_t steptrace_index_t;
+#else
+  typedef uint8_t steptrace_index_t;
+#endif
+
+typedef struct {
+  uint32_t  ticks;          // Stepper timer ticks, wraps at 32 bit
+  uint8_t   step_bits,      // Stepped axes, bit X_AXIS...E_AXIS
+            dir_bits,       // Direction bits, set for negative direction
+            block_index,    // Planner block buffer index
+            flags;          // StepTraceFlagEnum
+} steptrace_event_t;
+
+typedef struct {
+  uint32_t  magic;
+  uint8_t   version,
+            axes;
+  uint16_t  event_size;
+  uint32_t  timer_rate;     // Stepper timer ticks per second
+  float     steps_per_mm[XYZE];
+} steptrace_header_t;
+
+class StepTrace {
+
+  public: /** Constructor */
+
+    StepTrace() {}
+
+  public: /** Public Parameters */
+
+    static volatile bool  active;
+    static uint32_t       recorded,
+                          dropped;
+
+  private: /** Private Parameters */
+
+    static steptrace_event_t          buffer[STEP_TRACE_BUFFER_SIZE];
+    static volatile steptrace_index_t head,
+                                      tail;
+    static uint16_t                   max_used;
+    static uint32_t                   time_base;
+    static uint8_t                    pending_flags;
+    static bool                       to_file;
+
+    #if HAS_SD_SUPPORT
+      static SdFile trace_file;
+    #endif
+
+  public: /** Public Function */
+
+    static void start();
+    static void stop();
+    static void report();
+
+    // Drain the ring buffer, called from idle()
+    static void spin();
+
+    // Called by the Stepper ISR after the next period is programmed
+    FORCE_INLINE static void add_ticks(const uint32_t ticks) { time_base += ticks; }
+
+    // Called by the Stepper ISR when a new block is started
+    FORCE_INLINE static void block_start() { pending_flags |= STEP_TRACE_NEW_BLOCK; }
+
+    // Called by the Stepper ISR for each pulse
+    FORCE_INLINE static void record(const uint8_t step_bits, const uint8_t dir_bits, const uint8_t flags=0) {
+      if (!active || !step_bits) return;
+      const steptrace_index_t h = head,
+                              next = (h + 1) & (STEP_TRACE_BUFFER_SIZE - 1);
+      if (next == tail) {
+        dropped++;
+        pending_flags |= STEP_TRACE_OVERFLOW;
+        return;
+      }
+      steptrace_event_t &event = buffer[h];
+      event.ticks       = time_base + HAL_timer_get_current_count(STEPPER_TIMER);
+      event.step_bits   = step_bits;
+      event.dir_bits    = dir_bits;
+      event.block_index = planner.block_buffer_tail;
+      event.flags       = flags | pending_flags;
+      pending_flags     = 0;
+      head = next;
+    }
+
+  private: /** Private Function */
+
+    static uint16_t used();
+    static void write(const void * const data, const uint16_t size);
+
+};
+
+extern StepTrace steptrace;
+
+#endif // STEP_TRACE
@@ -44,6 +44,21 @@
   #endif
 #endif
 
+/**
+ * Linux native build
+ */
+#if ENABLED(__PLAT_LINUX__)
+  #if ENABLED(M100_FREE_MEMORY_WATCHER)
+    #undef M100_FREE_MEMORY_WATCHER
+  #endif
+  #if DISABLED(EXTENDED_CAPABILITIES_REPORT)
+    #define EXTENDED_CAPABILITIES_REPORT
+  #endif
+  #if DISABLED(DEBUG_FEATURE)
+    #define DEBUG_FEATURE
+  #endif
+#endif
+
 /**
  * Stored Position
  */
@@ -650,6 +665,12 @@
 #if ENABLED(SDCARD_SORT_ALPHA)
   #define HAS_FOLDER_SORTING  (FOLDER_SORTING || ENABLED(SDSORT_GCODE))
 #endif
+#if ENABLED(SDCARD_SORT_ALPHA) && ENABLED(SDSORT_INDEX)
+  #undef SDSORT_USES_RAM
+  #undef SDSORT_USES_STACK
+  #undef SDSORT_CACHE_NAMES
+  #undef SDSORT_DYNAMIC_RAM
+#endif
 #define HAS_SD_RESTART        (HAS_SD_SUPPORT && ENABLED(SD_RESTART_FILE))
 
 // Other
@@ -1369,6 +1390,17 @@
   #define MAX_CONSECUTIVE_LOW_TEMP 2
 #endif
 
+// Planner buffer size, if not supplied, as large as the RAM of the processor allows
+#if DISABLED(BLOCK_BUFFER_SIZE)
+  #if ENABLED(__AVR__)
+    #define BLOCK_BUFFER_SIZE 16
+  #elif ENABLED(ARDUINO_ARCH_SAMD)
+    #define BLOCK_BUFFER_SIZE 128
+  #else
+    #define BLOCK_BUFFER_SIZE 64
+  #endif
+#endif
+
 // Calculate a default maximum stepper rate, if not supplied
 #if DISABLED(MAXIMUM_STEPPER_RATE)
   #define MAXIMUM_STEPPER_RATE (500000UL)
@@ -114,6 +114,7 @@
 #include "../feature/probe/sanitycheck.h"
 #include "../feature/restart/sanitycheck.h"
 #include "../feature/rgbled/sanitycheck.h"
+#include "../feature/steptrace/sanitycheck.h"
 #include "../feature/tmc/sanitycheck.h"
 
 // CONTROLLI ANCORA DA RICOLLOCARE...
@@ -142,6 +143,21 @@
 // Buffer
 #if !BLOCK_BUFFER_SIZE || !IS_POWER_OF_2(BLOCK_BUFFER_SIZE)
   #error "DEPENDENCY ERROR: BLOCK_BUFFER_SIZE must be a power of 2."
+#elif BLOCK_BUFFER_SIZE > 128
+  #error "DEPENDENCY ERROR: BLOCK_BUFFER_SIZE must be 128 or less, the planner indexes are 8 bit."
+#elif ENABLED(__AVR__) && BLOCK_BUFFER_SIZE > 32
+  #error "DEPENDENCY ERROR: BLOCK_BUFFER_SIZE must be 32 or less on AVR."
+#endif
+#if ENABLED(SEGMENT_MERGING)
+  #if IS_KINEMATIC
+    #error "DEPENDENCY ERROR: SEGMENT_MERGING is not compatible with Delta and Scara."
+  #elif DISABLED(SEGMENT_MERGE_LENGTH) || DISABLED(SEGMENT_MERGE_TOLERANCE) || DISABLED(SEGMENT_MERGE_E_RATIO) || DISABLED(SEGMENT_MERGE_MAX) || DISABLED(SEGMENT_MERGE_MIN_PLANNED)
+    #error "DEPENDENCY ERROR: Missing setting SEGMENT_MERGE_LENGTH, SEGMENT_MERGE_TOLERANCE, SEGMENT_MERGE_E_RATIO, SEGMENT_MERGE_MAX or SEGMENT_MERGE_MIN_PLANNED."
+  #elif SEGMENT_MERGE_MAX < 2 || SEGMENT_MERGE_MAX > 32
+    #error "DEPENDENCY ERROR: SEGMENT_MERGE_MAX must be between 2 and 32."
+  #elif SEGMENT_MERGE_MIN_PLANNED < 2 || SEGMENT_MERGE_MIN_PLANNED > BLOCK_BUFFER_SIZE / 2
+    #error "DEPENDENCY ERROR: SEGMENT_MERGE_MIN_PLANNED must be between 2 and BLOCK_BUFFER_SIZE / 2."
+  #endif
 #endif
 #if DISABLED(MAX_CMD_SIZE)
   #error "DEPENDENCY ERROR: Missing setting MAX_CMD_SIZE."
@@ -149,9 +165,33 @@
 #if DISABLED(BUFSIZE)
   #error "DEPENDENCY ERROR: Missing setting BUFSIZE."
 #endif
+#if ENABLED(PREPARSED_COMMANDS)
+  #if DISABLED(FASTER_GCODE_PARSER)
+    #error "DEPENDENCY ERROR: You must enable FASTER_GCODE_PARSER for PREPARSED_COMMANDS."
+  #elif DISABLED(PREPARSED_VALUES) || PREPARSED_VALUES < 1 || PREPARSED_VALUES > 26
+    #error "DEPENDENCY ERROR: PREPARSED_VALUES must be between 1 and 26."
+  #elif MAX_CMD_SIZE > 255
+    #error "DEPENDENCY ERROR: MAX_CMD_SIZE must be 255 or less for PREPARSED_COMMANDS."
+  #endif
+#endif
+#if ENABLED(BINARY_PROTOCOL) && MAX_CMD_SIZE < 80
+  #error "DEPENDENCY ERROR: MAX_CMD_SIZE must be 80 or more for BINARY_PROTOCOL."
+#endif
+#if ENABLED(SERIAL_WINDOW) && !WITHIN(SERIAL_WINDOW_LINES, 1, 16)
+  #error "DEPENDENCY ERROR: SERIAL_WINDOW_LINES must be between 1 and 16."
+#endif
 #if ENABLED(SERIAL_XON_XOFF) && RX_BUFFER_SIZE < 1024
   #error "DEPENDENCY ERROR: For SERIAL_XON_XOFF set RX_BUFFER_SIZE to 1024 or more."
 #endif
+#if ENABLED(SERIAL_RX_DMA)
+  #if DISABLED(ARDUINO_ARCH_SAM)
+    #error "DEPENDENCY ERROR: SERIAL_RX_DMA is only for Arduino DUE."
+  #elif ENABLED(SERIAL_XON_XOFF) || ENABLED(EMERGENCY_PARSER)
+    #error "DEPENDENCY ERROR: SERIAL_RX_DMA is not compatible with SERIAL_XON_XOFF or EMERGENCY_PARSER."
+  #elif RX_BUFFER_SIZE < 64
+    #error "DEPENDENCY ERROR: For SERIAL_RX_DMA set RX_BUFFER_SIZE to 64 or more."
+  #endif
+#endif
 #if DISABLED(SDSUPPORT) && ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
   #error "DEPENDENCY ERROR: You must enable SDSUPPORT for SERIAL_STATS_MAX_RX_QUEUED."
 #endif
@@ -55,24 +55,46 @@ class Circular_Queue {
       if (this->isEmpty()) return T();
 
       uint8_t index = this->buffer.head;
-
-      --this->buffer.count;
-      if (++this->buffer.head == this->buffer.size)
-        this->buffer.head = 0;
+      this->discard();
 
       return this->buffer.queue[index];
     }
 
     bool enqueue(T const &item) {
-      if (this->isFull()) return false;
+      T *slot = this->reserve();
+      if (!slot) return false;
 
-      this->buffer.queue[this->buffer.tail] = item;
+      *slot = item;
+      this->commit();
 
+      return true;
+    }
+
+    /**
+     * Zero-copy enqueue: reserve() returns the free slot at the tail,
+     * or NULL if the queue is full, the caller fills it in place and
+     * commit() adds it to the queue. Nothing else may enqueue in between.
+     */
+    T* reserve() {
+      return this->isFull() ? NULL : &this->buffer.queue[this->buffer.tail];
+    }
+
+    void commit() {
       ++this->buffer.count;
       if (++this->buffer.tail == this->buffer.size)
         this->buffer.tail = 0;
+    }
 
-      return true;
+    /**
+     * Zero-copy dequeue: remove the head item without returning it,
+     * use peek_ref() to read it in place first.
+     */
+    void discard() {
+      if (this->isEmpty()) return;
+
+      --this->buffer.count;
+      if (++this->buffer.head == this->buffer.size)
+        this->buffer.head = 0;
     }
 
     bool isEmpty() {
@@ -91,10 +113,18 @@ class Circular_Queue {
       return this->buffer.queue[this->buffer.head];
     }
 
+    T& peek_ref() {
+      return this->buffer.queue[this->buffer.head];
+    }
+
     T peek(const uint8_t index) {
       return this->buffer.queue[index];
     }
 
+    T& peek_ref(const uint8_t index) {
+      return this->buffer.queue[index];
+    }
+
     uint8_t count() {
       return this->buffer.count;
     }
@@ -60,6 +60,29 @@ template<int portNr>
 
 #define sw_barrier() asm volatile("": : :"memory");
 
+#if ENABLED(SERIAL_RX_DMA)
+
+template<int portNr>
+  void MKHardwareSerial<portNr>::rx_dma_arm(const uint16_t index) {
+
+    // The half at index is read, it comes after the one the PDC is in
+    _pUart->UART_RNPR = (uint32_t)&rx_buffer.buffer[index];
+    _pUart->UART_RNCR = RX_HALF;
+
+    // The PDC stopped at the end of the other half before: start it again
+    // here. Check again after clearing the next half, it could just have
+    // been taken.
+    if (!_pUart->UART_RCR && _pUart->UART_RNCR) {
+      _pUart->UART_RNCR = 0;
+      if (!_pUart->UART_RCR) {
+        _pUart->UART_RPR = (uint32_t)&rx_buffer.buffer[index];
+        _pUart->UART_RCR = RX_HALF;
+      }
+    }
+  }
+
+#else // !SERIAL_RX_DMA
+
 template<int portNr>
   void MKHardwareSerial<portNr>::store_rxd_char() {
 
@@ -202,6 +225,46 @@ template<int portNr>
     rx_buffer.head = h;
   }
 
+#endif // !SERIAL_RX_DMA
+
+template<int portNr>
+  void MKHardwareSerial<portNr>::rx_advance(const uint16_t t, const uint16_t count) {
+
+    const uint16_t n = (t + count) & (RX_BUFFER_SIZE - 1);
+
+    // Advance tail
+    rx_buffer.tail = n;
+
+    #if ENABLED(SERIAL_RX_DMA)
+
+      // A half read to the end goes back to the PDC
+      if (!(n & (RX_HALF - 1))) rx_dma_arm(t & ~(RX_HALF - 1));
+
+    #elif ENABLED(SERIAL_XON_XOFF)
+
+      // If the XOFF char was sent, or about to be sent...
+      if ((xon_xoff_state & XON_XOFF_CHAR_MASK) == XOFF_CHAR) {
+        // Get count of bytes in the RX buffer
+        const uint16_t rx_count = (rx_buffer.head - n) & (RX_BUFFER_SIZE - 1);
+        // When below 10% of RX buffer capacity, send XON before running out of RX buffer bytes
+        if (rx_count < (RX_BUFFER_SIZE) / 10) {
+          #if TX_BUFFER_SIZE > 0
+            // Signal we want an XON character to be sent.
+            xon_xoff_state = XON_CHAR;
+            // Enable TX isr.
+            _pUart->UART_IER = UART_IER_TXRDY;
+          #else
+            // If not using TX interrupts, we must send the XON char now
+            xon_xoff_state = XON_CHAR | XON_XOFF_CHAR_SENT;
+            while (!(_pUart->UART_SR & UART_SR_TXRDY)) sw_barrier();
+            _pUart->UART_THR = XON_CHAR;
+          #endif
+        }
+      }
+
+    #endif
+  }
+
 template<int portNr>
   void MKHardwareSerial<portNr>::_tx_thr_empty_irq(void) {
 
@@ -255,8 +318,10 @@ template<int portNr>
 
     const uint32_t status = _pUart->UART_SR;
 
-    // Data received?
-    if (status & UART_SR_RXRDY) store_rxd_char();
+    #if DISABLED(SERIAL_RX_DMA)
+      // Data received?
+      if (status & UART_SR_RXRDY) store_rxd_char();
+    #endif
 
     #if TX_BUFFER_SIZE > 0
       // Something to send, and TX interrupts are enabled (meaning something to send)?
@@ -308,14 +373,26 @@ template<int portNr>
 
     // Configure interrupts
     _pUart->UART_IDR = 0xFFFFFFFF;
-    _pUart->UART_IER = UART_IER_RXRDY | UART_IER_OVRE | UART_IER_FRAME;
+    #if ENABLED(SERIAL_RX_DMA)
+      // The PDC takes the received bytes, first half then next half.
+      // Only the errors and the TX interrupt are left.
+      rx_buffer.tail = 0;
+      _pUart->UART_RPR  = (uint32_t)rx_buffer.buffer;
+      _pUart->UART_RCR  = RX_HALF;
+      _pUart->UART_RNPR = (uint32_t)&rx_buffer.buffer[RX_HALF];
+      _pUart->UART_RNCR = RX_HALF;
+      _pUart->UART_PTCR = UART_PTCR_RXTEN;
+      _pUart->UART_IER  = UART_IER_OVRE | UART_IER_FRAME;
+    #else
+      _pUart->UART_IER = UART_IER_RXRDY | UART_IER_OVRE | UART_IER_FRAME;
+    #endif
 
     // Install interrupt handler
     install_isr(_dwIrq, UART_ISR);
 
     // Configure priority. We need a very high priority to avoid losing characters
     // and we need to be able to preempt the Stepper ISR and everything else!
-    // (this could probably be fixed by using DMA with the Serial port)
+    // (with SERIAL_RX_DMA the bytes are not lost, the PDC does not wait)
     NVIC_SetPriority(_dwIrq, 1);
 
     // Enable UART interrupt in NVIC
@@ -339,82 +416,122 @@ template<int portNr>
     __DSB();
     __ISB();
 
+    #if ENABLED(SERIAL_RX_DMA)
+      _pUart->UART_PTCR = UART_PTCR_RXTDIS;
+    #endif
+
     pmc_disable_periph_clk( _dwId );
   }
 
 template<int portNr>
   int MKHardwareSerial<portNr>::peek(void) {
-    const int v = rx_buffer.head == rx_buffer.tail ? -1 : rx_buffer.buffer[rx_buffer.tail];
+    #if ENABLED(SERIAL_RX_DMA)
+      const int v = available() ? rx_buffer.buffer[rx_buffer.tail] : -1;
+    #else
+      const int v = rx_buffer.head == rx_buffer.tail ? -1 : rx_buffer.buffer[rx_buffer.tail];
+    #endif
     return v;
   }
 
 template<int portNr>
   int MKHardwareSerial<portNr>::read(void) {
 
-    const uint16_t h = rx_buffer.head;
-    uint16_t t = rx_buffer.tail;
+    const uint16_t t = rx_buffer.tail;
 
-    if (h == t) return -1;
+    #if ENABLED(SERIAL_RX_DMA)
+      if (!available()) return -1;
+    #else
+      if (rx_buffer.head == t) return -1;
+    #endif
 
-    int v = rx_buffer.buffer[t];
-    t = (t + 1) & (RX_BUFFER_SIZE - 1);
+    const int v = rx_buffer.buffer[t];
+    rx_advance(t, 1);
+    return v;
+  }
 
-    // Advance tail
-    rx_buffer.tail = t;
+template<int portNr>
+  uint16_t MKHardwareSerial<portNr>::readBytesUntil(const char * const stops, char * const buffer, const uint16_t length) {
 
-    #if ENABLED(SERIAL_XON_XOFF)
+    uint16_t count = 0;
 
-      // If the XOFF char was sent, or about to be sent...
-      if ((xon_xoff_state & XON_XOFF_CHAR_MASK) == XOFF_CHAR) {
-        // Get count of bytes in the RX buffer
-        const uint16_t rx_count = (h - t) & (RX_BUFFER_SIZE - 1);
-        // When below 10% of RX buffer capacity, send XON before running out of RX buffer bytes
-        if (rx_count < (RX_BUFFER_SIZE) / 10) {
-          #if TX_BUFFER_SIZE > 0
-            // Signal we want an XON character to be sent.
-            xon_xoff_state = XON_CHAR;
-            // Enable TX isr.
-            _pUart->UART_IER = UART_IER_TXRDY;
-          #else
-            // If not using TX interrupts, we must send the XON char now
-            xon_xoff_state = XON_CHAR | XON_XOFF_CHAR_SENT;
-            while (!(_pUart->UART_SR & UART_SR_TXRDY)) sw_barrier();
-            _pUart->UART_THR = XON_CHAR;
-          #endif
-        }
+    while (count < length) {
+
+      // The bytes in one piece, up to the end of the half (or of the buffer)
+      const uint16_t t = rx_buffer.tail;
+      #if ENABLED(SERIAL_RX_DMA)
+        uint16_t n = MIN(available(), uint16_t(RX_HALF - (t & (RX_HALF - 1))));
+      #else
+        const uint16_t h = rx_buffer.head;
+        uint16_t n = h >= t ? h - t : RX_BUFFER_SIZE - t;
+      #endif
+      NOMORE(n, length - count);
+
+      const unsigned char * const src = &rx_buffer.buffer[t];
+      uint16_t i = 0;
+      while (i < n && !strchr(stops, src[i])) {
+        buffer[count + i] = src[i];
+        i++;
       }
 
-    #endif
+      if (!i) break;
+      rx_advance(t, i);
+      count += i;
+      if (i < n) break;
+    }
 
-    return v;
+    return count;
   }
 
 template<int portNr>
   uint16_t MKHardwareSerial<portNr>::available(void) {
+    #if ENABLED(SERIAL_RX_DMA)
+      // The PDC never passes the tail, it stops at the end of a half until
+      // the other one is read: stopped on the tail means the buffer is full
+      uint16_t rx_count = (rx_dma_head() - rx_buffer.tail) & (RX_BUFFER_SIZE - 1);
+      if (!rx_count && !_pUart->UART_RCR) rx_count = RX_BUFFER_SIZE;
+      #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+        NOLESS(rx_max_enqueued, rx_count);
+      #endif
+      return rx_count;
+    #else
       const uint16_t h = rx_buffer.head, t = rx_buffer.tail;
       return (RX_BUFFER_SIZE + h - t) & (RX_BUFFER_SIZE - 1);
-    }
+    #endif
+  }
 
 template<int portNr>
   void MKHardwareSerial<portNr>::flush(void) {
-    rx_buffer.tail = rx_buffer.head;
 
-    #if ENABLED(SERIAL_XON_XOFF)
+    #if ENABLED(SERIAL_RX_DMA)
 
-      if ((xon_xoff_state & XON_XOFF_CHAR_MASK) == XOFF_CHAR) {
-        #if TX_BUFFER_SIZE > 0
-          // Signal we want an XON character to be sent.
-          xon_xoff_state = XON_CHAR;
-          // Enable TX isr.
-          _pUart->UART_IER = UART_IER_TXRDY;
-        #else
-          // If not using TX interrupts, we must send the XON char now
-          xon_xoff_state = XON_CHAR | XON_XOFF_CHAR_SENT;
-          while (!(_pUart->UART_SR & UART_SR_TXRDY)) sw_barrier();
-          _pUart->UART_THR = XON_CHAR;
-        #endif
+      // Give the halves back to the PDC
+      for (uint16_t n; (n = available());) {
+        const uint16_t t = rx_buffer.tail;
+        rx_advance(t, MIN(n, uint16_t(RX_HALF - (t & (RX_HALF - 1)))));
       }
 
+    #else
+
+      rx_buffer.tail = rx_buffer.head;
+
+      #if ENABLED(SERIAL_XON_XOFF)
+
+        if ((xon_xoff_state & XON_XOFF_CHAR_MASK) == XOFF_CHAR) {
+          #if TX_BUFFER_SIZE > 0
+            // Signal we want an XON character to be sent.
+            xon_xoff_state = XON_CHAR;
+            // Enable TX isr.
+            _pUart->UART_IER = UART_IER_TXRDY;
+          #else
+            // If not using TX interrupts, we must send the XON char now
+            xon_xoff_state = XON_CHAR | XON_XOFF_CHAR_SENT;
+            while (!(_pUart->UART_SR & UART_SR_TXRDY)) sw_barrier();
+            _pUart->UART_THR = XON_CHAR;
+          #endif
+        }
+
+      #endif
+
     #endif
   }
 
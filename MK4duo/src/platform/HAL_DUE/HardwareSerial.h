@@ -80,7 +80,16 @@ template <int IDPort>
 
       static uint16_t rx_max_enqueued;
 
-      static void store_rxd_char();
+      #if ENABLED(SERIAL_RX_DMA)
+        // The PDC receives in one half of rx_buffer while the other one is read
+        static constexpr uint16_t RX_HALF = (RX_BUFFER_SIZE) / 2;
+        static void rx_dma_arm(const uint16_t index);
+        FORCE_INLINE static uint16_t rx_dma_head() { return (uint8_t*)_pUart->UART_RPR - rx_buffer.buffer; }
+      #else
+        static void store_rxd_char();
+      #endif
+
+      static void rx_advance(const uint16_t t, const uint16_t count);
       static void _tx_thr_empty_irq(void);
       
       static void UART_ISR(void);
@@ -96,6 +105,12 @@ template <int IDPort>
       static void write(const uint8_t c);
       static void flushTX(void);
 
+      /**
+       * Read up to length bytes at once, stop before a character in stops
+       * or when no more bytes are received. Return the bytes read.
+       */
+      static uint16_t readBytesUntil(const char * const stops, char * const buffer, const uint16_t length);
+
       #if ENABLED(SERIAL_STATS_DROPPED_RX)
         FORCE_INLINE static uint32_t dropped() { return rx_dropped_bytes; }
       #endif
@@ -38,9 +38,16 @@
  * amount of non overlapping diffs possible and sorted by starting
  * address before being saved into the next available page of FLASH
  * of the current group.
- * Once the current group is completely full, we compact it and save
- * it into the other group, then erase the current group and switch
- * to that new group and set it as current.
+ * Once the current group is completely full and a new page is needed,
+ * we compact it and save it into the other group, then switch to that
+ * new group and set it as current. Only the first page of the old group
+ * is erased at once, the others are erased one at a time when the
+ * printer is idle, as an erase stalls the interrupts for a while.
+ *
+ * A RAM image of the emulated EEPROM is built at startup from the
+ * pages of the current group. Reads come from it, and a write of
+ * the value already stored is dropped, so only the changed bytes
+ * of the settings go into the RAM buffer and then to FLASH.
  *
  * The FLASH endurance is about 1/10 ... 1/100 of an EEPROM
  * endurance, but EEPROM endurance is specified per byte, not
@@ -129,7 +136,9 @@ static const FLASH_SECTOR_T* getFlashStorage(int page) {
 
 static uint8_t  buffer[256] = { 0 },  // The RAM buffer to accumulate writes
                 curPage = 0,          // Current FLASH page inside the group
-                curGroup = 0xFF;      // Current FLASH group
+                curGroup = 0xFF,      // Current FLASH group
+                sparePage = PagesPerGroup, // Next page of the previous group to erase
+                image[EEPROMSize];    // The emulated EEPROM, FLASH pages and RAM buffer applied
 
 //#define EE_EMU_DEBUG
 #if ENABLED(EE_EMU_DEBUG)
@@ -416,178 +425,109 @@ static bool ee_PageErase(uint16_t page) {
 
   return true;
 }
-static uint8_t ee_Read(uint32_t address, bool excludeRAMBuffer=false) {
-
-  uint32_t baddr;
-  uint32_t blen;
+static uint8_t ee_Read(uint32_t address) {
 
   // If we were requested an address outside of the emulated range, fail now
   if (address >= EEPROMSize)
     return false;
 
-  // Check that the value is not contained in the RAM buffer
-  if (!excludeRAMBuffer) {
-    int i = 0;
-    while (i <= (PageSize - 4)) { /* (PageSize - 4) because otherwise, there is not enough room for data and headers */
-
-      // Get the address of the block
-      baddr = buffer[i] | (buffer[i + 1] << 8);
-
-      // Get the length of the block
-      blen = buffer[i + 2];
-
-      // If we reach the end of the list, break loop
-      if (blen == 0xFF)
-        break;
-
-      // Check if data is contained in this block
-      if (address >= baddr &&
-        address < (baddr + blen)) {
-
-        // Yes, it is contained. Return it!
-        return buffer[i + 3 + address - baddr];
-      }
-
-      // As blocks are always sorted, if the starting address of this block is higher
-      // than the address we are looking for, break loop now - We wont find the value
-      // associated to the address
-      if (baddr > address)
-        break;
-
-      // Jump to the next block
-      i += 3 + blen;
-    }
-  }
-
-  // It is NOT on the RAM buffer. It could be stored in FLASH. We are
-  //  ensured on a given FLASH page, address contents are never repeated
-  //  but on different pages, there is no such warranty, so we must go
-  //  backwards from the last written FLASH page to the first one.
-  for (int page = curPage - 1; page >= 0; --page) {
-
-    // Get a pointer to the flash page
-    uint8_t* pflash = (uint8_t*)getFlashStorage(page + curGroup * PagesPerGroup);
-
-    uint16_t i = 0;
-    while (i <= (PageSize - 4)) { /* (PageSize - 4) because otherwise, there is not enough room for data and headers */
-
-      // Get the address of the block
-      baddr = pflash[i] | (pflash[i + 1] << 8);
-
-      // Get the length of the block
-      blen = pflash[i + 2];
-
-      // If we reach the end of the list, break loop
-      if (blen == 0xFF)
-        break;
-
-      // Check if data is contained in this block
-      if (address >= baddr && address < (baddr + blen))
-        return pflash[i + 3 + address - baddr]; // Yes, it is contained. Return it!
+  // The RAM image holds the FLASH contents with the RAM buffer applied
+  return image[address];
+}
 
-      // As blocks are always sorted, if the starting address of this block is higher
-      // than the address we are looking for, break loop now - We wont find the value
-      // associated to the address
-      if (baddr > address) break;
+static bool ee_IsPageClean(int page) {
+  uint32_t* pflash = (uint32_t*) getFlashStorage(page);
+  for (uint16_t i = 0; i < (PageSize >> 2); ++i)
+    if (*pflash++ != 0xFFFFFFFF) return false;
+  return true;
+}
 
-      // Jump to the next block
-      i += 3 + blen;
+/**
+ * Erase the pages left on the group we switched from.
+ * With all=false a single page is erased, so the stall
+ * of an erase is spread over the idle time.
+ */
+static void ee_EraseSpare(const bool all) {
+  const uint8_t spareGroup = curGroup ? curGroup - 1 : GroupCount - 1;
+  while (sparePage < PagesPerGroup) {
+    const int page = sparePage++ + spareGroup * PagesPerGroup;
+    if (!ee_IsPageClean(page)) {
+      ee_PageErase(page);
+      if (!all) return;
     }
   }
-
-  // If reached here, value is not stored, so return its default value
-  return 0xFF;
 }
 
-static uint32_t ee_GetAddrRange(uint32_t address, bool excludeRAMBuffer=false) {
-  uint32_t  baddr,
-            blen,
-            nextAddr = 0xFFFF,
-            nextRange = 0;
-
-  // Check that the value is not contained in the RAM buffer
-  if (!excludeRAMBuffer) {
-    uint16_t i = 0;
-    while (i <= (PageSize - 4)) { /* (PageSize - 4) because otherwise, there is not enough room for data and headers */
-
-      // Get the address of the block
-      baddr = buffer[i] | (buffer[i + 1] << 8);
-
-      // Get the length of the block
-      blen = buffer[i + 2];
+/**
+ * Write the RAM image, as the least amount of sorted blocks,
+ * to the next group and make it the current one.
+ */
+static bool ee_Compact() {
 
-      // If we reach the end of the list, break loop
-      if (blen == 0xFF) break;
+  // Compute the next group to use, it must be completely erased
+  int curwPage = 0, curwGroup = curGroup + 1;
+  if (curwGroup >= GroupCount) curwGroup = 0;
 
-      // Check if address and address + 1 is contained in this block
-      if (address >= baddr && address < (baddr + blen))
-        return address | ((blen - address + baddr) << 16); // Yes, it is contained. Return it!
+  if (sparePage < PagesPerGroup) ee_EraseSpare(true);
 
-      // Otherwise, check if we can use it as a limit
-      if (baddr > address && baddr < nextAddr) {
-        nextAddr = baddr;
-        nextRange = blen;
-      }
+  // Start with a clean RAM buffer
+  memset(buffer, 0xFF, sizeof(buffer));
 
-      // As blocks are always sorted, if the starting address of this block is higher
-      // than the address we are looking for, break loop now - We wont find the value
-      // associated to the address
-      if (baddr > address) break;
+  uint16_t i = 0;
+  uint32_t rdAddr = 0;
+  while (rdAddr < EEPROMSize) {
 
-      // Jump to the next block
-      i += 3 + blen;
+    // Do not bother storing default values
+    if (image[rdAddr] == 0xFF) {
+      ++rdAddr;
+      continue;
     }
-  }
-
-  // It is NOT on the RAM buffer. It could be stored in FLASH. We are
-  //  ensured on a given FLASH page, address contents are never repeated
-  //  but on different pages, there is no such warranty, so we must go
-  //  backwards from the last written FLASH page to the first one.
-  for (int page = curPage - 1; page >= 0; --page) {
-
-    // Get a pointer to the flash page
-    uint8_t* pflash = (uint8_t*)getFlashStorage(page + curGroup * PagesPerGroup);
 
-    uint16_t i = 0;
-    while (i <= (PageSize - 4)) { /* (PageSize - 4) because otherwise, there is not enough room for data and headers */
+    // Can we create a new slot ?
+    if (i > (PageSize - 4)) {
 
-      // Get the address of the block
-      baddr = pflash[i] | (pflash[i + 1] << 8);
+      // Not enough space - Write the current buffer to FLASH
+      if (!ee_PageWrite(curwPage + curwGroup * PagesPerGroup, buffer)) return false;
 
-      // Get the length of the block
-      blen = pflash[i + 2];
+      // Advance write page (as we are compacting, should never overflow!)
+      ++curwPage;
 
-      // If we reach the end of the list, break loop
-      if (blen == 0xFF) break;
+      // Clear RAM buffer
+      memset(buffer, 0xFF, sizeof(buffer));
 
-      // Check if data is contained in this block
-      if (address >= baddr && address < (baddr + blen))
-        return address | ((blen - address + baddr) << 16); // Yes, it is contained. Return it!
-
-      // Otherwise, check if we can use it as a limit
-      if (baddr > address && baddr < nextAddr) {
-        nextAddr = baddr;
-        nextRange = blen;
-      }
+      // Start fresh
+      i = 0;
+    }
 
-      // As blocks are always sorted, if the starting address of this block is higher
-      // than the address we are looking for, break loop now - We wont find the value
-      // associated to the address
-      if (baddr > address) break;
+    // Add a new block with the next run of non default values
+    buffer[i] = rdAddr & 0xFF;
+    buffer[i + 1] = (rdAddr >> 8) & 0xFF;
+    uint8_t blen = 0;
+    while (rdAddr < EEPROMSize && image[rdAddr] != 0xFF && i + 3 + blen < PageSize && blen < 0xFE)
+      buffer[i + 3 + blen++] = image[rdAddr++];
+    buffer[i + 2] = blen;
+    i += 3 + blen;
+  }
 
-      // Jump to the next block
-      i += 3 + blen;
-    }
+  // Write the last page
+  if (i) {
+    if (!ee_PageWrite(curwPage + curwGroup * PagesPerGroup, buffer)) return false;
+    ++curwPage;
+    memset(buffer, 0xFF, sizeof(buffer));
   }
 
-  // If reached here, we will return the next valid address
-  return nextAddr | (nextRange << 16);
-}
+  // Erase the first page of the previous group now, so at startup the
+  // new group is found as the current one. The other pages are erased
+  // later, one per idle call, to avoid a long stall with the interrupts
+  // disabled in the middle of a print.
+  ee_PageErase(curGroup * PagesPerGroup);
+  sparePage = 1;
 
-static bool ee_IsPageClean(int page) {
-  uint32_t* pflash = (uint32_t*) getFlashStorage(page);
-  for (uint16_t i = 0; i < (PageSize >> 2); ++i)
-    if (*pflash++ != 0xFFFFFFFF) return false;
+  // Finally, Now the active group is the created new group
+  curGroup = curwGroup;
+  curPage = curwPage;
+
+  // Done!
   return true;
 }
 
@@ -603,156 +543,35 @@ static bool ee_Flush(uint32_t overrideAddress=0xFFFFFFFF, uint8_t overrideData=0
     }
   }
 
-  // If something has to be written, do so!
-  if (!isEmpty) {
-
-    // Write the current ram buffer into FLASH
-    ee_PageWrite(curPage + curGroup * PagesPerGroup, buffer);
-
-    // Clear the RAM buffer
-    memset(buffer, 0xFF, sizeof(buffer));
-
-    // Increment the page to use the next time
-    ++curPage;
-  }
+  // Nothing changed, nothing to write
+  if (isEmpty) return true;
 
   // Did we reach the maximum count of available pages per group for storage ?
-  if (curPage < PagesPerGroup) {
-
-    // Do we have an override address ?
-    if (overrideAddress < EEPROMSize) {
-
-      // Yes, just store the value into the RAM buffer
-      buffer[0] = overrideAddress & 0xFF;
-      buffer[0 + 1] = (overrideAddress >> 8) & 0xFF;
-      buffer[0 + 2] = 1;
-      buffer[0 + 3] = overrideData;
-    }
-
-    // Done!
-    return true;
-  }
-
-  // We have no space left on the current group - We must compact the values
-  uint16_t i = 0;
-
-  // Compute the next group to use
-  int curwPage = 0, curwGroup = curGroup + 1;
-  if (curwGroup >= GroupCount) curwGroup = 0;
-
-  uint32_t rdAddr = 0;
-  do {
-
-    // Get the next valid range
-    uint32_t addrRange = ee_GetAddrRange(rdAddr, true);
-
-    // Make sure not to skip the override address, if specified
-    int rdRange;
-    if (overrideAddress < EEPROMSize &&
-      rdAddr <= overrideAddress &&
-      (addrRange & 0xFFFF) > overrideAddress) {
-
-      rdAddr = overrideAddress;
-      rdRange = 1;
-    }
-    else {
-      rdAddr = addrRange & 0xFFFF;
-      rdRange = addrRange >> 16;
-    }
-
-    // If no range, break loop
-    if (rdRange == 0)
-      break;
-
-    do {
-
-      // Get the value
-      uint8_t rdValue = overrideAddress == rdAddr ? overrideData : ee_Read(rdAddr, true);
-
-      // Do not bother storing default values
-      if (rdValue != 0xFF) {
-
-        // If we have room, add it to the buffer
-        if (buffer[i + 2] == 0xFF) {
-
-          // Uninitialized buffer, just add it!
-          buffer[i] = rdAddr & 0xFF;
-          buffer[i + 1] = (rdAddr >> 8) & 0xFF;
-          buffer[i + 2] = 1;
-          buffer[i + 3] = rdValue;
-
-        }
-        else {
-          // Buffer already has contents. Check if we can extend it
-
-          // Get the address of the block
-          uint32_t baddr = buffer[i] | (buffer[i + 1] << 8);
-
-          // Get the length of the block
-          uint32_t blen = buffer[i + 2];
-
-          // Can we expand it ?
-          if (rdAddr == (baddr + blen) &&
-            i < (PageSize - 4) && /* This block has a chance to contain data AND */
-            buffer[i + 2] < (PageSize - i - 3)) {/* There is room for this block to be expanded */
-
-            // Yes, do it
-            ++buffer[i + 2];
+  // The values of the buffer and the override are already in the RAM image,
+  // compact it on the other group only now that a page is really needed.
+  if (curPage >= PagesPerGroup) return ee_Compact();
 
-            // And store the value
-            buffer[i + 3 + rdAddr - baddr] = rdValue;
+  // Write the current ram buffer into FLASH
+  const bool ok = ee_PageWrite(curPage + curGroup * PagesPerGroup, buffer);
 
-          }
-          else {
-
-            // No, we can't expand it - Skip the existing block
-            i += 3 + blen;
-
-            // Can we create a new slot ?
-            if (i > (PageSize - 4)) {
-
-              // Not enough space - Write the current buffer to FLASH
-              ee_PageWrite(curwPage + curwGroup * PagesPerGroup, buffer);
-
-              // Advance write page (as we are compacting, should never overflow!)
-              ++curwPage;
-
-              // Clear RAM buffer
-              memset(buffer, 0xFF, sizeof(buffer));
-
-              // Start fresh */
-              i = 0;
-            }
-
-            // Enough space, add the new block
-            buffer[i] = rdAddr & 0xFF;
-            buffer[i + 1] = (rdAddr >> 8) & 0xFF;
-            buffer[i + 2] = 1;
-            buffer[i + 3] = rdValue;
-          }
-        }
-      }
-
-      // Go to the next address
-      ++rdAddr;
+  // Clear the RAM buffer
+  memset(buffer, 0xFF, sizeof(buffer));
 
-      // Repeat for bytes of this range
-    } while (--rdRange);
+  // Increment the page to use the next time
+  ++curPage;
 
-    // Repeat until we run out of ranges
-  } while (rdAddr < EEPROMSize);
+  // Do we have an override address ?
+  if (overrideAddress < EEPROMSize) {
 
-  // We must erase the previous group, in preparation for the next swap
-  for (int page = 0; page < curPage; page++) {
-    ee_PageErase(page + curGroup * PagesPerGroup);
+    // Yes, just store the value into the RAM buffer
+    buffer[0] = overrideAddress & 0xFF;
+    buffer[0 + 1] = (overrideAddress >> 8) & 0xFF;
+    buffer[0 + 2] = 1;
+    buffer[0 + 3] = overrideData;
   }
 
-  // Finally, Now the active group is the created new group
-  curGroup = curwGroup;
-  curPage = curwPage;
-
   // Done!
-  return true;
+  return ok;
 }
 
 static bool ee_Write(uint32_t address, uint8_t data) {
@@ -760,6 +579,11 @@ static bool ee_Write(uint32_t address, uint8_t data) {
   // If we were requested an address outside of the emulated range, fail now
   if (address >= EEPROMSize) return false;
 
+  // Only the values that change are written, so a store
+  // of unchanged settings does not use any FLASH page
+  if (image[address] == data) return true;
+  image[address] = data;
+
   // Lets check if we have a block with that data previously defined. Block
   //  start addresses are always sorted in ascending order
   uint16_t i = 0;
@@ -963,6 +787,30 @@ static void ee_Init() {
       ee_PageErase(curGroup * PagesPerGroup + page);
     }
   }
+
+  // Build the RAM image, applying the pages in the order they were written
+  memset(image, 0xFF, sizeof(image));
+  for (int page = 0; page < curPage; ++page) {
+
+    // Get a pointer to the flash page
+    const uint8_t* pflash = (const uint8_t*)getFlashStorage(page + curGroup * PagesPerGroup);
+
+    uint16_t i = 0;
+    while (i <= (PageSize - 4)) { /* (PageSize - 4) because otherwise, there is not enough room for data and headers */
+
+      // Get the address and the length of the block
+      const uint32_t  baddr = pflash[i] | (pflash[i + 1] << 8),
+                      blen  = pflash[i + 2];
+
+      // If we reach the end of the list, break loop
+      if (blen == 0xFF || i + 3 + blen > PageSize || baddr + blen > EEPROMSize) break;
+
+      memcpy(&image[baddr], &pflash[i + 3], blen);
+
+      // Jump to the next block
+      i += 3 + blen;
+    }
+  }
 }
 
 uint8_t eeprom_read_byte(uint8_t* addr) {
@@ -996,9 +844,14 @@ void eeprom_read_block(void* pos, const void* eeprom_address, size_t n) {
 }
 
 void eeprom_flush(void) {
+  ee_Init();
   ee_Flush();
 }
 
+void eeprom_erase_spare(void) {
+  if (curGroup != 0xFF && sparePage < PagesPerGroup) ee_EraseSpare(false);
+}
+
 #endif // HAS_EEPROM_FLASH
 
 #endif // ARDUINO_ARCH_SAM
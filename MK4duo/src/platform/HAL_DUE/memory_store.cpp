@@ -30,6 +30,10 @@ MemoryStore memorystore;
 
 extern void eeprom_flush(void);
 
+#if HAS_EEPROM_FLASH
+  extern void eeprom_erase_spare(void);
+#endif
+
 /** Public Parameters */
 #if HAS_EEPROM_SD
   char MemoryStore::eeprom_data[EEPROM_SIZE];
@@ -59,7 +63,9 @@ bool MemoryStore::write_data(int &pos, const uint8_t *value, size_t size, uint16
       // so only write bytes that have changed!
       if (v != eeprom_read_byte(p)) {
         eeprom_write_byte(p, v);
-        delay(2);
+        #if DISABLED(EEPROM_FLASH)
+          delay(2); // The flash emulation only writes in RAM here
+        #endif
         if (eeprom_read_byte(p) != v) {
           SERIAL_LM(ECHO, MSG_ERR_EEPROM_WRITE);
           return true;
@@ -93,6 +99,10 @@ bool MemoryStore::read_data(int &pos, uint8_t *value, size_t size, uint16_t *crc
 
 size_t MemoryStore::capacity() { return EEPROM_SIZE + 1; }
 
+#if HAS_EEPROM_FLASH
+  void MemoryStore::spin() { eeprom_erase_spare(); }
+#endif
+
 #endif // HAS_EEPROM
 
 #endif // ARDUINO_ARCH_SAM
@@ -0,0 +1,312 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * This is the main Hardware Abstraction Layer (HAL).
+ * To make the firmware work with different processors and toolchains,
+ * all hardware related code should be packed into the hal files.
+ *
+ * Description: HAL for Linux native (host) build
+ *
+ * __PLAT_LINUX__
+ */
+
+#ifdef __PLAT_LINUX__
+
+// --------------------------------------------------------------------------
+// Includes
+// --------------------------------------------------------------------------
+#include "../../../MK4duo.h"
+#include "simulator.h"
+#include "benchmark.h"
+#include "sdcard_image.h"
+#include <time.h>
+#include <unistd.h>
+#include <limits.h>
+
+// --------------------------------------------------------------------------
+// Public Variables
+// --------------------------------------------------------------------------
+
+uint8_t MCUSR;
+
+Fastio_Param Fastio[NUM_DIGITAL_PINS];
+
+SPIClass SPI;
+
+uint8_t SPIClass::transfer(uint8_t data) { return sdcard_image.transfer(data); }
+
+int16_t HAL::AnalogInputValues[NUM_ANALOG_INPUTS] = { 0 };
+bool    HAL::Analog_is_ready = false;
+
+// --------------------------------------------------------------------------
+// Private Variables
+// --------------------------------------------------------------------------
+
+static char** main_argv = NULL;
+
+static uint64_t start_ns = 0;
+
+// --------------------------------------------------------------------------
+// Arduino core
+// --------------------------------------------------------------------------
+
+uint32_t millis() { return uint32_t((HAL_timer_ns() - start_ns) / 1000000ULL); }
+uint32_t micros() { return uint32_t((HAL_timer_ns() - start_ns) / 1000ULL); }
+
+void delay(const uint32_t ms) {
+  const uint64_t ns = uint64_t(ms) * 1000000ULL / HAL_timer_get_speed();
+  const struct timespec ts = { time_t(ns / 1000000000ULL), long(ns % 1000000000ULL) };
+  nanosleep(&ts, NULL);
+}
+
+void delayMicroseconds(const uint32_t us) { HAL_delay_ns(us * 1000UL); }
+
+void yield() {}
+
+void noInterrupts() { HAL_disable_isrs(); }
+void interrupts()   { HAL_enable_isrs(); }
+
+void pinMode(const uint8_t pin, const uint8_t mode) { HAL::pinMode(pin, mode); }
+void digitalWrite(const uint8_t pin, const uint8_t value) { HAL::digitalWrite(pin, value); }
+int digitalRead(const uint8_t pin) { return HAL::digitalRead(pin); }
+void analogWrite(const uint8_t pin, const int value) { HAL::analogWrite(pin, value); }
+
+long random(const long max) { return max > 0 ? ::random() % max : 0; }
+long random(const long min, const long max) { return min < max ? min + random(max - min) : min; }
+void randomSeed(const unsigned long seed) { srandom(seed); }
+
+char* dtostrf(double val, signed char width, unsigned char prec, char *sout) {
+  sprintf(sout, "%*.*f", width, prec, val);
+  return sout;
+}
+
+static char* ultoa_base(unsigned long value, char* str, int base, const bool negative) {
+  char tmp[sizeof(long) * 8 + 1];
+  char *t = tmp, *s = str;
+  if (base < 2 || base > 36) { *str = '\0'; return str; }
+  do {
+    const int d = value % base;
+    *t++ = d < 10 ? '0' + d : 'a' + d - 10;
+    value /= base;
+  } while (value);
+  if (negative) *s++ = '-';
+  while (t > tmp) *s++ = *--t;
+  *s = '\0';
+  return str;
+}
+
+char* ultoa(unsigned long value, char* str, int base) { return ultoa_base(value, str, base, false); }
+char* utoa(unsigned value, char* str, int base) { return ultoa_base(value, str, base, false); }
+char* ltoa(long value, char* str, int base) {
+  const bool negative = base == 10 && value < 0;
+  return ultoa_base(negative ? -(unsigned long)value : (unsigned long)value, str, base, negative);
+}
+char* itoa(int value, char* str, int base) { return ltoa(value, str, base); }
+
+// disable interrupts
+void cli(void) {
+  noInterrupts();
+}
+
+// enable interrupts
+void sei(void) {
+  interrupts();
+}
+
+// Tone
+static pin_t tone_pin;
+volatile static int32_t toggles;
+
+void tone(const pin_t _pin, const uint16_t frequency, const uint16_t duration) {
+  tone_pin = _pin;
+  toggles = 2 * frequency * duration / 1000;
+  HAL_timer_start(TONE_TIMER_NUM, 2 * frequency);
+}
+
+void noTone(const pin_t _pin) {
+  HAL_timer_disable_interrupt(TONE_TIMER_NUM);
+  HAL::digitalWrite(_pin, LOW);
+}
+
+HAL_TONE_TIMER_ISR() {
+  static uint8_t pin_state = 0;
+  HAL_timer_isr_prologue(TONE_TIMER_NUM);
+
+  if (toggles) {
+    toggles--;
+    HAL::digitalWrite(tone_pin, (pin_state ^= 1));
+  }
+  else noTone(tone_pin);
+}
+
+HAL::HAL() {
+  // ctor
+}
+
+HAL::~HAL() {
+  // dtor
+}
+
+// do any hardware-specific initialization here
+void HAL::hwSetup(void) {
+  setvbuf(stdout, NULL, _IOFBF, BUFSIZ);
+}
+
+// Print apparent cause of start/restart
+void HAL::showStartReason() {
+  switch (MCUSR) {
+    case RST_SOFTWARE: SERIAL_EM(MSG_SOFTWARE_RESET); break;
+    default:           SERIAL_EM(MSG_POWERUP); break;
+  }
+}
+
+// Return available memory
+int HAL::getFreeRam() {
+  const long pages = sysconf(_SC_AVPHYS_PAGES), page_size = sysconf(_SC_PAGESIZE);
+  return (int)MIN((long long)pages * page_size, (long long)INT_MAX);
+}
+
+// The ADC is fed by the simulator
+void HAL::analogStart(void) {}
+
+void HAL::AdcChangePin(const pin_t, const pin_t) {}
+
+// Reset: run again the same executable
+void HAL::resetHardware() {
+  fflush(stdout);
+  if (main_argv) execv("/proc/self/exe", main_argv);
+  exit(0);
+}
+
+bool HAL::pwm_status(const pin_t pin) { return VALID_PIN(pin); }
+
+bool HAL::tc_status(const pin_t) { return false; }
+
+/**
+ * Every pin has hardware PWM, the duty cycle is kept for the simulator
+ */
+void HAL::analogWrite(const pin_t pin, uint32_t ulValue, const uint16_t) {
+  if (!VALID_PIN(pin)) return;
+  NOMORE(ulValue, 255U);
+  Fastio[pin].pwm   = ulValue;
+  Fastio[pin].value = ulValue >= 128;
+}
+
+/**
+ * Tick is is called 1000 timer per second.
+ * It is used to update pwm values for heater and some other frequent jobs.
+ *
+ *  - Manage PWM to all the heaters and fan
+ *  - Run the simulated machine and read the raw ADC sensor values
+ *  - For PINS_DEBUGGING, monitor and report endstop pins
+ *  - For ENDSTOP_INTERRUPTS_FEATURE check endstops if flagged
+ */
+void HAL::Tick() {
+
+  static millis_t cycle_check_temp = 0;
+  millis_t now = millis();
+
+  if (printer.isStopped()) return;
+
+  // Heaters set output PWM
+  #if HOTENDS > 0
+    LOOP_HOTEND() hotends[h].setOutputPwm();
+  #endif
+  #if BEDS > 0
+    LOOP_BED() beds[h].setOutputPwm();
+  #endif
+  #if CHAMBERS > 0
+    LOOP_CHAMBER() chambers[h].setOutputPwm();
+  #endif
+
+  // Fans set output PWM
+  #if FAN_COUNT > 0
+    LOOP_FAN() fans[f].setOutputPwm();
+  #endif
+
+  // Software PWM modulation
+  softpwm.spin();
+
+  // Simulated heaters and ADC, the conversion is synchronous
+  // so the raw values are valid before the first temperature spin
+  simulator.spin();
+
+  #if ANALOG_INPUTS > 0
+    if (HAL::Analog_is_ready) thermalManager.set_current_temp_raw();
+  #endif
+
+  // Calculation cycle temp a 100ms
+  if (ELAPSED(now, cycle_check_temp)) {
+    cycle_check_temp = now + 100UL;
+    // Temperature Spin
+    thermalManager.spin();
+    #if ENABLED(FAN_KICKSTART_TIME) && FAN_COUNT > 0
+      LOOP_FAN() {
+        if (fans[f].Kickstart) fans[f].Kickstart--;
+      }
+    #endif
+  }
+
+  // Tick endstops state, if required
+  endstops.Tick();
+
+}
+
+/**
+ * SPI, there is no bus on the host
+ */
+void HAL::spiBegin() {}
+void HAL::spiInit(uint8_t) {}
+uint8_t HAL::spiTransfer(uint8_t) { return 0xFF; }
+void HAL::spiSend(uint8_t) {}
+void HAL::spiSend(const uint8_t*, size_t) {}
+void HAL::spiSend(uint32_t, uint8_t) {}
+void HAL::spiSend(uint32_t, const uint8_t*, size_t) {}
+uint8_t HAL::spiReceive(void) { return 0xFF; }
+uint8_t HAL::spiReceive(uint32_t) { return 0xFF; }
+void HAL::spiReadBlock(uint8_t* buf, uint16_t nbyte) { memset(buf, 0xFF, nbyte); }
+void HAL::spiSendBlock(uint8_t, const uint8_t*) {}
+
+/**
+ * Process entry point: start the simulated hardware and run the sketch
+ */
+int main(int argc, char** argv) {
+
+  main_argv = argv;
+  sdcard_image.init(argc, argv);
+  benchmark.init(argc, argv);
+  start_ns  = HAL_timer_ns();
+  MCUSR     = getenv("MK4DUO_RESTARTED") ? RST_SOFTWARE : RST_POWER_ON;
+  setenv("MK4DUO_RESTARTED", "1", 1);
+
+  simulator.init();
+  HAL_timer_thread_start();
+
+  setup();
+  if (benchmark.active()) benchmark.start();
+  for (;;) loop();
+
+  return 0;
+}
+
+#endif // __PLAT_LINUX__
@@ -0,0 +1,264 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * This is the main Hardware Abstraction Layer (HAL).
+ * To make the firmware work with different processors and toolchains,
+ * all hardware related code should be packed into the hal files.
+ *
+ * Description: HAL for Linux native (host) build
+ *
+ * The firmware runs as a normal Linux process. All peripherals are simulated:
+ *  - GPIO pins are kept in memory (fastio.h)
+ *  - Hardware timers are serviced by a dedicated thread that plays the role
+ *    of the interrupt controller (HAL_timers.cpp)
+ *  - The ADC is fed by a simple thermal model of every heater (simulator.cpp)
+ *  - Serial port 0 is stdin / stdout (HardwareSerial.cpp)
+ *  - EEPROM is a file in the working directory (memory_store.cpp)
+ *
+ * Command line: --speed K runs the simulated clock K times faster than the
+ * host clock, --bench file.gcode runs the planner benchmark (benchmark.cpp)
+ *
+ * Select BOARD_LINUX_RAMPS as MOTHERBOARD and build with the host compiler, e.g.:
+ *
+ *   g++ -std=gnu++11 -O2 -fpermissive -D__PLAT_LINUX__ -Isrc/platform/HAL_LINUX/include \
+ *       -x c++ MK4duo.ino -x none $(find src -name '*.cpp') -lpthread -o mk4duo
+ *
+ * __PLAT_LINUX__
+ */
+#pragma once
+
+// --------------------------------------------------------------------------
+// Includes
+// --------------------------------------------------------------------------
+#include <stdint.h>
+#include <Arduino.h>
+
+// --------------------------------------------------------------------------
+// Types
+// --------------------------------------------------------------------------
+typedef uint32_t  hal_timer_t;
+typedef uintptr_t ptr_int_t;
+
+// --------------------------------------------------------------------------
+// Includes
+// --------------------------------------------------------------------------
+#include "fastio.h"
+#include "math.h"
+#include "delay.h"
+#include "watchdog.h"
+#include "HAL_timers.h"
+
+// --------------------------------------------------------------------------
+// Defines
+// --------------------------------------------------------------------------
+
+// SERIAL ports
+#include "HardwareSerial.h"
+#if !WITHIN(SERIAL_PORT_1, -1, 0)
+  #error "SERIAL_PORT_1 must be -1 or 0, the host has only stdin / stdout"
+#endif
+#define MKSERIAL1 MKSerial
+
+#if ENABLED(SERIAL_PORT_2) && SERIAL_PORT_2 >= -1
+  #error "SERIAL_PORT_2 is not supported on the host, set it to -2"
+#else
+  #define NUM_SERIAL 1
+#endif
+
+// CRITICAL SECTION
+#define CRITICAL_SECTION_START  const bool irqon = ISRS_ENABLED(); DISABLE_ISRS();
+#define CRITICAL_SECTION_END    if (irqon) ENABLE_ISRS();
+
+// ISR function
+#define ISRS_ENABLED()          HAL_isrs_enabled()
+#define ENABLE_ISRS()           HAL_enable_isrs()
+#define DISABLE_ISRS()          HAL_disable_isrs()
+
+// Voltage
+#define HAL_VOLTAGE_PIN 3.3
+
+// reset reason
+#define RST_POWER_ON   1
+#define RST_EXTERNAL   2
+#define RST_BROWN_OUT  4
+#define RST_WATCHDOG   8
+#define RST_JTAG       16
+#define RST_SOFTWARE   32
+#define RST_BACKUP     64
+
+#define SPR0    0
+#define SPR1    1
+
+#define PACK    __attribute__ ((packed))
+
+// Macros for stepper.cpp
+#define HAL_MULTI_ACC(A,B)  MultiU32X32toH32(A,B)
+
+#define HAL_TIMER_TYPE_MAX  0xFFFFFFFF
+
+// TEMPERATURE
+#undef analogInputToDigitalPin
+#define analogInputToDigitalPin(p) ((p < NUM_ANALOG_INPUTS) ? (p) : -1)
+#undef NUM_ANALOG_INPUTS
+#define NUM_ANALOG_INPUTS       16
+#define ADC_TEMPERATURE_SENSOR  15
+// Bits of the ADC converter
+#define ANALOG_INPUT_BITS 12
+#define OVERSAMPLENR       2
+#define AD_RANGE       16384
+#define ABS_ZERO        -273.15f
+#define NUM_ADC_SAMPLES   32
+#define AD595_MAX        330.0f
+#define AD8495_MAX       660.0f
+
+#define HARDWARE_PWM true
+
+#define GET_PIN_MAP_PIN(index) index
+#define GET_PIN_MAP_INDEX(pin) pin
+#define PARSED_PIN_INDEX(code, dval) parser.intval(code, dval)
+
+// --------------------------------------------------------------------------
+// Public Variables
+// --------------------------------------------------------------------------
+
+// reset reason
+extern uint8_t MCUSR;
+
+// --------------------------------------------------------------------------
+// Public functions
+// --------------------------------------------------------------------------
+
+// Interrupt emulation
+bool HAL_isrs_enabled();
+void HAL_enable_isrs();
+void HAL_disable_isrs();
+
+class HAL {
+
+  public: /** Constructor */
+
+    HAL();
+
+    virtual ~HAL();
+
+  public: /** Public Parameters */
+
+    static int16_t AnalogInputValues[NUM_ANALOG_INPUTS];
+    static bool Analog_is_ready;
+
+  public: /** Public Function */
+
+    static void analogStart();
+    static void AdcChangePin(const pin_t old_pin, const pin_t new_pin);
+
+    static void hwSetup(void);
+
+    static bool pwm_status(const pin_t pin);
+    static bool tc_status(const pin_t pin);
+
+    static void analogWrite(const pin_t pin, uint32_t ulValue, const uint16_t freq=1000);
+
+    static void Tick();
+
+    FORCE_INLINE static void pinMode(const pin_t pin, const uint8_t mode) {
+      switch (mode) {
+        case INPUT:         SET_INPUT(pin);         break;
+        case OUTPUT:        SET_OUTPUT(pin);        break;
+        case INPUT_PULLUP:  SET_INPUT_PULLUP(pin);  break;
+        case OUTPUT_LOW:    SET_OUTPUT(pin);        break;
+        case OUTPUT_HIGH:   SET_OUTPUT_HIGH(pin);   break;
+        default:                                    break;
+      }
+    }
+    FORCE_INLINE static void digitalWrite(const pin_t pin, const bool value) {
+      WRITE_VAR(pin, value);
+    }
+    FORCE_INLINE static bool digitalRead(const pin_t pin) {
+      return READ_VAR(pin);
+    }
+    FORCE_INLINE static void setInputPullup(const pin_t pin, const bool onoff) {
+      if (onoff) SET_INPUT_PULLUP(pin);
+    }
+
+    FORCE_INLINE static void delayNanoseconds(const uint32_t delayNs) {
+      HAL_delay_ns(delayNs);
+    }
+    FORCE_INLINE static void delayMicroseconds(const uint32_t delayUs) {
+      HAL_delay_ns(delayUs * 1000UL);
+    }
+    FORCE_INLINE static void delayMilliseconds(uint16_t delayMs) {
+      uint16_t del;
+      while (delayMs > 0) {
+        del = delayMs > 100 ? 100 : delayMs;
+        delay(del);
+        delayMs -= del;
+        watchdog.reset();
+      }
+    }
+    FORCE_INLINE static uint32_t timeInMilliseconds() {
+      return millis();
+    }
+
+    static void showStartReason();
+
+    static int getFreeRam();
+    static void resetHardware();
+
+    // SPI related functions, there is no SPI bus on the host
+    static void spiBegin();
+    static void spiInit(uint8_t spiRate=6);
+    static uint8_t spiTransfer(uint8_t nbyte);
+    // Write single byte to SPI
+    static void spiSend(uint8_t nbyte);
+    static void spiSend(const uint8_t* buf, size_t nbyte);
+    static void spiSend(uint32_t chan, uint8_t nbyte);
+    static void spiSend(uint32_t chan ,const uint8_t* buf, size_t nbyte);
+    // Read single byte from SPI
+    static uint8_t spiReceive(void);
+    static uint8_t spiReceive(uint32_t chan);
+    // Read from SPI into buffer
+    static void spiReadBlock(uint8_t* buf, uint16_t nbyte);
+    // Write from buffer to SPI
+    static void spiSendBlock(uint8_t token, const uint8_t* buf);
+
+};
+
+/**
+ * Public functions
+ */
+
+// Disable interrupts
+void cli(void);
+
+// Enable interrupts
+void sei(void);
+
+// Tone
+void tone(const pin_t _pin, const uint16_t frequency, const uint16_t duration=0);
+void noTone(const pin_t _pin);
+
+// EEPROM
+uint8_t eeprom_read_byte(uint8_t* pos);
+void eeprom_read_block(void* pos, const void* eeprom_address, size_t n);
+void eeprom_write_byte(uint8_t* pos, uint8_t value);
+void eeprom_update_block(const void* pos, void* eeprom_address, size_t n);
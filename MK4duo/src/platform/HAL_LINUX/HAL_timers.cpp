@@ -0,0 +1,268 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * This is the main Hardware Abstraction Layer (HAL).
+ * To make the firmware work with different processors and toolchains,
+ * all hardware related code should be packed into the hal files.
+ *
+ * Description: HAL timers for Linux native build
+ *
+ * A dedicated thread plays the role of the interrupt controller: it fires
+ * every enabled timer when its counter reaches the compare value and runs
+ * the 1ms system tick. ISRs and critical sections of the main thread are
+ * serialized by a single mutex, so DISABLE_ISRS() really holds off the
+ * timer interrupts like on the MCU.
+ *
+ * The simulated clock can run faster than the host clock (--speed): the
+ * machine moves K times faster while the firmware code runs at host speed,
+ * like on a MCU K times slower than the host.
+ *
+ * __PLAT_LINUX__
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(__PLAT_LINUX__)
+
+// --------------------------------------------------------------------------
+// Includes
+// --------------------------------------------------------------------------
+
+#include "HAL_timers.h"
+#include "simulator.h"
+#include <time.h>
+#include <pthread.h>
+
+// --------------------------------------------------------------------------
+// Local defines
+// --------------------------------------------------------------------------
+
+#define SYSTICK_NS        1000000ULL  // 1ms system tick
+#define MAX_LATENCY_NS   10000000ULL  // Resync a timer if it is late more than this
+#define SPIN_WINDOW_NS     200000ULL  // Busy wait for the last part of the wait
+
+// --------------------------------------------------------------------------
+// Function prototypes
+// --------------------------------------------------------------------------
+
+STEPPER_TIMER_ISR();
+HAL_TONE_TIMER_ISR();
+
+// --------------------------------------------------------------------------
+// Public Variables
+// --------------------------------------------------------------------------
+
+tTimerConfig TimerConfig [NUM_HARDWARE_TIMERS] = {
+  { HAL_stepper_timer_isr,  false, false, 0, 0 }, // 0 - Stepper
+  { HAL_tone_timer_isr,     false, false, 0, 0 }  // 1 - Tone
+};
+
+uint32_t  HAL_min_pulse_cycle     = 0,
+          HAL_min_pulse_tick      = 0,
+          HAL_add_pulse_ticks     = 0,
+          HAL_frequency_limit[8]  = { 0 };
+
+// --------------------------------------------------------------------------
+// Private Variables
+// --------------------------------------------------------------------------
+
+static uint32_t         timer_speed   = 1;
+static uint64_t         timer_origin  = 0;
+
+static pthread_mutex_t  isr_mutex = PTHREAD_MUTEX_INITIALIZER;
+static __thread bool    isr_context   = false,
+                        isrs_disabled = false;
+
+// --------------------------------------------------------------------------
+// Private functions
+// --------------------------------------------------------------------------
+
+static void run_isr(void (*isr)(void)) {
+  pthread_mutex_lock(&isr_mutex);
+  isr_context = true;
+  isr();
+  isr_context = false;
+  pthread_mutex_unlock(&isr_mutex);
+}
+
+static void wait_until(const uint64_t deadline) {
+  const uint64_t now = HAL_timer_ns();
+  if (deadline > now + SPIN_WINDOW_NS) {
+    const uint64_t ns = (deadline - now - SPIN_WINDOW_NS / 2) / timer_speed;
+    const struct timespec ts = { time_t(ns / 1000000000ULL), long(ns % 1000000000ULL) };
+    nanosleep(&ts, NULL);
+  }
+  while (HAL_timer_ns() < deadline) { /* nada */ }
+}
+
+static void* timer_thread(void*) {
+
+  uint64_t next_tick = HAL_timer_ns() + SYSTICK_NS;
+
+  for (;;) {
+
+    uint64_t now = HAL_timer_ns(),
+             next_event = now + SYSTICK_NS;
+
+    for (uint8_t t = 0; t < NUM_HARDWARE_TIMERS; t++) {
+      tTimerConfig &tc = TimerConfig[t];
+      if (!tc.running) continue;
+
+      uint64_t deadline = tc.start_ns + uint64_t(tc.compare) * (HAL_TIMER_NS_PER_TICK);
+      if (now >= deadline) {
+        // Reset the counter on compare match, like WAVSEL_UP_RC
+        tc.start_ns = (now - deadline > MAX_LATENCY_NS) ? now : deadline;
+        if (tc.enabled && tc.isr) run_isr(tc.isr);
+        now = HAL_timer_ns();
+        deadline = tc.start_ns + uint64_t(tc.compare) * (HAL_TIMER_NS_PER_TICK);
+      }
+      NOMORE(next_event, deadline);
+    }
+
+    if (now >= next_tick) {
+      next_tick = (now - next_tick > MAX_LATENCY_NS) ? now + SYSTICK_NS : next_tick + SYSTICK_NS;
+      run_isr(HAL::Tick);
+    }
+    NOMORE(next_event, next_tick);
+
+    wait_until(next_event);
+  }
+
+  return NULL;
+}
+
+// --------------------------------------------------------------------------
+// Public functions
+// --------------------------------------------------------------------------
+
+uint64_t HAL_timer_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  const uint64_t ns = uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+  return timer_speed == 1 ? ns : timer_origin + (ns - timer_origin) * timer_speed;
+}
+
+/**
+ * Run the simulated clock speed times faster than the host clock.
+ * Call it before starting the timer thread.
+ */
+void HAL_timer_set_speed(const uint32_t speed) {
+  timer_origin = HAL_timer_ns();
+  timer_speed  = speed ? speed : 1;
+}
+
+uint32_t HAL_timer_get_speed() { return timer_speed; }
+
+void HAL_timer_thread_start() {
+  pthread_t thread;
+  pthread_create(&thread, NULL, timer_thread, NULL);
+  pthread_detach(thread);
+}
+
+/**
+ * Interrupt emulation
+ */
+bool HAL_isrs_enabled() { return !isr_context && !isrs_disabled; }
+
+void HAL_disable_isrs() {
+  if (isr_context || isrs_disabled) return;
+  pthread_mutex_lock(&isr_mutex);
+  isrs_disabled = true;
+}
+
+void HAL_enable_isrs() {
+  if (isr_context || !isrs_disabled) return;
+  isrs_disabled = false;
+  pthread_mutex_unlock(&isr_mutex);
+}
+
+void HAL_timer_start(const uint8_t timer_num, const uint32_t frequency) {
+  tTimerConfig &tc = TimerConfig[timer_num];
+  tc.enabled  = false;
+  tc.compare  = HAL_TIMER_RATE / frequency;
+  tc.start_ns = HAL_timer_ns();
+  tc.running  = true;
+  tc.enabled  = true;
+}
+
+uint32_t HAL_isr_execuiton_cycle(const uint32_t rate) {
+  return (ISR_BASE_CYCLES + ISR_BEZIER_CYCLES + (ISR_LOOP_CYCLES) * rate + ISR_LA_BASE_CYCLES + ISR_LA_LOOP_CYCLES) / rate;
+}
+
+void HAL_calc_pulse_cycle() {
+  HAL_min_pulse_cycle   = MAX((uint32_t)((F_CPU) / stepper.maximum_rate), ((F_CPU) / 500000UL) * (uint32_t)stepper.minimum_pulse);
+  HAL_min_pulse_tick    = ((uint32_t)stepper.minimum_pulse * (STEPPER_TIMER_TICKS_PER_US)) + ((MIN_ISR_START_LOOP_CYCLES) / (uint32_t)(PULSE_TIMER_PRESCALE));
+  HAL_add_pulse_ticks   = (HAL_min_pulse_cycle / (PULSE_TIMER_PRESCALE)) - HAL_min_pulse_tick;
+
+  // The stepping frequency limits for each multistepping rate
+  HAL_frequency_limit[0] = ((F_CPU) / HAL_isr_execuiton_cycle(1))       ;
+  HAL_frequency_limit[1] = ((F_CPU) / HAL_isr_execuiton_cycle(2))   >> 1;
+  HAL_frequency_limit[2] = ((F_CPU) / HAL_isr_execuiton_cycle(4))   >> 2;
+  HAL_frequency_limit[3] = ((F_CPU) / HAL_isr_execuiton_cycle(8))   >> 3;
+  HAL_frequency_limit[4] = ((F_CPU) / HAL_isr_execuiton_cycle(16))  >> 4;
+  HAL_frequency_limit[5] = ((F_CPU) / HAL_isr_execuiton_cycle(32))  >> 5;
+  HAL_frequency_limit[6] = ((F_CPU) / HAL_isr_execuiton_cycle(64))  >> 6;
+  HAL_frequency_limit[7] = ((F_CPU) / HAL_isr_execuiton_cycle(128)) >> 7;
+}
+
+uint32_t HAL_calc_timer_interval(uint32_t step_rate, uint8_t* loops, uint8_t scale) {
+
+  uint8_t multistep = 1;
+
+  // Scale the frequency, as requested by the caller
+  step_rate <<= scale;
+
+  #if DISABLED(DISABLE_DOUBLE_QUAD_STEPPING)
+    // Select the proper multistepping
+    uint8_t idx = 0;
+    while (idx < 7 && step_rate > HAL_frequency_limit[idx]) {
+      step_rate >>= 1;
+      multistep <<= 1;
+      ++idx;
+    };
+  #else
+    NOMORE(step_rate, HAL_frequency_limit[0]);
+  #endif
+
+  *loops = multistep;
+
+  return uint32_t(STEPPER_TIMER_RATE) / step_rate;
+
+}
+
+/**
+ * Interrupt Service Routines
+ */
+STEPPER_TIMER_ISR() {
+
+  HAL_timer_isr_prologue(STEPPER_TIMER);
+
+  // Call the Step
+  stepper.Step();
+
+  // Let the simulated machine react to the new steps
+  simulator.update_endstops();
+
+}
+
+#endif // __PLAT_LINUX__
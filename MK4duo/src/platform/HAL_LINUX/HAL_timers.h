@@ -0,0 +1,223 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Description: HAL timers for Linux native build
+ *
+ * Every hardware timer is an up-counter that resets on compare match,
+ * like the SAM3X8E TC in WAVSEL_UP_RC mode. The counters are derived from
+ * the monotonic clock and a dedicated thread fires the compare interrupts.
+ *
+ * __PLAT_LINUX__
+ */
+#pragma once
+
+// --------------------------------------------------------------------------
+// Includes
+// --------------------------------------------------------------------------
+#include <stdint.h>
+
+// --------------------------------------------------------------------------
+// Defines
+// --------------------------------------------------------------------------
+#define NUM_HARDWARE_TIMERS 2
+
+#define HAL_TIMER_RATE              ((F_CPU) / 10) // 10 MHz
+#define HAL_ACCELERATION_RATE       (4096.0 * 4096.0 * 256.0 / (HAL_TIMER_RATE))
+#define HAL_TIMER_NS_PER_TICK       (1000000000UL / (HAL_TIMER_RATE))
+
+#define STEPPER_TIMER               0
+#define STEPPER_TIMER_ISR()         void HAL_stepper_timer_isr()
+#define STEPPER_TIMER_RATE          HAL_TIMER_RATE
+#define STEPPER_TIMER_TICKS_PER_US  ((STEPPER_TIMER_RATE) / 1000000)                          // 10 - stepper timer ticks per µs
+#define STEPPER_TIMER_PRESCALE      ((F_CPU / 1000000UL) / STEPPER_TIMER_TICKS_PER_US)         // 10
+#define STEPPER_TIMER_MIN_INTERVAL  1                                                         // minimum time in µs between stepper interrupts
+#define STEPPER_TIMER_MAX_INTERVAL  (STEPPER_TIMER_TICKS_PER_US * STEPPER_TIMER_MIN_INTERVAL) // maximum time in µs between stepper interrupts
+#define STEPPER_CLOCK_RATE          ((F_CPU) / 128)                                           // frequency of the clock used for stepper pulse timing
+#define PULSE_TIMER_PRESCALE        STEPPER_TIMER_PRESCALE
+
+#define ENABLE_STEPPER_INTERRUPT()  HAL_timer_enable_interrupt(STEPPER_TIMER)
+#define DISABLE_STEPPER_INTERRUPT() HAL_timer_disable_interrupt(STEPPER_TIMER)
+#define STEPPER_ISR_ENABLED()       HAL_timer_interrupt_is_enabled(STEPPER_TIMER)
+
+// Estimate the amount of time the ISR will take to execute
+// The base ISR takes 792 cycles
+#define ISR_BASE_CYCLES               792UL
+
+// Linear advance base time is 64 cycles
+#if ENABLED(LIN_ADVANCE)
+  #define ISR_LA_BASE_CYCLES          64UL
+#else
+  #define ISR_LA_BASE_CYCLES          0UL
+#endif
+
+// Bezier interpolation adds 40 cycles
+#if ENABLED(BEZIER_JERK_CONTROL)
+  #define ISR_BEZIER_CYCLES           40UL
+#else
+  #define ISR_BEZIER_CYCLES           0UL
+#endif
+
+// Stepper Loop base cycles
+#define ISR_LOOP_BASE_CYCLES          4UL
+
+// To start the step pulse, in the worst case takes
+#define ISR_START_STEPPER_CYCLES      13UL
+
+// And each stepper (start + stop pulse) takes in worst case
+#define ISR_STEPPER_CYCLES            16UL
+
+// For each stepper, we add its time
+#if HAS_X_STEP
+  #define ISR_START_X_STEPPER_CYCLES  ISR_START_STEPPER_CYCLES
+  #define ISR_X_STEPPER_CYCLES        ISR_STEPPER_CYCLES
+#else
+  #define ISR_START_X_STEPPER_CYCLES  0UL
+  #define ISR_X_STEPPER_CYCLES        0UL
+#endif
+#if HAS_Y_STEP
+  #define ISR_START_Y_STEPPER_CYCLES  ISR_START_STEPPER_CYCLES
+  #define ISR_Y_STEPPER_CYCLES        ISR_STEPPER_CYCLES
+#else
+  #define ISR_START_Y_STEPPER_CYCLES  0UL
+  #define ISR_Y_STEPPER_CYCLES        0UL
+#endif
+#if HAS_Z_STEP
+  #define ISR_START_Z_STEPPER_CYCLES  ISR_START_STEPPER_CYCLES
+  #define ISR_Z_STEPPER_CYCLES        ISR_STEPPER_CYCLES
+#else
+  #define ISR_START_Z_STEPPER_CYCLES  0UL
+  #define ISR_Z_STEPPER_CYCLES        0UL
+#endif
+
+// E is always interpolated
+#define ISR_START_E_STEPPER_CYCLES    ISR_START_STEPPER_CYCLES
+#define ISR_E_STEPPER_CYCLES          ISR_STEPPER_CYCLES
+
+// If linear advance is disabled, then the loop also handles them
+#if DISABLED(LIN_ADVANCE) && ENABLED(COLOR_MIXING_EXTRUDER)
+  #define ISR_START_MIXING_STEPPER_CYCLES ((MIXING_STEPPERS) * 13UL)
+  #define ISR_MIXING_STEPPER_CYCLES       ((MIXING_STEPPERS) * 16UL)
+#else
+  #define ISR_START_MIXING_STEPPER_CYCLES 0UL
+  #define ISR_MIXING_STEPPER_CYCLES       0UL
+#endif
+
+// Calculate the minimum time to start all stepper pulses in the ISR loop
+#define MIN_ISR_START_LOOP_CYCLES     (ISR_START_X_STEPPER_CYCLES + ISR_START_Y_STEPPER_CYCLES + ISR_START_Z_STEPPER_CYCLES + ISR_START_E_STEPPER_CYCLES + ISR_START_MIXING_STEPPER_CYCLES)
+
+// And the total minimum loop time is, without including the base
+#define MIN_ISR_LOOP_CYCLES           (ISR_X_STEPPER_CYCLES + ISR_Y_STEPPER_CYCLES + ISR_Z_STEPPER_CYCLES + ISR_E_STEPPER_CYCLES + ISR_MIXING_STEPPER_CYCLES)
+
+// But the user could be enforcing a minimum time, so the loop time is
+#define ISR_LOOP_CYCLES               (ISR_LOOP_BASE_CYCLES + MAX(HAL_min_pulse_cycle, MIN_ISR_LOOP_CYCLES))
+
+// If linear advance is enabled, then it is handled separately
+#if ENABLED(LIN_ADVANCE)
+
+  // Estimate the minimum LA loop time
+  #if ENABLED(COLOR_MIXING_EXTRUDER)
+    #define MIN_ISR_LA_LOOP_CYCLES  ((MIXING_STEPPERS) * 16UL)
+  #else
+    #define MIN_ISR_LA_LOOP_CYCLES  16UL
+  #endif
+
+  // And the real loop time
+  #define ISR_LA_LOOP_CYCLES  MAX(HAL_min_pulse_cycle, MIN_ISR_LA_LOOP_CYCLES)
+
+#else
+  #define ISR_LA_LOOP_CYCLES  0UL
+#endif// Tone
+#define TONE_TIMER_NUM              1
+#define HAL_TONE_TIMER_ISR()        void HAL_tone_timer_isr()
+
+
+// --------------------------------------------------------------------------
+// Types
+// --------------------------------------------------------------------------
+
+typedef struct {
+  void                (*isr)(void);
+  volatile bool       enabled;
+  volatile bool       running;
+  volatile uint64_t   start_ns;   // Time of the last counter reset
+  volatile uint32_t   compare;    // Compare value, in timer ticks
+} tTimerConfig;
+
+// --------------------------------------------------------------------------
+// Public Variables
+// --------------------------------------------------------------------------
+
+extern tTimerConfig TimerConfig[];
+
+extern uint32_t HAL_min_pulse_cycle,
+                HAL_min_pulse_tick,
+                HAL_add_pulse_ticks,
+                HAL_frequency_limit[8];
+
+// --------------------------------------------------------------------------
+// Public functions
+// --------------------------------------------------------------------------
+
+uint64_t HAL_timer_ns();
+
+void HAL_timer_set_speed(const uint32_t speed);
+uint32_t HAL_timer_get_speed();
+
+void HAL_timer_thread_start();
+
+void HAL_timer_start(const uint8_t timer_num, const uint32_t frequency);
+
+void HAL_calc_pulse_cycle();
+
+uint32_t HAL_calc_timer_interval(uint32_t step_rate, uint8_t* loops, uint8_t scale);
+
+FORCE_INLINE static void HAL_timer_enable_interrupt(const uint8_t timer_num) {
+  TimerConfig[timer_num].enabled = true;
+}
+
+FORCE_INLINE static void HAL_timer_disable_interrupt(const uint8_t timer_num) {
+  TimerConfig[timer_num].enabled = false;
+}
+
+FORCE_INLINE static bool HAL_timer_interrupt_is_enabled(const uint8_t timer_num) {
+  return TimerConfig[timer_num].enabled;
+}
+
+FORCE_INLINE static uint32_t HAL_timer_get_count(const uint8_t timer_num) {
+  return TimerConfig[timer_num].compare;
+}
+
+FORCE_INLINE static void HAL_timer_set_count(const uint8_t timer_num, const uint32_t count) {
+  TimerConfig[timer_num].compare = count;
+}
+
+FORCE_INLINE static uint32_t HAL_timer_get_current_count(const uint8_t timer_num) {
+  return uint32_t((HAL_timer_ns() - TimerConfig[timer_num].start_ns) / (HAL_TIMER_NS_PER_TICK));
+}
+
+FORCE_INLINE static void HAL_timer_restricts(const uint8_t timer_num, const uint16_t interval_ticks) {
+  const uint32_t mincmp = HAL_timer_get_current_count(timer_num) + interval_ticks;
+  if (HAL_timer_get_count(timer_num) < mincmp) HAL_timer_set_count(timer_num, mincmp);
+}
+
+FORCE_INLINE static void HAL_timer_isr_prologue(const uint8_t timer_num) { UNUSED(timer_num); }
@@ -0,0 +1,141 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Description: Serial port for Linux native build
+ *
+ * __PLAT_LINUX__
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(__PLAT_LINUX__)
+
+#include <unistd.h>
+#include <pthread.h>
+
+// Public Variables
+MKHardwareSerial MKSerial;
+
+MKHardwareSerial::ring_buffer_r MKHardwareSerial::rx_buffer = { { 0 }, 0, 0 };
+
+uint8_t   MKHardwareSerial::rx_dropped_bytes  = 0;
+uint16_t  MKHardwareSerial::rx_max_enqueued   = 0;
+
+volatile bool MKHardwareSerial::rx_eof = false;
+
+bool              MKHardwareSerial::rx_wait_ok  = false;
+volatile uint32_t MKHardwareSerial::tx_ok_count = 0;
+
+void* MKHardwareSerial::reader_thread(void*) {
+  unsigned char c;
+  uint32_t lines_sent = 0;
+  bool line_start = true, skip_line = false;
+  while (::read(STDIN_FILENO, &c, 1) == 1) {
+
+    if (rx_wait_ok) {
+      if (line_start) {
+        if (c == ' ' || c == '\t') continue;
+        line_start = false;
+        skip_line = (c == '\n' || c == '\r' || c == ';');
+        // The host waits for the ok of the line before
+        if (!skip_line) {
+          while (tx_ok_count < lines_sent) usleep(10);
+          lines_sent++;
+        }
+      }
+      if (c == '\n') line_start = true;
+      if (skip_line) continue;
+    }
+
+    const uint16_t h = rx_buffer.head,
+                   i = (uint16_t)(h + 1) & (RX_BUFFER_SIZE - 1);
+
+    // Wait for room, a host can always wait
+    while (i == rx_buffer.tail) usleep(100);
+
+    rx_buffer.buffer[h] = c;
+    rx_buffer.head = i;
+
+    #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+      const uint16_t rx_count = (uint16_t)(i - rx_buffer.tail) & (RX_BUFFER_SIZE - 1);
+      NOLESS(rx_max_enqueued, rx_count);
+    #endif
+  }
+  rx_eof = true;
+  return NULL;
+}
+
+// Public Methods
+void MKHardwareSerial::begin(const long) {
+  static bool started = false;
+  if (started) return;
+  started = true;
+  pthread_t thread;
+  pthread_create(&thread, NULL, reader_thread, NULL);
+  pthread_detach(thread);
+}
+
+void MKHardwareSerial::end() { flushTX(); }
+
+int MKHardwareSerial::peek() {
+  const int v = rx_buffer.head == rx_buffer.tail ? -1 : rx_buffer.buffer[rx_buffer.tail];
+  return v;
+}
+
+int MKHardwareSerial::read() {
+  const uint16_t t = rx_buffer.tail;
+  if (rx_buffer.head == t) return -1;
+  const int v = rx_buffer.buffer[t];
+  rx_buffer.tail = (uint16_t)(t + 1) & (RX_BUFFER_SIZE - 1);
+  return v;
+}
+
+uint16_t MKHardwareSerial::available() {
+  const uint16_t h = rx_buffer.head, t = rx_buffer.tail;
+  return (uint16_t)(RX_BUFFER_SIZE + h - t) & (RX_BUFFER_SIZE - 1);
+}
+
+void MKHardwareSerial::flush() {
+  rx_buffer.tail = rx_buffer.head;
+}
+
+void MKHardwareSerial::write(const uint8_t c) {
+  static uint8_t col = 0;
+  static char first[2];
+  putchar(c);
+  if (c == '\n') {
+    fflush(stdout);
+    if (col >= 2 && first[0] == 'o' && first[1] == 'k') tx_ok_count++;
+    col = 0;
+  }
+  else {
+    if (col < 2) first[col] = c;
+    if (col < 255) col++;
+  }
+}
+
+void MKHardwareSerial::flushTX() {
+  fflush(stdout);
+}
+
+#endif // __PLAT_LINUX__
@@ -0,0 +1,95 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Description: Serial port for Linux native build
+ *
+ * Port 0 is the process stdin / stdout. A reader thread plays the role of
+ * the UART RX interrupt and blocks while the RX buffer is full, so a G-code
+ * file piped to stdin is never dropped.
+ * With wait_ok it sends one line at a time and waits for its "ok", like a
+ * host streaming over USB. Empty and comment lines are not sent.
+ *
+ * __PLAT_LINUX__
+ */
+
+#ifndef RX_BUFFER_SIZE
+  #define RX_BUFFER_SIZE 128
+#endif
+
+class MKHardwareSerial {
+
+  public: /** Constructor */
+
+    MKHardwareSerial() {}
+
+  protected: /** Protected Parameters */
+
+    struct ring_buffer_r {
+      unsigned char buffer[RX_BUFFER_SIZE];
+      volatile uint16_t head, tail;
+    };
+
+    static ring_buffer_r rx_buffer;
+
+    static uint8_t  rx_dropped_bytes;
+    static uint16_t rx_max_enqueued;
+
+    static volatile bool rx_eof;
+
+    static bool rx_wait_ok;
+    static volatile uint32_t tx_ok_count;
+
+  protected: /** Protected Function */
+
+    static void* reader_thread(void*);
+
+  public: /** Public Function */
+
+    static void begin(const long);
+    static void end();
+    static int peek(void);
+    static int read(void);
+    static void flush(void);
+    static uint16_t available(void);
+    static void write(const uint8_t c);
+    static void flushTX(void);
+
+    // The reader reached the end of stdin
+    FORCE_INLINE static bool eof() { return rx_eof; }
+
+    // Send a line only after the "ok" of the one before, call before begin()
+    FORCE_INLINE static void wait_ok(const bool onoff) { rx_wait_ok = onoff; }
+    FORCE_INLINE static bool waits_ok() { return rx_wait_ok; }
+
+    #if ENABLED(SERIAL_STATS_DROPPED_RX)
+      FORCE_INLINE static uint32_t dropped() { return rx_dropped_bytes; }
+    #endif
+
+    #if ENABLED(SERIAL_STATS_MAX_RX_QUEUED)
+      FORCE_INLINE static uint16_t rxMaxEnqueued() { return rx_max_enqueued; }
+    #endif
+
+};
+
+extern MKHardwareSerial MKSerial;
@@ -0,0 +1,457 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Description: Planner benchmark for Linux native build
+ *
+ * __PLAT_LINUX__
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(__PLAT_LINUX__)
+
+#include "benchmark.h"
+#include "sdcard_image.h"
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------------------
+// Local defines
+// --------------------------------------------------------------------------
+
+#define MONITOR_POLL_US   1000  // Host time between two checks
+#define MONITOR_IDLE_POLL   10  // Checks in a row with nothing left to do
+#define PARSER_BENCH_NS    2e9  // Host time for each parser loop
+#define SD_BENCH_SPI_HZ    8e6  // SPI clock of the card for the transfer rate
+#define KINEMATICS_BENCH_NS 2e9 // Host time for each kinematics loop
+#define KINEMATICS_BATCHES   4  // Batches of points in each line
+
+Benchmark benchmark;
+
+// --------------------------------------------------------------------------
+// Private Variables
+// --------------------------------------------------------------------------
+
+const char* Benchmark::file           = NULL;
+const char* Benchmark::parser_file    = NULL;
+const char* Benchmark::sd_file        = NULL;
+uint32_t    Benchmark::kinematics_lines = 0;
+uint64_t    Benchmark::host_start_ns  = 0,
+            Benchmark::sim_start_ns   = 0;
+
+// --------------------------------------------------------------------------
+// Public functions
+// --------------------------------------------------------------------------
+
+/**
+ * Parse the command line:
+ *  --bench file  - Run the G-code file through the planner and report
+ *  --speed K     - Run the simulated clock K times faster than the host clock
+ *  --stream      - Send the file one line per ok, like a host does
+ *  --bench-parser file - Time the G-code number parser on the file and exit
+ *  --bench-sd file     - Time the reads of a file of the card and exit
+ *  --bench-kinematics N - Time the delta/SCARA transforms on N lines and exit
+ */
+void Benchmark::init(int argc, char** argv) {
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--stream"))
+      MKSerial.wait_ok(true);
+    else if (i == argc - 1)
+      break;
+    else if (!strcmp(argv[i], "--bench"))
+      file = argv[++i];
+    else if (!strcmp(argv[i], "--speed"))
+      HAL_timer_set_speed(strtoul(argv[++i], NULL, 10));
+    else if (!strcmp(argv[i], "--bench-parser"))
+      parser_file = argv[++i];
+    else if (!strcmp(argv[i], "--bench-sd"))
+      sd_file = argv[++i];
+    else if (!strcmp(argv[i], "--bench-kinematics"))
+      kinematics_lines = strtoul(argv[++i], NULL, 10);
+  }
+
+  if (parser_file) {
+    parser_bench();
+    exit(0);
+  }
+
+  if (kinematics_lines) {
+    #if !IS_KINEMATIC
+      fprintf(stderr, "--bench-kinematics needs a delta or SCARA machine\n");
+      exit(1);
+    #endif
+    return;
+  }
+
+  if (sd_file) {
+    #if DISABLED(SDSUPPORT)
+      fprintf(stderr, "--bench-sd needs SDSUPPORT enabled\n");
+      exit(1);
+    #endif
+    return;
+  }
+
+  if (!file) return;
+
+  #if DISABLED(PLANNER_STATS)
+    fprintf(stderr, "--bench needs PLANNER_STATS enabled\n");
+    exit(1);
+  #endif
+
+  if (!freopen(file, "r", stdin)) {
+    fprintf(stderr, "%s: %s\n", file, strerror(errno));
+    exit(1);
+  }
+
+}
+
+void Benchmark::start() {
+  #if IS_KINEMATIC
+    if (kinematics_lines) {
+      kinematics_bench();
+      exit(0);
+    }
+  #endif
+
+  #if ENABLED(SDSUPPORT)
+    if (sd_file) {
+      sd_bench();
+      exit(0);
+    }
+  #endif
+
+  #if ENABLED(PLANNER_STATS)
+    planner.reset_stats();
+  #endif
+  host_start_ns = host_ns();
+  sim_start_ns  = HAL_timer_ns();
+
+  pthread_t thread;
+  pthread_create(&thread, NULL, monitor_thread, NULL);
+  pthread_detach(thread);
+}
+
+// --------------------------------------------------------------------------
+// Private functions
+// --------------------------------------------------------------------------
+
+/**
+ * Printer::loop never returns, so the end of the run is detected here.
+ * A line can be between the serial and the command queue for a moment,
+ * so the firmware must look done for a few checks in a row.
+ */
+void* Benchmark::monitor_thread(void*) {
+  uint8_t idle_polls = 0;
+  while (idle_polls < MONITOR_IDLE_POLL) {
+    usleep(MONITOR_POLL_US);
+    idle_polls = finished() ? idle_polls + 1 : 0;
+  }
+  report();
+  MKSerial.flushTX();
+  _exit(0);
+  return NULL;
+}
+
+/**
+ * The whole file was read and processed and the moves are done
+ */
+bool Benchmark::finished() {
+  return MKSerial.eof() && !MKSerial.available()
+      && commands.buffer_ring.isEmpty()
+      && !planner.has_blocks_queued();
+}
+
+void Benchmark::report() {
+
+  const double  host_s  = (host_ns() - host_start_ns) * 1e-9,
+                sim_s   = (HAL_timer_ns() - sim_start_ns) * 1e-9;
+  const uint32_t speed  = HAL_timer_get_speed();
+
+  fprintf(stderr, "Benchmark      : %s%s\n", file, MKSerial.waits_ok() ? " (one line per ok)" : "");
+  fprintf(stderr, "Host time      : %.3f s\n", host_s);
+  fprintf(stderr, "Simulated time : %.3f s (speed x%u)\n", sim_s, (unsigned)speed);
+
+  #if ENABLED(PLANNER_STATS)
+    const planner_stats_t &stats = planner.stats;
+    const double avg_us = stats.recalculate_count ? double(stats.recalculate_us) / stats.recalculate_count : 0.0;
+    fprintf(stderr, "Blocks         : %lu (%.0f/s host, %.0f/s simulated)\n",
+      (unsigned long)stats.blocks, host_s > 0 ? stats.blocks / host_s : 0.0, sim_s > 0 ? stats.blocks / sim_s : 0.0);
+    fprintf(stderr, "Recalculate    : %lu calls, avg %.2f us, max %lu us (host avg %.3f us)\n",
+      (unsigned long)stats.recalculate_count, avg_us, (unsigned long)stats.recalculate_max_us, avg_us / speed);
+    fprintf(stderr, "Starved        : %lu blocks (%.1f%%), min planned %u\n",
+      (unsigned long)stats.starved, stats.blocks ? 100.0 * stats.starved / stats.blocks : 0.0,
+      stats.blocks ? stats.min_planned : 0);
+    #if ENABLED(SEGMENT_MERGING)
+      fprintf(stderr, "Merged         : %lu segments\n", (unsigned long)stats.merged);
+    #endif
+  #endif
+
+}
+
+/**
+ * Collect the values of all the parameters of the file the way the
+ * parser finds them (a letter followed by a valid number, comments
+ * removed), then convert them over and over with both scanners.
+ */
+void Benchmark::parser_bench() {
+
+  FILE * const f = fopen(parser_file, "r");
+  if (!f) {
+    fprintf(stderr, "%s: %s\n", parser_file, strerror(errno));
+    exit(1);
+  }
+
+  size_t size = 0, count = 0, capacity = 4096;
+  char* text = NULL;
+  size_t* offsets = (size_t*)malloc(capacity * sizeof(size_t));
+  char line[MAX_CMD_SIZE * 2];
+  size_t lines = 0;
+
+  // Copy the values in one buffer, one string each
+  while (fgets(line, sizeof(line), f)) {
+    char *p = strchr(line, ';');
+    if (p) *p = '\0';
+    bool first = true;
+    for (p = line; *p; p++) {
+      if (!WITHIN(*p, 'A', 'Z')) continue;
+      if (first) { first = false; continue; } // Skip G, M or T code
+      const char * const v = p + 1;
+      if (!GCodeParser::valid_float(v)) continue;
+      size_t len = 0;
+      while (v[len] && DECIMAL_SIGNED(v[len])) len++;
+      text = (char*)realloc(text, size + len + 1);
+      memcpy(text + size, v, len);
+      text[size + len] = '\0';
+      if (count == capacity) offsets = (size_t*)realloc(offsets, (capacity *= 2) * sizeof(size_t));
+      offsets[count++] = size;
+      size += len + 1;
+    }
+    lines++;
+  }
+  fclose(f);
+
+  if (!count) {
+    fprintf(stderr, "%s: no values\n", parser_file);
+    exit(1);
+  }
+  char** values = (char**)malloc(count * sizeof(char*));
+  for (size_t i = 0; i < count; i++) values[i] = text + offsets[i];
+  free(offsets);
+
+  // Same results?
+  size_t float_diff = 0, long_diff = 0;
+  for (size_t i = 0; i < count; i++) {
+    const float a = GCodeParser::parse_float(values[i]), b = strtof(values[i], NULL);
+    if (memcmp(&a, &b, sizeof(float))) {
+      if (float_diff++ < 5) fprintf(stderr, "Float mismatch : %s %.9g %.9g\n", values[i], a, b);
+    }
+    if (GCodeParser::parse_long(values[i]) != int32_t(strtol(values[i], NULL, 10))) long_diff++;
+  }
+
+  // Repeat the whole set for about PARSER_BENCH_NS in each loop
+  volatile float fsink = 0;
+  volatile int32_t lsink = 0;
+  double ns[4];
+  for (uint8_t t = 0; t < 4; t++) {
+    size_t loops = 0;
+    const uint64_t start = host_ns();
+    uint64_t now;
+    do {
+      switch (t) {
+        case 0: for (size_t i = 0; i < count; i++) fsink = GCodeParser::parse_float(values[i]); break;
+        case 1: for (size_t i = 0; i < count; i++) fsink = strtof(values[i], NULL); break;
+        case 2: for (size_t i = 0; i < count; i++) lsink = GCodeParser::parse_long(values[i]); break;
+        case 3: for (size_t i = 0; i < count; i++) lsink = strtol(values[i], NULL, 10); break;
+      }
+      loops++;
+      now = host_ns();
+    } while (now - start < PARSER_BENCH_NS);
+    ns[t] = double(now - start) / (double(loops) * count);
+  }
+  UNUSED(fsink); UNUSED(lsink);
+
+  fprintf(stderr, "Parser bench   : %s\n", parser_file);
+  fprintf(stderr, "Values         : %lu in %lu lines\n", (unsigned long)count, (unsigned long)lines);
+  fprintf(stderr, "parse_float    : %.1f ns/value, strtof %.1f ns/value (x%.1f)\n", ns[0], ns[1], ns[1] / ns[0]);
+  fprintf(stderr, "parse_long     : %.1f ns/value, strtol %.1f ns/value (x%.1f)\n", ns[2], ns[3], ns[3] / ns[2]);
+  fprintf(stderr, "Mismatches     : %lu float, %lu long\n", (unsigned long)float_diff, (unsigned long)long_diff);
+
+  free(values);
+  free(text);
+}
+
+#if IS_KINEMATIC
+
+  /**
+   * Random lines of the print area, each one cut in KINEMATICS_BATCHES
+   * batches of points. Both transforms must give the same machine position
+   * for every point, within the rounding of a float.
+   */
+  void Benchmark::kinematics_bench() {
+
+    const uint8_t   batch   = mechanics.TRANSFORM_BATCH,
+                    count   = KINEMATICS_BATCHES * batch;
+    const uint32_t  lines   = kinematics_lines,
+                    points  = lines * count;
+
+    #if MECH(DELTA)
+      const float cx = 0, cy = 0, radius = mechanics.data.print_radius;
+    #else
+      const float cx = SCARA_OFFSET_X, cy = SCARA_OFFSET_Y, radius = 0.9f * (mechanics.L1 + mechanics.L2);
+    #endif
+
+    float (*start)[XYZ]   = (float(*)[XYZ])malloc(lines * sizeof(*start)),
+          (*step)[XYZ]    = (float(*)[XYZ])malloc(lines * sizeof(*step)),
+          (*scalar)[ABC]  = (float(*)[ABC])malloc(points * sizeof(*scalar)),
+          (*batched)[ABC] = (float(*)[ABC])malloc(points * sizeof(*batched));
+
+    srand48(1);
+    for (uint32_t l = 0; l < lines; l++) {
+      float end[XYZ];
+      for (uint8_t p = 0; p < 2; p++) {
+        float * const v = p ? end : start[l];
+        const float r = radius * SQRT(drand48()), a = 2.0f * M_PI * drand48();
+        v[X_AXIS] = cx + r * COS(a);
+        v[Y_AXIS] = cy + r * SIN(a);
+        v[Z_AXIS] = 50.0f * drand48();
+      }
+      LOOP_XYZ(i) step[l][i] = (end[i] - start[l][i]) / count;
+    }
+
+    // Repeat all the lines for about KINEMATICS_BENCH_NS in each loop
+    double ns[2];
+    for (uint8_t t = 0; t < 2; t++) {
+      size_t loops = 0;
+      const uint64_t bench_start = host_ns();
+      uint64_t now;
+      do {
+        uint32_t k = 0;
+        for (uint32_t l = 0; l < lines; l++) {
+          if (t == 0) {
+            for (uint8_t n = 0; n < count; n++) {
+              float raw[XYZ];
+              LOOP_XYZ(i) raw[i] = start[l][i] + n * step[l][i];
+              mechanics.Transform(raw);
+              COPY_ARRAY(scalar[k++], mechanics.delta);
+            }
+          }
+          else {
+            for (uint8_t n = 0; n < count; n += batch) {
+              float first[XYZ];
+              LOOP_XYZ(i) first[i] = start[l][i] + n * step[l][i];
+              mechanics.Transform_line(first, step[l], batch, batched + k);
+              k += batch;
+            }
+          }
+        }
+        loops++;
+        now = host_ns();
+      } while (now - bench_start < KINEMATICS_BENCH_NS);
+      ns[t] = double(now - bench_start) / (double(loops) * points);
+    }
+
+    // Points out of reach give NaN both ways
+    float max_diff[ABC] = { 0 };
+    uint32_t unreachable = 0;
+    for (uint32_t k = 0; k < points; k++) {
+      if (isnan(scalar[k][A_AXIS]) || isnan(scalar[k][B_AXIS])) { unreachable++; continue; }
+      LOOP_ABC(i) NOLESS(max_diff[i], ABS(batched[k][i] - scalar[k][i]));
+    }
+
+    fprintf(stderr, "Kinematics     : %lu lines, %lu points, batch %u\n", (unsigned long)lines, (unsigned long)points, batch);
+    fprintf(stderr, "Transform      : %.1f ns/point\n", ns[0]);
+    fprintf(stderr, "Transform_line : %.1f ns/point (x%.2f)\n", ns[1], ns[0] / ns[1]);
+    fprintf(stderr, "Max difference : A %.6f B %.6f C %.6f (%.3f steps)\n",
+      max_diff[A_AXIS], max_diff[B_AXIS], max_diff[C_AXIS],
+      MAX(max_diff[A_AXIS] * mechanics.data.axis_steps_per_mm[A_AXIS],
+      MAX(max_diff[B_AXIS] * mechanics.data.axis_steps_per_mm[B_AXIS],
+          max_diff[C_AXIS] * mechanics.data.axis_steps_per_mm[C_AXIS]))
+    );
+    if (unreachable) fprintf(stderr, "Unreachable    : %lu points\n", (unsigned long)unreachable);
+
+    free(start);
+    free(step);
+    free(scalar);
+    free(batched);
+  }
+
+#endif // IS_KINEMATIC
+
+#if ENABLED(SDSUPPORT)
+
+  void Benchmark::sd_bench() {
+    if (!card.isDetected()) card.mount();
+    if (!card.isDetected()) {
+      fprintf(stderr, "--bench-sd needs a card, use --sdcard card.img\n");
+      exit(1);
+    }
+    fprintf(stderr, "SD bench       : %s, SPI at %.0f MHz\n", sd_file, SD_BENCH_SPI_HZ * 1e-6);
+    sd_bench_pass(false);
+    #if ENABLED(SD_STREAM_READ)
+      sd_bench_pass(true);
+    #endif
+  }
+
+  /**
+   * Every SPI byte takes 8 clocks, the time the MCU needs to handle the
+   * data is not counted, so the rate is the best the bus can do.
+   */
+  void Benchmark::sd_bench_pass(const bool stream) {
+    if (!card.selectFile(sd_file, true)) {
+      fprintf(stderr, "%s: not found on the card\n", sd_file);
+      exit(1);
+    }
+
+    #if ENABLED(SD_STREAM_READ)
+      card.setSDprinting(stream);
+    #endif
+    sdcard_image.reset_stats();
+    const uint64_t start = host_ns();
+    uint32_t size = 0;
+    while (card.get() >= 0) size++;
+    const double host_s = (host_ns() - start) * 1e-9;
+    card.setSDprinting(false);
+    card.closeFile();
+
+    const sdcard_image_stats_t &stats = sdcard_image.stats;
+    const double spi_s = stats.bytes * 8.0 / SD_BENCH_SPI_HZ;
+    fprintf(stderr, "%-15s: %lu bytes, %lu commands, %lu blocks, %lu SPI bytes (%.3f per byte)\n",
+      stream ? "Stream" : "Block", (unsigned long)size, (unsigned long)stats.commands,
+      (unsigned long)stats.blocks_read, (unsigned long)stats.bytes, size ? double(stats.bytes) / size : 0.0);
+    fprintf(stderr, "%-15s: %.0f KB/s on the bus, host %.0f KB/s\n",
+      "", spi_s > 0 ? size / spi_s / 1024 : 0.0, host_s > 0 ? size / host_s / 1024 : 0.0);
+  }
+
+#endif // SDSUPPORT
+
+// The host clock, not scaled by the simulated clock speed
+uint64_t Benchmark::host_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif // __PLAT_LINUX__
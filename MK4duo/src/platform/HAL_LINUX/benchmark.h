@@ -0,0 +1,101 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Description: Planner benchmark for Linux native build
+ *
+ *   mk4duo --bench file.gcode [--speed K] [--stream] > /dev/null
+ *
+ * The G-code file is fed to the serial port and goes through the normal
+ * path: Commands::process_parsed, Planner::buffer_line, fill_block and
+ * recalculate, while the Stepper ISR drains the blocks in simulated time.
+ * With --speed K the simulated clock runs K times faster than the host
+ * clock, that is the planner runs like on a MCU K times slower than the
+ * host. A monitor thread waits for the file to be done and the moves to be
+ * finished, then prints the PLANNER_STATS counters on stderr and exits.
+ * With --stream the next line is sent only after the ok of the one
+ * before, so the command queue is empty between the lines as with a host.
+ *
+ *   mk4duo --bench-parser file.gcode
+ *
+ * Times GCodeParser::parse_float/parse_long against strtof/strtol on every
+ * parameter value of the file, checks that they give the same results,
+ * prints the report on stderr and exits without starting the firmware.
+ *
+ *   mk4duo --sdcard card.img --bench-sd FILE.GCO
+ *
+ * Reads the file of the card image to the end with SDCard::get(), like a
+ * print does, first with one read command for each block, then with
+ * SD_STREAM_READ if enabled. The bytes on the SPI bus give the transfer
+ * rate at SD_BENCH_SPI_HZ.
+ *
+ *   mk4duo --bench-kinematics N
+ *
+ * Delta and SCARA only. Cuts N random lines of the print area in points
+ * and takes them to machine space with Transform one point at a time and
+ * with Transform_line TRANSFORM_BATCH points at a time, prints the time
+ * of each point and the largest difference between the two, then exits.
+ *
+ * __PLAT_LINUX__
+ */
+
+class Benchmark {
+
+  public: /** Constructor */
+
+    Benchmark() {}
+
+  private: /** Private Parameters */
+
+    static const char* file;
+    static const char* parser_file;
+    static const char* sd_file;
+    static uint32_t kinematics_lines;
+    static uint64_t host_start_ns,
+                    sim_start_ns;
+
+  public: /** Public Function */
+
+    static void init(int argc, char** argv);
+    static void start();
+
+    FORCE_INLINE static bool active() { return file != NULL || sd_file != NULL || kinematics_lines; }
+
+  private: /** Private Function */
+
+    static void* monitor_thread(void*);
+    static bool finished();
+    static void report();
+    static void parser_bench();
+    #if IS_KINEMATIC
+      static void kinematics_bench();
+    #endif
+    #if ENABLED(SDSUPPORT)
+      static void sd_bench();
+      static void sd_bench_pass(const bool stream);
+    #endif
+    static uint64_t host_ns();
+
+};
+
+extern Benchmark benchmark;
@@ -0,0 +1,91 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Description: EEPROM emulation for Linux native build
+ *
+ * The EEPROM image is kept in RAM and saved to EEPROM_FILE on flush.
+ *
+ * __PLAT_LINUX__
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(__PLAT_LINUX__) && HAS_EEPROM && !HAS_EEPROM_I2C && !HAS_EEPROM_SPI && !HAS_EEPROM_SD
+
+#ifndef EEPROM_FILE
+  #define EEPROM_FILE "eeprom.bin"
+#endif
+
+static uint8_t  eeprom_image[EEPROM_SIZE + 1];
+static bool     eeprom_loaded = false,
+                eeprom_dirty  = false;
+
+static void eeprom_load() {
+  if (eeprom_loaded) return;
+  eeprom_loaded = true;
+  memset(eeprom_image, 0xFF, sizeof(eeprom_image));
+  FILE *f = fopen(EEPROM_FILE, "rb");
+  if (f) {
+    if (fread(eeprom_image, 1, sizeof(eeprom_image), f) != sizeof(eeprom_image))
+      SERIAL_LM(ECHO, "EEPROM file truncated");
+    fclose(f);
+  }
+}
+
+void eeprom_flush(void) {
+  if (!eeprom_dirty) return;
+  FILE *f = fopen(EEPROM_FILE, "wb");
+  if (!f) return;
+  fwrite(eeprom_image, 1, sizeof(eeprom_image), f);
+  fclose(f);
+  eeprom_dirty = false;
+}
+
+uint8_t eeprom_read_byte(uint8_t* pos) {
+  eeprom_load();
+  const size_t p = (size_t)pos;
+  return p < sizeof(eeprom_image) ? eeprom_image[p] : 0xFF;
+}
+
+void eeprom_read_block(void* pos, const void* eeprom_address, size_t n) {
+  uint8_t *dst = (uint8_t*)pos;
+  size_t p = (size_t)eeprom_address;
+  while (n--) *dst++ = eeprom_read_byte((uint8_t*)p++);
+}
+
+void eeprom_write_byte(uint8_t* pos, uint8_t value) {
+  eeprom_load();
+  const size_t p = (size_t)pos;
+  if (p < sizeof(eeprom_image) && eeprom_image[p] != value) {
+    eeprom_image[p] = value;
+    eeprom_dirty = true;
+  }
+}
+
+void eeprom_update_block(const void* pos, void* eeprom_address, size_t n) {
+  const uint8_t *src = (const uint8_t*)pos;
+  size_t p = (size_t)eeprom_address;
+  while (n--) eeprom_write_byte((uint8_t*)p++, *src++);
+}
+
+#endif // __PLAT_LINUX__ && HAS_EEPROM
@@ -0,0 +1,127 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+// **************************************************************************
+//
+// Description: Fast IO functions for Linux native build
+//
+// Pins only exist in memory. The simulator reads outputs (heaters, fans)
+// and drives inputs (endstops) through the same table.
+// A pin linked to a direction pin counts its rising edges as signed steps.
+//
+// __PLAT_LINUX__
+// **************************************************************************
+
+/**
+ * Types
+ */
+typedef struct {
+  volatile bool     value;
+  volatile bool     output;
+  volatile bool     pullup;
+  volatile uint8_t  pwm;
+  volatile int32_t  steps;
+  pin_t             dir_pin;
+} Fastio_Param;
+
+/**
+ * Public Variables
+ */
+extern Fastio_Param Fastio[NUM_DIGITAL_PINS];
+
+/**
+ * Defines
+ */
+#define OUTPUT_LOW  0x3
+#define OUTPUT_HIGH 0x4
+
+FORCE_INLINE static bool VALID_PIN(const pin_t pin) { return WITHIN(pin, 0, NUM_DIGITAL_PINS - 1); }
+
+/**
+ * Public functions
+ */
+
+// Read a pin
+FORCE_INLINE static bool READ(const pin_t pin) {
+  return VALID_PIN(pin) ? Fastio[pin].value : false;
+}
+FORCE_INLINE static bool READ_VAR(const pin_t pin) {
+  return READ(pin);
+}
+
+// Write to a pin
+FORCE_INLINE static void WRITE(const pin_t pin, const bool flag) {
+  if (VALID_PIN(pin)) {
+    Fastio_Param &p = Fastio[pin];
+    if (flag && !p.value && p.dir_pin >= 0)
+      p.steps += Fastio[p.dir_pin].value ? 1 : -1;
+    p.value = flag;
+    p.pwm   = flag ? 255 : 0;
+  }
+}
+FORCE_INLINE static void WRITE_VAR(const pin_t pin, const bool flag) {
+  WRITE(pin, flag);
+}
+
+// Set pin as input
+FORCE_INLINE static void SET_INPUT(const pin_t pin) {
+  if (VALID_PIN(pin)) {
+    Fastio[pin].output = false;
+    Fastio[pin].pullup = false;
+  }
+}
+
+// Set pin as input with pullup
+FORCE_INLINE static void SET_INPUT_PULLUP(const pin_t pin) {
+  if (VALID_PIN(pin)) {
+    Fastio[pin].output = false;
+    Fastio[pin].pullup = true;
+    Fastio[pin].value  = true;
+  }
+}
+
+// Set pin as output
+FORCE_INLINE static void SET_OUTPUT(const pin_t pin) {
+  if (VALID_PIN(pin)) {
+    Fastio[pin].output = true;
+    WRITE(pin, LOW);
+  }
+}
+FORCE_INLINE static void SET_OUTPUT_HIGH(const pin_t pin) {
+  if (VALID_PIN(pin)) {
+    Fastio[pin].output = true;
+    WRITE(pin, HIGH);
+  }
+}
+
+// Shorthand
+FORCE_INLINE static void OUT_WRITE(const pin_t pin, const uint8_t flag) {
+  if (flag)
+    SET_OUTPUT_HIGH(pin);
+  else
+    SET_OUTPUT(pin);
+}
+
+FORCE_INLINE static bool USEABLE_HARDWARE_PWM(const pin_t pin) {
+  return VALID_PIN(pin);
+}
@@ -0,0 +1,157 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Minimal Arduino core replacement for the Linux native build.
+ * Only what the firmware actually uses is provided here.
+ *
+ * __PLAT_LINUX__
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+
+#include "avr/pgmspace.h"
+
+// Arduino IDE version, checked by some libraries
+#ifndef ARDUINO
+  #define ARDUINO 10805
+#endif
+
+#ifndef F_CPU
+  #define F_CPU 100000000UL
+#endif
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define LOW           0x0
+#define HIGH          0x1
+
+#define INPUT         0x0
+#define OUTPUT        0x1
+#define INPUT_PULLUP  0x2
+
+#define sq(x)         ((x)*(x))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define lowByte(w)    ((uint8_t) ((w) & 0xFF))
+#define highByte(w)   ((uint8_t) ((w) >> 8))
+#define F(str)        (str)
+
+// Time
+uint32_t millis();
+uint32_t micros();
+void delay(const uint32_t ms);
+void delayMicroseconds(const uint32_t us);
+
+// Interrupts
+void noInterrupts();
+void interrupts();
+
+// Digital and analog I/O
+void pinMode(const uint8_t pin, const uint8_t mode);
+void digitalWrite(const uint8_t pin, const uint8_t value);
+int digitalRead(const uint8_t pin);
+void analogWrite(const uint8_t pin, const int value);
+
+// Math
+template <class T, class A, class B, class C, class D>
+inline T map(const T x, const A in_min, const B in_max, const C out_min, const D out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+long random(const long max);
+long random(const long min, const long max);
+void randomSeed(const unsigned long seed);
+
+char* dtostrf(double val, signed char width, unsigned char prec, char *sout);
+char* itoa(int value, char* str, int base);
+char* ltoa(long value, char* str, int base);
+char* utoa(unsigned value, char* str, int base);
+char* ultoa(unsigned long value, char* str, int base);
+
+// Characters
+inline bool isDigit(const int c)        { return isdigit(c); }
+inline bool isAlpha(const int c)        { return isalpha(c); }
+inline bool isAlphaNumeric(const int c) { return isalnum(c); }
+inline bool isSpace(const int c)        { return isspace(c); }
+
+// Cooperative multitasking hook
+void yield();
+
+// Flash strings are plain strings on the host
+class __FlashStringHelper;
+
+// Arduino Print and Stream, only the subset needed by the SdFat library
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t size) {
+      size_t n = 0;
+      while (size--) n += write(*buf++);
+      return n;
+    }
+    size_t write(const char *str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+};
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() = 0;
+};
+
+// Arduino String, only the subset needed by the firmware
+class String : public std::string {
+  public:
+    String() : std::string() {}
+    String(const char* s) : std::string(s) {}
+    String(const __FlashStringHelper* s) : std::string(reinterpret_cast<const char*>(s)) {}
+    String(const std::string &s) : std::string(s) {}
+    String(const char c) : std::string(1, c) {}
+    String(const int v) : std::string(std::to_string(v)) {}
+    String(const long v) : std::string(std::to_string(v)) {}
+    String(const unsigned int v) : std::string(std::to_string(v)) {}
+    String(const unsigned long v) : std::string(std::to_string(v)) {}
+    int indexOf(const char c) const { const size_t i = find(c); return i == npos ? -1 : int(i); }
+    int indexOf(const char* s) const { const size_t i = find(s); return i == npos ? -1 : int(i); }
+    String substring(const size_t from) const { return String(substr(from)); }
+    String substring(const size_t from, const size_t to) const { return String(substr(from, to - from)); }
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    void toCharArray(char* buf, const size_t len) const { strncpy(buf, c_str(), len); if (len) buf[len - 1] = '\0'; }
+    bool startsWith(const char* s) const { return compare(0, strlen(s), s) == 0; }
+    bool endsWith(const char* s) const { const size_t l = strlen(s); return length() >= l && compare(length() - l, l, s) == 0; }
+};
+
+// Sketch entry points
+void setup();
+void loop();
@@ -0,0 +1,65 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * SPI of the Linux native build.
+ * Only the SD card on a disk image (sdcard_image.h) answers on the bus.
+ */
+#include <stdint.h>
+
+#define SPI_MODE0         0x00
+#define SPI_MODE1         0x04
+#define SPI_MODE2         0x08
+#define SPI_MODE3         0x0C
+
+#define SPI_CLOCK_DIV2    0x04
+#define SPI_CLOCK_DIV4    0x00
+#define SPI_CLOCK_DIV8    0x05
+#define SPI_CLOCK_DIV16   0x01
+#define SPI_CLOCK_DIV32   0x06
+#define SPI_CLOCK_DIV64   0x02
+#define SPI_CLOCK_DIV128  0x03
+
+#define LSBFIRST          0
+#define MSBFIRST          1
+
+class SPISettings {
+  public:
+    SPISettings() {}
+    SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+  public:
+    static void begin() {}
+    static void end() {}
+    static void beginTransaction(SPISettings) {}
+    static void endTransaction() {}
+    static uint8_t transfer(uint8_t data);
+    static uint16_t transfer16(uint16_t) { return 0xFFFF; }
+    static void setBitOrder(uint8_t) {}
+    static void setDataMode(uint8_t) {}
+    static void setClockDivider(uint8_t) {}
+};
+
+extern SPIClass SPI;
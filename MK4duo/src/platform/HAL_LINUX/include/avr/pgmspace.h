@@ -0,0 +1,92 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Program space replacement for the Linux native build.
+ * There is only one address space on the host.
+ *
+ * __PLAT_LINUX__
+ */
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#define PROGMEM
+#ifndef PGM_P
+  #define PGM_P const char*
+#endif
+#undef PSTR
+#define PSTR(s) s
+#undef pgm_read_byte_near
+#define pgm_read_byte_near(x) (*(const uint8_t*)(x))
+#undef pgm_read_byte
+#define pgm_read_byte(x) (*(const uint8_t*)(x))
+#undef pgm_read_float
+#define pgm_read_float(addr) (*(const float *)(addr))
+#undef pgm_read_word
+#define pgm_read_word(addr) (*(addr))
+#undef pgm_read_word_near
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+#undef pgm_read_dword
+#define pgm_read_dword(addr) (*(addr))
+#undef pgm_read_dword_near
+#define pgm_read_dword_near(addr) pgm_read_dword(addr)
+#undef pgm_read_ptr
+#define pgm_read_ptr(addr) (*(addr))
+#ifndef strncpy_P
+  // strncpy with the pad done by hand: callers copy a known length and end
+  // the string themselves, which the strncpy builtin would warn about.
+  inline char* strncpy_P(char* dest, const char* src, size_t num) {
+    const size_t len = strnlen(src, num);
+    memcpy(dest, src, len);
+    memset(dest + len, 0, num - len);
+    return dest;
+  }
+#endif
+#ifndef strcpy_P
+  #define strcpy_P(dest, src) strcpy((dest), (src))
+#endif
+#ifndef strlen_P
+  #define strlen_P(s) strlen(s)
+#endif
+#ifndef strcmp_P
+  #define strcmp_P(a, b) strcmp((a), (b))
+#endif
+#ifndef sprintf_P
+  #define sprintf_P(buf, ...) sprintf((buf), __VA_ARGS__)
+#endif
+#ifndef vsnprintf_P
+  #define vsnprintf_P(buf, size, a, b) vsnprintf((buf), (size), (a), (b))
+#endif
+#ifndef strstr_P
+  #define strstr_P(a, b) strstr((a), (b))
+#endif
+#ifndef strchr_P
+  #define strchr_P(s, c) strchr((s), (c))
+#endif
+#ifndef memcpy_P
+  #define memcpy_P(dest, src, num) memcpy((dest), (src), (num))
+#endif
+#ifndef snprintf_P
+  #define snprintf_P(buf, size, ...) snprintf((buf), (size), __VA_ARGS__)
+#endif
@@ -0,0 +1,52 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Pin definitions for the Linux native build.
+ * All pins are simulated, so any pin number up to NUM_DIGITAL_PINS can be used.
+ */
+#define NUM_DIGITAL_PINS  128
+#define NUM_ANALOG_PINS    16
+
+// SPI bus, SS is the default chip select
+#define SS    53
+#define MOSI  51
+#define MISO  50
+#define SCK   52
+
+#define A0    0
+#define A1    1
+#define A2    2
+#define A3    3
+#define A4    4
+#define A5    5
+#define A6    6
+#define A7    7
+#define A8    8
+#define A9    9
+#define A10  10
+#define A11  11
+#define A12  12
+#define A13  13
+#define A14  14
+#define A15  15
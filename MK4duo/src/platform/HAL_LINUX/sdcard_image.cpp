@@ -0,0 +1,348 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Description: SD card on a disk image for Linux native build
+ *
+ * __PLAT_LINUX__
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(__PLAT_LINUX__)
+
+#include "sdcard_image.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// --------------------------------------------------------------------------
+// Local defines
+// --------------------------------------------------------------------------
+
+#define R1_IDLE           0x01
+#define R1_ILLEGAL        0x04
+#define R1_PARAMETER      0x40
+
+#define TOKEN_START       0xFE
+#define TOKEN_MULTI_WRITE 0xFC
+#define TOKEN_STOP_TRAN   0xFD
+#define TOKEN_OUT_OF_RANGE 0x08
+#define DATA_ACCEPTED     0x05
+
+enum SdImageStateEnum : uint8_t {
+  SD_IMAGE_IDLE,        // Waiting for a command
+  SD_IMAGE_READ,        // CMD18, a block is sent every time the output is empty
+  SD_IMAGE_WAIT_TOKEN,  // CMD24/CMD25, waiting for a data token
+  SD_IMAGE_DATA         // Receiving a block to write
+};
+
+SdCardImage sdcard_image;
+
+// --------------------------------------------------------------------------
+// Public Variables
+// --------------------------------------------------------------------------
+
+sdcard_image_stats_t SdCardImage::stats;
+
+// --------------------------------------------------------------------------
+// Private Variables
+// --------------------------------------------------------------------------
+
+int       SdCardImage::fd           = -1;
+uint32_t  SdCardImage::blocks       = 0;
+
+uint8_t   SdCardImage::cmd[6],
+          SdCardImage::cmd_count    = 0,
+          SdCardImage::out[SDCARD_IMAGE_ACCESS + 520];
+uint16_t  SdCardImage::out_head     = 0,
+          SdCardImage::out_tail     = 0;
+
+uint8_t   SdCardImage::block[514];
+uint16_t  SdCardImage::block_count  = 0;
+
+uint32_t  SdCardImage::cur_block    = 0;
+uint8_t   SdCardImage::state        = SD_IMAGE_IDLE;
+bool      SdCardImage::idle         = true,
+          SdCardImage::app_cmd      = false,
+          SdCardImage::multi        = false;
+
+// --------------------------------------------------------------------------
+// Public functions
+// --------------------------------------------------------------------------
+
+void SdCardImage::init(int argc, char** argv) {
+
+  const char* file = NULL;
+  for (int i = 1; i < argc - 1; i++)
+    if (!strcmp(argv[i], "--sdcard")) file = argv[++i];
+
+  if (!file) return;
+
+  fd = open(file, O_RDWR);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) || st.st_size < 1024 * 512) {
+    fprintf(stderr, "%s: %s\n", file, fd < 0 ? strerror(errno) : "not a card image");
+    exit(1);
+  }
+  blocks = st.st_size / 512;
+
+}
+
+uint8_t SdCardImage::transfer(const uint8_t data) {
+
+  if (!present() || READ(SDSS)) return 0xFF;  // Not selected
+
+  stats.bytes++;
+
+  uint8_t ret = 0xFF;
+  if (out_head < out_tail) ret = out[out_head++];
+  if (out_head == out_tail) out_head = out_tail = 0;
+
+  switch (state) {
+
+    case SD_IMAGE_WAIT_TOKEN:
+      if (data == (multi ? TOKEN_MULTI_WRITE : TOKEN_START)) {
+        block_count = 0;
+        state = SD_IMAGE_DATA;
+      }
+      else if (multi && data == TOKEN_STOP_TRAN) {
+        push(0xFF);
+        push_fill(0x00, SDCARD_IMAGE_BUSY);
+        state = SD_IMAGE_IDLE;
+      }
+      break;
+
+    case SD_IMAGE_DATA:
+      block[block_count++] = data;
+      if (block_count == sizeof(block)) {
+        push(write_block(cur_block++, block) ? DATA_ACCEPTED : 0x0D);
+        push_fill(0x00, SDCARD_IMAGE_BUSY);
+        state = multi ? SD_IMAGE_WAIT_TOKEN : SD_IMAGE_IDLE;
+      }
+      break;
+
+    default:
+      if (cmd_count || (data & 0xC0) == 0x40) {
+        cmd[cmd_count++] = data;
+        if (cmd_count == sizeof(cmd)) {
+          cmd_count = 0;
+          command();
+        }
+      }
+      break;
+  }
+
+  // A multi-block read goes on as long as the host clocks the bus
+  if (state == SD_IMAGE_READ && out_head == out_tail) {
+    push_fill(0xFF, SDCARD_IMAGE_GAP);
+    if (read_block(cur_block, block)) {
+      push_block(block, 512);
+      cur_block++;
+    }
+    else
+      push(TOKEN_OUT_OF_RANGE);
+  }
+
+  return ret;
+}
+
+// --------------------------------------------------------------------------
+// Private functions
+// --------------------------------------------------------------------------
+
+void SdCardImage::command() {
+
+  const uint8_t   code  = cmd[0] & 0x3F;
+  const uint32_t  arg   = uint32_t(cmd[1]) << 24 | uint32_t(cmd[2]) << 16 | uint32_t(cmd[3]) << 8 | cmd[4];
+  const bool      acmd  = app_cmd;
+  const uint8_t   r1    = idle ? R1_IDLE : 0;
+
+  stats.commands++;
+  app_cmd = false;
+
+  // A new command ends a multi-block read, the rest of the block is lost
+  out_head = out_tail = 0;
+  if (state == SD_IMAGE_READ) state = SD_IMAGE_IDLE;
+
+  push(0xFF); // Response comes after one byte
+
+  switch (code) {
+
+    case 0:   // GO_IDLE_STATE
+      idle = true;
+      state = SD_IMAGE_IDLE;
+      push(R1_IDLE);
+      break;
+
+    case 8:   // SEND_IF_COND, echo the check pattern
+      push(r1);
+      push(0x00); push(0x00); push(arg >> 8 & 0x0F); push(arg & 0xFF);
+      break;
+
+    case 9: { // SEND_CSD, version 2.0
+      const uint32_t c_size = blocks / 1024 - 1;
+      const uint8_t csd[16] = {
+        0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00,
+        uint8_t(c_size >> 16 & 0x3F), uint8_t(c_size >> 8), uint8_t(c_size),
+        0x7F, 0x80, 0x0A, 0x40, 0x00, 0x01
+      };
+      push(r1);
+      push_fill(0xFF, SDCARD_IMAGE_ACCESS);
+      push_block(csd, sizeof(csd));
+    } break;
+
+    case 10: { // SEND_CID
+      const uint8_t cid[16] = { 0x03, 'M', 'K', 'L', 'I', 'N', 'U', 'X', 0x10, 0, 0, 0, 1, 0x01, 0x3A, 0x01 };
+      push(r1);
+      push_fill(0xFF, SDCARD_IMAGE_ACCESS);
+      push_block(cid, sizeof(cid));
+    } break;
+
+    case 12:  // STOP_TRANSMISSION
+      push(0xFF);
+      push(r1);
+      break;
+
+    case 13:  // SEND_STATUS or ACMD13 SD_STATUS
+      push(r1);
+      push(0x00);
+      if (acmd) {
+        uint8_t status[64];
+        ZERO(status);
+        push_fill(0xFF, SDCARD_IMAGE_ACCESS);
+        push_block(status, sizeof(status));
+      }
+      break;
+
+    case 17:  // READ_SINGLE_BLOCK
+      if (read_block(arg, block)) {
+        push(r1);
+        push_fill(0xFF, SDCARD_IMAGE_ACCESS);
+        push_block(block, 512);
+      }
+      else
+        push(r1 | R1_PARAMETER);
+      break;
+
+    case 18:  // READ_MULTIPLE_BLOCK
+      if (arg < blocks) {
+        push(r1);
+        push_fill(0xFF, SDCARD_IMAGE_ACCESS);
+        read_block(arg, block);
+        push_block(block, 512);
+        cur_block = arg + 1;
+        state = SD_IMAGE_READ;
+      }
+      else
+        push(r1 | R1_PARAMETER);
+      break;
+
+    case 24:  // WRITE_BLOCK
+    case 25:  // WRITE_MULTIPLE_BLOCK
+      if (arg < blocks) {
+        push(r1);
+        cur_block = arg;
+        multi = (code == 25);
+        state = SD_IMAGE_WAIT_TOKEN;
+      }
+      else
+        push(r1 | R1_PARAMETER);
+      break;
+
+    case 41:  // ACMD41 SD_SEND_OP_COND, ready at once
+      idle = false;
+      push(acmd ? 0x00 : R1_ILLEGAL);
+      break;
+
+    case 55:  // APP_CMD
+      app_cmd = true;
+      push(r1);
+      break;
+
+    case 58:  // READ_OCR, powered up and SDHC
+      push(r1);
+      push(0xC0); push(0xFF); push(0x80); push(0x00);
+      break;
+
+    case 38:  // ERASE
+      push(r1);
+      push_fill(0x00, SDCARD_IMAGE_BUSY);
+      break;
+
+    case 16:  // SET_BLOCKLEN
+    case 23:  // ACMD23 SET_WR_BLK_ERASE_COUNT
+    case 32:  // ERASE_WR_BLK_START
+    case 33:  // ERASE_WR_BLK_END
+    case 59:  // CRC_ON_OFF
+      push(r1);
+      break;
+
+    default:
+      push(r1 | R1_ILLEGAL);
+      break;
+  }
+
+}
+
+void SdCardImage::push(const uint8_t data) {
+  if (out_tail < sizeof(out)) out[out_tail++] = data;
+}
+
+void SdCardImage::push_fill(const uint8_t data, const uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) push(data);
+}
+
+// Data token, data and CRC
+void SdCardImage::push_block(const uint8_t* data, const uint16_t size) {
+  push(TOKEN_START);
+  for (uint16_t i = 0; i < size; i++) push(data[i]);
+  const uint16_t crc = crc16(data, size);
+  push(crc >> 8);
+  push(crc & 0xFF);
+}
+
+bool SdCardImage::read_block(const uint32_t lba, uint8_t* data) {
+  if (lba >= blocks || pread(fd, data, 512, off_t(lba) * 512) != 512) return false;
+  stats.blocks_read++;
+  return true;
+}
+
+bool SdCardImage::write_block(const uint32_t lba, const uint8_t* data) {
+  if (lba >= blocks || pwrite(fd, data, 512, off_t(lba) * 512) != 512) return false;
+  stats.blocks_written++;
+  return true;
+}
+
+// CRC16-CCITT of the data blocks
+uint16_t SdCardImage::crc16(const uint8_t* data, const uint16_t size) {
+  uint16_t crc = 0;
+  for (uint16_t i = 0; i < size; i++) {
+    crc ^= uint16_t(data[i]) << 8;
+    for (uint8_t b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+#endif // __PLAT_LINUX__
@@ -0,0 +1,110 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Description: SD card on a disk image for Linux native build
+ *
+ *   mk4duo --sdcard card.img
+ *
+ * The card answers on the SPI bus while SDSS is low, in SPI mode, like an
+ * SDHC card: CMD0/8/55/41/58 init, CSD/CID, CMD17/18/12 reads, CMD24/25
+ * writes and erase. Blocks are read and written in the image file, so the
+ * real SdFat code runs on top of it. scripts/sd_image.py makes an image.
+ *
+ * Every byte on the bus is counted, so the SD traffic of the firmware can
+ * be measured. A read command waits SDCARD_IMAGE_ACCESS bytes before the
+ * first data token, the next blocks of a CMD18 only SDCARD_IMAGE_GAP bytes.
+ *
+ * __PLAT_LINUX__
+ */
+
+#define SDCARD_IMAGE_ACCESS 100   // Bytes of 0xFF before the data of a read command
+#define SDCARD_IMAGE_GAP      2   // Bytes of 0xFF between the blocks of a CMD18
+#define SDCARD_IMAGE_BUSY     8   // Bytes of busy after a block write
+
+typedef struct {
+  uint32_t  bytes,        // Bytes on the SPI bus while selected
+            commands,     // Commands received
+            blocks_read,  // Blocks read from the image, a CMD18 reads one ahead
+            blocks_written;
+} sdcard_image_stats_t;
+
+class SdCardImage {
+
+  public: /** Constructor */
+
+    SdCardImage() {}
+
+  public: /** Public Parameters */
+
+    static sdcard_image_stats_t stats;
+
+  private: /** Private Parameters */
+
+    static int      fd;
+    static uint32_t blocks;
+
+    static uint8_t  cmd[6],
+                    cmd_count,
+                    out[SDCARD_IMAGE_ACCESS + 520];
+    static uint16_t out_head,
+                    out_tail;
+
+    static uint8_t  block[514];
+    static uint16_t block_count;
+
+    static uint32_t cur_block;
+    static uint8_t  state;
+    static bool     idle,
+                    app_cmd,
+                    multi;
+
+  public: /** Public Function */
+
+    /**
+     * Parse the command line, --sdcard file opens the image
+     */
+    static void init(int argc, char** argv);
+
+    static inline bool present() { return fd >= 0; }
+
+    /**
+     * One byte in each direction on the SPI bus
+     */
+    static uint8_t transfer(const uint8_t data);
+
+    static inline void reset_stats() { memset(&stats, 0, sizeof(stats)); }
+
+  private: /** Private Function */
+
+    static void command();
+    static void push(const uint8_t data);
+    static void push_fill(const uint8_t data, const uint16_t count);
+    static void push_block(const uint8_t* data, const uint16_t size);
+    static bool read_block(const uint32_t lba, uint8_t* data);
+    static bool write_block(const uint32_t lba, const uint8_t* data);
+    static uint16_t crc16(const uint8_t* data, const uint16_t size);
+
+};
+
+extern SdCardImage sdcard_image;
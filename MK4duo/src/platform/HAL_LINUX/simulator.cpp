@@ -0,0 +1,234 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Description: Simulated machine for Linux native build
+ *
+ * __PLAT_LINUX__
+ */
+
+#include "../../../MK4duo.h"
+
+#if ENABLED(__PLAT_LINUX__)
+
+#include "simulator.h"
+
+Simulator simulator;
+
+// --------------------------------------------------------------------------
+// Local defines
+// --------------------------------------------------------------------------
+
+#define SIMULATOR_TICK_S  0.001f
+
+#if ENABLED(X_MAX_POS) && ENABLED(X_MIN_POS)
+  #define SIMULATOR_X_TRAVEL (X_MAX_POS - X_MIN_POS)
+#else
+  #define SIMULATOR_X_TRAVEL 200
+#endif
+#if ENABLED(Y_MAX_POS) && ENABLED(Y_MIN_POS)
+  #define SIMULATOR_Y_TRAVEL (Y_MAX_POS - Y_MIN_POS)
+#else
+  #define SIMULATOR_Y_TRAVEL 200
+#endif
+#if ENABLED(Z_MAX_POS) && ENABLED(Z_MIN_POS)
+  #define SIMULATOR_Z_TRAVEL (Z_MAX_POS - Z_MIN_POS)
+#else
+  #define SIMULATOR_Z_TRAVEL 200
+#endif
+
+// --------------------------------------------------------------------------
+// Private Variables
+// --------------------------------------------------------------------------
+
+#if HOTENDS > 0
+  float Simulator::hotend_temp[HOTENDS];
+#endif
+#if BEDS > 0
+  float Simulator::bed_temp[BEDS];
+#endif
+#if CHAMBERS > 0
+  float Simulator::chamber_temp[CHAMBERS];
+#endif
+
+float Simulator::carriage_start[XYZ]  = { 0.0f },
+      Simulator::axis_travel[XYZ]     = { SIMULATOR_X_TRAVEL, SIMULATOR_Y_TRAVEL, SIMULATOR_Z_TRAVEL };
+
+// --------------------------------------------------------------------------
+// Private functions
+// --------------------------------------------------------------------------
+
+// Raw ADC value the sensor reads at the given temperature
+static int16_t celsius_to_raw(sensor_data_t &sens, const float celsius) {
+
+  float raw = 0.0f;
+
+  if (WITHIN(sens.type, 1, 9)) {
+    // Solve shA + shB * ln(R) + shC * ln(R)^3 = 1/T for ln(R)
+    const float recipT = 1.0f / (celsius - (ABS_ZERO));
+    float lnR = (recipT - sens.shA) / sens.shB;
+    if (sens.shC != 0.0f) {
+      for (uint8_t i = 0; i < 4; i++) {
+        const float f  = sens.shA + sens.shB * lnR + sens.shC * lnR * lnR * lnR - recipT,
+                    df = sens.shB + 3.0f * sens.shC * lnR * lnR;
+        lnR -= f / df;
+      }
+    }
+    const float resistance  = expf(lnR),
+                vssa        = 2.0f * sens.adcLowOffset,
+                vref        = (AD_RANGE) + 2.0f * sens.adcHighOffset;
+    raw = (resistance * (vref - 0.5f) - sens.pullupR * (0.5f - vssa)) / (resistance + sens.pullupR);
+  }
+  #if HAS_AD8495
+    else if (sens.type == -2)
+      raw = ((celsius - sens.ad595_offset) / sens.ad595_gain) * float(AD_RANGE) / float(AD8495_MAX);
+  #endif
+  #if HAS_AD595
+    else if (sens.type == -1)
+      raw = ((celsius - sens.ad595_offset) / sens.ad595_gain) * float(AD_RANGE) / float(AD595_MAX);
+  #endif
+
+  return (int16_t)constrain(raw, 0.0f, float(AD_RANGE - 1));
+}
+
+// --------------------------------------------------------------------------
+// Public functions
+// --------------------------------------------------------------------------
+
+void Simulator::init() {
+
+  for (uint16_t pin = 0; pin < NUM_DIGITAL_PINS; pin++) Fastio[pin].dir_pin = -1;
+
+  #if HAS_X_STEP && HAS_X_DIR
+    Fastio[X_STEP_PIN].dir_pin = X_DIR_PIN;
+  #endif
+  #if HAS_Y_STEP && HAS_Y_DIR
+    Fastio[Y_STEP_PIN].dir_pin = Y_DIR_PIN;
+  #endif
+  #if HAS_Z_STEP && HAS_Z_DIR
+    Fastio[Z_STEP_PIN].dir_pin = Z_DIR_PIN;
+  #endif
+
+  LOOP_XYZ(axis) carriage_start[axis] = axis_travel[axis] * 0.5f;
+
+  #if HOTENDS > 0
+    LOOP_HOTEND() hotend_temp[h] = SIMULATOR_AMBIENT_TEMP;
+  #endif
+  #if BEDS > 0
+    LOOP_BED() bed_temp[h] = SIMULATOR_AMBIENT_TEMP;
+  #endif
+  #if CHAMBERS > 0
+    LOOP_CHAMBER() chamber_temp[h] = SIMULATOR_AMBIENT_TEMP;
+  #endif
+
+}
+
+void Simulator::spin() {
+  #if HOTENDS > 0
+    LOOP_HOTEND() update_heater(hotends[h], hotend_temp[h]);
+  #endif
+  #if BEDS > 0
+    LOOP_BED() update_heater(beds[h], bed_temp[h]);
+  #endif
+  #if CHAMBERS > 0
+    LOOP_CHAMBER() update_heater(chambers[h], chamber_temp[h]);
+  #endif
+}
+
+float Simulator::carriage_position(const AxisEnum axis) {
+  pin_t step_pin = -1;
+  switch (axis) {
+    #if HAS_X_STEP
+      case X_AXIS: step_pin = X_STEP_PIN; break;
+    #endif
+    #if HAS_Y_STEP
+      case Y_AXIS: step_pin = Y_STEP_PIN; break;
+    #endif
+    #if HAS_Z_STEP
+      case Z_AXIS: step_pin = Z_STEP_PIN; break;
+    #endif
+    default: break;
+  }
+  if (step_pin < 0) return carriage_start[axis];
+
+  // Positive motion sets the dir pin to the inverse of the direction flag
+  const int32_t steps = stepper.isStepDir(axis) ? -Fastio[step_pin].steps : Fastio[step_pin].steps;
+  return carriage_start[axis] + steps * mechanics.steps_to_mm[axis];
+}
+
+void Simulator::update_endstops() {
+
+  #define _SIM_ENDSTOP(A,M,HIT) do{ \
+    const bool hit = (HIT); \
+    Fastio[A##_##M##_PIN].value = hit ? !endstops.isLogic(A##_##M) : endstops.isLogic(A##_##M); \
+  }while(0)
+
+  #if HAS_X_MIN
+    _SIM_ENDSTOP(X, MIN, carriage_position(X_AXIS) <= 0.0f);
+  #endif
+  #if HAS_X_MAX
+    _SIM_ENDSTOP(X, MAX, carriage_position(X_AXIS) >= axis_travel[X_AXIS] + 1.0f);
+  #endif
+  #if HAS_Y_MIN
+    _SIM_ENDSTOP(Y, MIN, carriage_position(Y_AXIS) <= 0.0f);
+  #endif
+  #if HAS_Y_MAX
+    _SIM_ENDSTOP(Y, MAX, carriage_position(Y_AXIS) >= axis_travel[Y_AXIS] + 1.0f);
+  #endif
+  #if HAS_Z_MIN
+    _SIM_ENDSTOP(Z, MIN, carriage_position(Z_AXIS) <= 0.0f);
+  #endif
+  #if HAS_Z_MAX
+    _SIM_ENDSTOP(Z, MAX, carriage_position(Z_AXIS) >= axis_travel[Z_AXIS] + 1.0f);
+  #endif
+
+  #undef _SIM_ENDSTOP
+
+}
+
+#if HEATER_COUNT > 0
+
+  void Simulator::update_heater(Heater &act, float &temp) {
+
+    constexpr float heater_power[HEATER_TYPE]     = SIMULATOR_HEATER_POWER,
+                    heater_maxtemp[HEATER_TYPE]   = SIMULATOR_HEATER_MAXTEMP,
+                    heater_capacity[HEATER_TYPE]  = SIMULATOR_HEATER_CAPACITY;
+
+    const uint8_t t = act.data.type;
+    uint8_t pwm = VALID_PIN(act.data.pin) ? Fastio[act.data.pin].pwm : 0;
+    if (act.isHWInverted()) pwm = 255 - pwm;
+
+    // Heat loss is linear with the temperature difference, full power balances it at max temp
+    const float loss  = heater_power[t] / (heater_maxtemp[t] - (SIMULATOR_AMBIENT_TEMP)),
+                power = heater_power[t] * pwm / 255.0f - loss * (temp - (SIMULATOR_AMBIENT_TEMP));
+    temp += power * (SIMULATOR_TICK_S) / heater_capacity[t];
+
+    if (WITHIN(act.sensor.pin, 0, NUM_ANALOG_INPUTS - 1)) {
+      HAL::AnalogInputValues[act.sensor.pin] = celsius_to_raw(act.sensor, temp);
+      HAL::Analog_is_ready = true;
+    }
+
+  }
+
+#endif // HEATER_COUNT > 0
+
+#endif // __PLAT_LINUX__
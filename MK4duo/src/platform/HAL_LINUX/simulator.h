@@ -0,0 +1,98 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * Description: Simulated machine for Linux native build
+ *
+ * - Every heater is a first order thermal model driven by the PWM of its
+ *   pin, its temperature is converted back to the raw ADC value the
+ *   sensor would read.
+ * - Every motor moves a virtual carriage counted from its step and dir
+ *   pins, the carriage starts in the middle of the axis travel and drives
+ *   the min/max endstop pins.
+ *
+ * __PLAT_LINUX__
+ */
+
+// Ambient temperature of the simulated machine
+#ifndef SIMULATOR_AMBIENT_TEMP
+  #define SIMULATOR_AMBIENT_TEMP 25.0f
+#endif
+
+// Heater power (W), max reachable temperature (°C) and heat capacity (J/K) for hotend, bed and chamber
+#define SIMULATOR_HEATER_POWER    {  40.0f, 200.0f,  100.0f }
+#define SIMULATOR_HEATER_MAXTEMP  { 300.0f, 130.0f,   80.0f }
+#define SIMULATOR_HEATER_CAPACITY {  15.0f, 600.0f, 2000.0f }
+
+class Simulator {
+
+  public: /** Constructor */
+
+    Simulator() {}
+
+  private: /** Private Parameters */
+
+    #if HOTENDS > 0
+      static float hotend_temp[HOTENDS];
+    #endif
+    #if BEDS > 0
+      static float bed_temp[BEDS];
+    #endif
+    #if CHAMBERS > 0
+      static float chamber_temp[CHAMBERS];
+    #endif
+
+    static float carriage_start[XYZ],
+                 axis_travel[XYZ];
+
+  public: /** Public Function */
+
+    /**
+     * Link step and dir pins, called once before setup()
+     */
+    static void init();
+
+    /**
+     * Update the thermal models and the ADC, called from HAL::Tick
+     */
+    static void spin();
+
+    /**
+     * Update the endstop pins from the carriage position, called after every stepper ISR
+     */
+    static void update_endstops();
+
+    /**
+     * Current position of the carriage of an axis in mm from its min endstop
+     */
+    static float carriage_position(const AxisEnum axis);
+
+  private: /** Private Function */
+
+    #if HEATER_COUNT > 0
+      static void update_heater(Heater &act, float &temp);
+    #endif
+
+};
+
+extern Simulator simulator;
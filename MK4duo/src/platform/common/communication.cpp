@@ -41,6 +41,24 @@ FSTRINGVALUE(REQUESTPAUSE, "RequestPause:");
 FSTRINGVALUE(REQUESTCONTINUE, "RequestContinue:");
 FSTRINGVALUE(REQUESTSTOP, "RequestStop:");
 
+/** Private Function */
+
+// Byte by byte, for the ports without readBytesUntil
+template <class SERIAL_T>
+  static uint16_t read_until(SERIAL_T &serial, const char * const stops, char * const buffer, const uint16_t length) {
+    uint16_t count = 0;
+    for (int c; count < length && (c = serial.peek()) >= 0 && !strchr(stops, c); count++)
+      buffer[count] = serial.read();
+    return count;
+  }
+
+#if ENABLED(ARDUINO_ARCH_SAM)
+  template <int IDPort>
+    static uint16_t read_until(MKHardwareSerial<IDPort> &serial, const char * const stops, char * const buffer, const uint16_t length) {
+      return serial.readBytesUntil(stops, buffer, length);
+    }
+#endif
+
 /** Public Parameters */
 int8_t Com::serial_port_index = -1;
 
@@ -73,6 +91,16 @@ int Com::serialRead(const uint8_t index) {
   }
 }
 
+uint16_t Com::serialReadUntil(const uint8_t index, const char * const stops, char * const buffer, const uint16_t length) {
+  switch (index) {
+    case 0: return read_until(MKSERIAL1, stops, buffer, length);
+    #if NUM_SERIAL > 1
+      case 1: return read_until(MKSERIAL2, stops, buffer, length);
+    #endif
+    default: return 0;
+  }
+}
+
 bool Com::serialDataAvailable() {
   return (MKSERIAL1.available() ? true :
     #if NUM_SERIAL > 1
@@ -85,12 +113,22 @@ bool Com::serialDataAvailable(const uint8_t index) {
   switch (index) {
     case 0: return MKSERIAL1.available();
     #if NUM_SERIAL > 1
-      case 1: MKSERIAL2.available();
+      case 1: return MKSERIAL2.available();
     #endif
     default: return false;
   }
 }
 
+int Com::serialAvailable(const uint8_t index) {
+  switch (index) {
+    case 0: return MKSERIAL1.available();
+    #if NUM_SERIAL > 1
+      case 1: return MKSERIAL2.available();
+    #endif
+    default: return 0;
+  }
+}
+
 // Functions for serial printing from PROGMEM. (Saves loads of SRAM.)
 void Com::printPGM(PGM_P str) {
   while (char c = pgm_read_byte(str++)) {
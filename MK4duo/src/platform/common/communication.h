@@ -59,9 +59,11 @@ class Com {
     static void serialFlush();
 
     static int serialRead(const uint8_t index);
+    static uint16_t serialReadUntil(const uint8_t index, const char * const stops, char * const buffer, const uint16_t length);
 
     static bool serialDataAvailable();
     static bool serialDataAvailable(const uint8_t index);
+    static int  serialAvailable(const uint8_t index);
 
     // Functions for serial printing from PROGMEM. (Saves loads of SRAM.)
     static void printPGM(PGM_P);
@@ -30,6 +30,8 @@
     #include "../HAL_DUE/endstop_interrupts.h"
   #elif ENABLED(__AVR__)
     #include "../HAL_AVR/endstop_interrupts.h"
+  #elif ENABLED(__PLAT_LINUX__)
+    #error "ENDSTOP_INTERRUPTS_FEATURE is not supported on the Linux native build!"
   #else
     #error "Unsupported Platform!"
   #endif
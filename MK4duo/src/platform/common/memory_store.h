@@ -47,6 +47,10 @@ class MemoryStore {
 
     static size_t capacity();
 
+    #if HAS_EEPROM_FLASH
+      static void spin(); // Erase a page of FLASH left by a compaction
+    #endif
+
     static inline bool write_data(const int pos, const uint8_t* value, const size_t size=sizeof(uint8_t)) {
       int data_pos = pos;
       uint16_t crc = 0;
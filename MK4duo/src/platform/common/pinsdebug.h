@@ -27,6 +27,8 @@
   #include "../HAL_DUE/pinsdebug.h"
 #elif ENABLED(__AVR__)
   #include "../HAL_AVR/pinsdebug.h"
+#elif ENABLED(__PLAT_LINUX__)
+  #error "PINS_DEBUGGING is not supported on the Linux native build!"
 #else
   #error "Unsupported Platform!"
 #endif
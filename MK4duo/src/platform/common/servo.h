@@ -80,6 +80,8 @@
     #include "../HAL_DUE/servotimers.h"
   #elif ENABLED(__AVR__)
     #include "../HAL_AVR/servotimers.h"
+  #elif ENABLED(__PLAT_LINUX__)
+    #error "Servos are not supported on the Linux native build!"
   #else
     #error "Unsupported Platform!"
   #endif
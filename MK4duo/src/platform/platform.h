@@ -27,6 +27,7 @@
  * Supports platforms:
  *    ARDUINO_ARCH_SAM  : For Arduino Due and other boards based on Atmel SAM3X8E
  *    __AVR__           : For all Atmel AVR boards
+ *    __PLAT_LINUX__    : For the Linux native build, peripherals are simulated
  */
 
 #include "common/memory_store.h"
@@ -47,6 +48,10 @@
 #elif ENABLED(__AVR__)
   #include "HAL_AVR/spi_pins.h"
   #include "HAL_AVR/HAL.h"
+#elif ENABLED(__PLAT_LINUX__)
+  #define CPU_32_BIT
+  #include "HAL_LINUX/spi_pins.h"
+  #include "HAL_LINUX/HAL.h"
 #else
   #error "Unsupported Platform!"
 #endif
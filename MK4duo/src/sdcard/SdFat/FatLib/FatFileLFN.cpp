@@ -22,7 +22,7 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
  * DEALINGS IN THE SOFTWARE.
  */
-#include "../../../../mk4duo.h"
+#include "../../../../MK4duo.h"
 #include "FatFile.h"
 #if HAS_SD_SUPPORT
 //------------------------------------------------------------------------------
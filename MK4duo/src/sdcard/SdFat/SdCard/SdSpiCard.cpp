@@ -22,7 +22,7 @@
  * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
  * DEALINGS IN THE SOFTWARE.
  */
-#include "../../../../mk4duo.h"
+#include "../../../../MK4duo.h"
 #include "SdSpiCard.h"
 //==============================================================================
 // debug trace macro
@@ -379,6 +379,9 @@ void SdSpiCard::dbgPrintStats() {::dbgPrintStats();}
 //------------------------------------------------------------------------------
 bool SdSpiCard::erase(uint32_t firstBlock, uint32_t lastBlock) {
   csd_t csd;
+#if ENABLED(SD_STREAM_READ)
+  m_streamCount = 0;
+#endif  // SD_STREAM_READ
   if (!readCSD(&csd)) {
     goto fail;
   }
@@ -452,6 +455,14 @@ bool SdSpiCard::isTimedOut(uint16_t startMS, uint16_t timeoutMS) {
 //------------------------------------------------------------------------------
 bool SdSpiCard::readBlock(uint32_t blockNumber, uint8_t* dst) {
   SD_TRACE("RB", blockNumber);
+#if ENABLED(SD_STREAM_READ)
+  if (m_streaming) {
+    const int8_t res = readStream(blockNumber, dst);
+    if (res >= 0) {
+      return res;
+    }
+  }
+#endif  // SD_STREAM_READ
   // use address if not SDHC card
   if (type() != SD_CARD_TYPE_SDHC) {
     blockNumber <<= 9;
@@ -472,6 +483,17 @@ fail:
 }
 //------------------------------------------------------------------------------
 bool SdSpiCard::readBlocks(uint32_t block, uint8_t* dst, size_t count) {
+#if ENABLED(SD_STREAM_READ)
+  if (m_streaming) {
+    for (; count && streamHit(block, dst); block++, dst += 512) {
+      count--;
+    }
+    if (!count) {
+      return true;
+    }
+    m_streamNext = block + count;
+  }
+#endif  // SD_STREAM_READ
   if (!readStart(block)) {
     return false;
   }
@@ -482,6 +504,49 @@ bool SdSpiCard::readBlocks(uint32_t block, uint8_t* dst, size_t count) {
   }
   return readStop();
 }
+#if ENABLED(SD_STREAM_READ)
+//------------------------------------------------------------------------------
+// Copy a block that is in the stream buffer.
+bool SdSpiCard::streamHit(uint32_t block, uint8_t* dst) {
+  if (block - m_streamStart >= m_streamCount) {
+    return false;
+  }
+  memcpy(dst, m_streamBuf[block - m_streamStart], 512);
+  m_streamNext = block + 1;
+  return true;
+}
+//------------------------------------------------------------------------------
+// The next block of a sequential read fills the stream buffer with one CMD18,
+// across cluster boundaries if the clusters follow each other on the card.
+// The block after the buffer is still sequential after a FAT block read.
+// Return 1 for success, 0 for failure or -1 to read the block with CMD17,
+// for FAT and directory blocks, a fragmented file or the end of the card.
+int8_t SdSpiCard::readStream(uint32_t block, uint8_t* dst) {
+  if (streamHit(block, dst)) {
+    return 1;
+  }
+  if (block != m_streamNext && (!m_streamCount || block != m_streamStart + m_streamCount)) {
+    m_streamNext = block + 1;
+    return -1;
+  }
+  m_streamCount = 0;
+  if (!readStart(block)) {
+    return -1;
+  }
+  for (uint8_t b = 0; b < SD_STREAM_BLOCKS; b++) {
+    if (!readData(m_streamBuf[b], 512)) {
+      readStop();
+      return -1;
+    }
+  }
+  if (!readStop()) {
+    return 0;
+  }
+  m_streamStart = block;
+  m_streamCount = SD_STREAM_BLOCKS;
+  return streamHit(block, dst);
+}
+#endif  // SD_STREAM_READ
 //------------------------------------------------------------------------------
 bool SdSpiCard::readData(uint8_t *dst) {
   return readData(dst, 512);
@@ -654,6 +719,9 @@ bool SdSpiCard::waitNotBusy(uint16_t timeoutMS) {
 //------------------------------------------------------------------------------
 bool SdSpiCard::writeBlock(uint32_t blockNumber, const uint8_t* src) {
   SD_TRACE("WB", blockNumber);
+#if ENABLED(SD_STREAM_READ)
+  m_streamCount = 0;
+#endif  // SD_STREAM_READ
   // use address if not SDHC card
   if (type() != SD_CARD_TYPE_SDHC) {
     blockNumber <<= 9;
@@ -749,6 +817,9 @@ fail:
 }
 //------------------------------------------------------------------------------
 bool SdSpiCard::writeStart(uint32_t blockNumber) {
+#if ENABLED(SD_STREAM_READ)
+  m_streamCount = 0;
+#endif  // SD_STREAM_READ
   // use address if not SDHC card
   if (type() != SD_CARD_TYPE_SDHC) {
     blockNumber <<= 9;
@@ -765,6 +836,9 @@ fail:
 }
 //------------------------------------------------------------------------------
 bool SdSpiCard::writeStart(uint32_t blockNumber, uint32_t eraseCount) {
+#if ENABLED(SD_STREAM_READ)
+  m_streamCount = 0;
+#endif  // SD_STREAM_READ
   SD_TRACE("WS", blockNumber);
   // send pre-erase count
   if (cardAcmd(ACMD23, eraseCount)) {
@@ -188,6 +188,16 @@ class SdSpiCard {
    * the value false is returned for failure.
    */
   bool readStop();
+  #if ENABLED(SD_STREAM_READ)
+  /** Read sequential blocks SD_STREAM_BLOCKS at a time with CMD18.
+   *
+   * \param[in] onoff Enable for a file read from start to end, like a print.
+   */
+  void setStreaming(bool onoff) {
+    m_streaming = onoff;
+    m_streamCount = 0;
+  }
+  #endif
   /** \return success if sync successful. Not for user apps. */
   bool syncBlocks() {return true;}
   /** Return the card type: SD V1, SD V2 or SDHC
@@ -273,6 +283,10 @@ class SdSpiCard {
 
   bool waitNotBusy(uint16_t timeoutMS);
   bool writeData(uint8_t token, const uint8_t* src);
+  #if ENABLED(SD_STREAM_READ)
+  int8_t readStream(uint32_t block, uint8_t* dst);
+  bool streamHit(uint32_t block, uint8_t* dst);
+  #endif
 
   //---------------------------------------------------------------------------
   // functions defined in SdSpiDriver.h
@@ -305,6 +319,13 @@ class SdSpiCard {
   bool    m_spiActive;
   uint8_t m_status;
   uint8_t m_type;
+  #if ENABLED(SD_STREAM_READ)
+  bool     m_streaming = false;
+  uint8_t  m_streamCount = 0;
+  uint32_t m_streamStart = 0;
+  uint32_t m_streamNext = 0;
+  uint8_t  m_streamBuf[SD_STREAM_BLOCKS][512];
+  #endif
 };
 //==============================================================================
 /**
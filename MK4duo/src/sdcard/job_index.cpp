@@ -0,0 +1,353 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * job_index.cpp - Layer index of the SD print file
+ */
+
+#include "../../MK4duo.h"
+
+#if ENABLED(SD_JOB_INDEX)
+
+JobIndex job_index;
+
+#if ENABLED(__AVR__)
+  #define JOB_SCAN_SIZE 64
+#else
+  #define JOB_SCAN_SIZE 512
+#endif
+
+#define JOB_KEY_SIZE      offsetof(job_index_header_t, scanned)
+#define JOB_MIN_LAYER     0.01  // A layer is higher than the last one by at least this
+
+constexpr char job_index_name[] = ".jobindex";
+
+/** Public Parameters */
+job_index_header_t JobIndex::header;
+
+/** Private Parameters */
+SdFile      JobIndex::index_file,
+            JobIndex::scan_file;
+
+bool        JobIndex::scanning      = false;
+
+int16_t     JobIndex::cur_layer     = -1;
+job_layer_t JobIndex::cur,
+            JobIndex::next;
+
+uint32_t    JobIndex::line_pos      = 0;
+uint8_t     JobIndex::line_len      = 0;
+char        JobIndex::line_buf[96];
+bool        JobIndex::relative_xyz  = false,
+            JobIndex::relative_e    = false;
+float       JobIndex::position[XYZE],
+            JobIndex::feedrate      = 0,
+            JobIndex::filament      = 0,
+            JobIndex::time          = 0,
+            JobIndex::layer_z       = 0;
+job_layer_t JobIndex::z_move;
+
+/** Public Function */
+void JobIndex::select(SdFile &file) {
+
+  close();
+
+  dir_t entry;
+  if (!file.dirEntry(&entry) || !entry.fileSize) return;
+  if (!index_file.open(&card.root, job_index_name, O_RDWR | O_CREAT)) return;
+
+  job_index_header_t key;
+  memset(&key, 0, sizeof(key));
+  key.cluster = uint32_t(entry.firstClusterHigh) << 16 | entry.firstClusterLow;
+  key.size    = entry.fileSize;
+  key.date    = entry.lastWriteDate;
+  key.time    = entry.lastWriteTime;
+
+  // The index of another file, or one that was not finished
+  if (index_file.read(&header, sizeof(header)) != int(sizeof(header))
+    || memcmp(&header, &key, JOB_KEY_SIZE) || header.scanned != header.size
+  ) {
+    header = key;
+    scan_file = file;
+    start_scan();
+  }
+}
+
+void JobIndex::close() {
+  scanning = false;
+  scan_file.close();
+  index_file.close();
+  cur.pos = next.pos = 0;
+}
+
+void JobIndex::update() {
+
+  if (!scanning || !card.isDetected() || card.isSaving()
+    || (card.isSDprinting() && !commands.buffer_ring.isFull())
+  ) return;
+
+  uint8_t buf[JOB_SCAN_SIZE];
+  const int16_t n = scan_file.read(buf, sizeof(buf));
+  if (n < 0) return close();
+
+  for (int16_t i = 0; i < n; i++) {
+    const char c = buf[i];
+    if (c == '\n' || c == '\r') {
+      if (line_len) scan_line();
+      line_len = 0;
+    }
+    else if (line_len < sizeof(line_buf) - 1) {
+      if (!line_len) line_pos = header.scanned + i;
+      line_buf[line_len++] = c;
+    }
+  }
+  header.scanned += n;
+
+  if (!n || header.scanned >= header.size) end_scan();
+}
+
+uint8_t JobIndex::percent_done(const uint32_t pos) {
+  const uint32_t done = time_at(pos);
+  printer.currentLayer  = cur_layer + 1;
+  printer.maxLayer      = header.layers;
+  return header.total_time ? MIN(100UL, done * 100UL / header.total_time) : 0;
+}
+
+uint32_t JobIndex::time_left(const uint32_t pos) {
+  const uint32_t done = time_at(pos);
+  float left = header.total_time - done;
+  const uint32_t elapsed = print_job_counter.duration();
+  if (done > 60 && elapsed) left *= float(elapsed) / done;
+  return left;
+}
+
+bool JobIndex::get_layer(const int16_t layer, job_layer_t &data) {
+  return ready() && WITHIN(layer, 0, int16_t(header.layers) - 1) && read_layer(layer, data);
+}
+
+bool JobIndex::find_layer(const uint32_t pos, job_layer_t &data) {
+  if (!ready()) return false;
+  seek(pos);
+  if (cur_layer < 0) return false;
+  data = cur;
+  return true;
+}
+
+/** Private Function */
+
+// Layer -1 is the start of the file, layer header.layers the end
+bool JobIndex::read_layer(const int16_t layer, job_layer_t &data) {
+  if (layer < 0 || layer >= int16_t(header.layers)) {
+    memset(&data, 0, sizeof(data));
+    if (layer >= 0) {
+      data.pos      = header.size;
+      data.filament = header.total_filament;
+      data.time     = header.total_time;
+    }
+    return true;
+  }
+  return index_file.seekSet(sizeof(header) + uint32_t(layer) * sizeof(job_layer_t))
+      && index_file.read(&data, sizeof(data)) == int(sizeof(data));
+}
+
+/**
+ * Keep cur and next around pos: while printing the next layer
+ * is read when pos gets there, after a jump it is searched.
+ */
+void JobIndex::seek(const uint32_t pos) {
+  if (pos >= cur.pos && pos < next.pos) return;
+
+  if (next.pos && pos >= next.pos && cur_layer < int16_t(header.layers) - 1) {
+    job_layer_t after;
+    if (read_layer(cur_layer + 2, after) && pos < after.pos) {
+      cur_layer++;
+      cur = next;
+      next = after;
+      return;
+    }
+  }
+
+  // Last layer that starts at or before pos
+  int16_t lo = 0, hi = int16_t(header.layers) - 1;
+  cur_layer = -1;
+  while (lo <= hi) {
+    const int16_t mid = (lo + hi) >> 1;
+    if (!read_layer(mid, cur)) break;
+    if (cur.pos <= pos) { cur_layer = mid; lo = mid + 1; }
+    else hi = mid - 1;
+  }
+  read_layer(cur_layer, cur);
+  read_layer(cur_layer + 1, next);
+}
+
+// Estimated print time at pos, linear in the bytes inside a layer
+uint32_t JobIndex::time_at(const uint32_t pos) {
+  seek(pos);
+  if (pos <= cur.pos || next.pos <= cur.pos) return cur.time;
+  return cur.time + uint32_t(float(next.time - cur.time) * (pos - cur.pos) / (next.pos - cur.pos));
+}
+
+void JobIndex::start_scan() {
+  if (!index_file.truncate(0) || index_file.write(&header, sizeof(header)) != int(sizeof(header))
+    || !scan_file.seekSet(0)
+  ) return close();
+
+  line_len      = 0;
+  relative_xyz  = relative_e = false;
+  ZERO(position);
+  feedrate      = 1500;   // mm/min, up to the first F
+  filament      = 0;
+  time          = 0;
+  layer_z       = -1;
+  memset(&z_move, 0, sizeof(z_move));
+  scanning      = true;
+}
+
+void JobIndex::end_scan() {
+  if (line_len) scan_line();
+  scanning = false;
+  scan_file.close();
+
+  header.scanned        = header.size;
+  header.total_time     = time;
+  header.total_filament = filament;
+  if (!index_file.seekSet(0) || index_file.write(&header, sizeof(header)) != int(sizeof(header)) || !index_file.sync())
+    return close();
+
+  cur.pos = next.pos = 0;
+}
+
+/**
+ * The moves give the time, from the feedrate only, and the filament.
+ * A layer starts at the last move that changed Z before an extrusion
+ * higher than the last layer, so a Z hop is not a layer.
+ */
+void JobIndex::scan_line() {
+  line_buf[line_len] = '\0';
+
+  char *p = line_buf;
+  while (*p == ' ') p++;
+  if (*p == 'N') {
+    while (*p && *p != ' ') p++;
+    while (*p == ' ') p++;
+  }
+
+  const char letter = *p++;
+  if (letter != 'G' && letter != 'M') return;
+  if (!NUMERIC(*p)) return;
+  const int code = GCodeParser::parse_long(p);
+  while (NUMERIC(*p)) p++;
+
+  if (letter == 'M') {
+    if (code == 82) relative_e = false;
+    else if (code == 83) relative_e = true;
+    return;
+  }
+
+  // Parameters of the line
+  float value[XYZE], f = 0, i = 0, j = 0, r = 0, wait = 0;
+  bool seen[XYZE] = { false }, seen_f = false, seen_any = false;
+  for (char *s = p; *s && *s != ';'; s++) {
+    const char c = *s;
+    if (c < 'A' || c > 'Z') continue;
+    const float v = GCodeParser::parse_float(s + 1);
+    switch (c) {
+      case 'X': value[X_AXIS] = v; seen[X_AXIS] = true; break;
+      case 'Y': value[Y_AXIS] = v; seen[Y_AXIS] = true; break;
+      case 'Z': value[Z_AXIS] = v; seen[Z_AXIS] = true; break;
+      case 'E': value[E_AXIS] = v; seen[E_AXIS] = true; break;
+      case 'F': f = v; seen_f = true; break;
+      case 'I': i = v; break;
+      case 'J': j = v; break;
+      case 'R': r = v; break;
+      case 'P': wait = v / 1000.0; break;
+      case 'S': wait = v; break;
+    }
+    seen_any = true;
+  }
+
+  switch (code) {
+
+    case 0: case 1: case 2: case 3: {
+      float target[XYZE];
+      LOOP_XYZE(a) {
+        const bool rel = (a == E_AXIS) ? relative_e : relative_xyz;
+        target[a] = seen[a] ? (rel ? position[a] + value[a] : value[a]) : position[a];
+      }
+
+      const float dx = target[X_AXIS] - position[X_AXIS],
+                  dy = target[Y_AXIS] - position[Y_AXIS],
+                  dz = target[Z_AXIS] - position[Z_AXIS],
+                  de = target[E_AXIS] - position[E_AXIS];
+
+      // The state before the line, to start the layer again from here
+      if (dz) {
+        z_move.z        = target[Z_AXIS];
+        z_move.pos      = line_pos;
+        z_move.e        = position[E_AXIS];
+        z_move.feedrate = feedrate;
+        z_move.filament = filament;
+        z_move.time     = time;
+      }
+
+      float length;
+      if (code >= 2 && !r && (i || j)) {
+        const float cx = position[X_AXIS] + i, cy = position[Y_AXIS] + j,
+                    radius = HYPOT(i, j);
+        float angle = ATAN2(target[Y_AXIS] - cy, target[X_AXIS] - cx) - ATAN2(-j, -i);
+        if (code == 2 && angle >= 0) angle -= RADIANS(360);
+        if (code == 3 && angle <= 0) angle += RADIANS(360);
+        length = HYPOT(ABS(angle) * radius, dz);
+      }
+      else
+        length = SQRT(sq(dx) + sq(dy) + sq(dz));
+      if (length < 0.0001) length = ABS(de);
+
+      if (seen_f && f > 0) feedrate = f;
+      time += length * 60.0 / feedrate;
+      if (de > 0) filament += de;
+
+      if (de > 0 && (dx || dy) && z_move.z > layer_z + JOB_MIN_LAYER) add_layer();
+
+      COPY_ARRAY(position, target);
+    } break;
+
+    case 4: time += wait; break;
+
+    case 28: LOOP_XYZ(a) if (seen[a] || !seen_any) position[a] = 0; break;
+
+    case 90: relative_xyz = relative_e = false; break;
+    case 91: relative_xyz = relative_e = true; break;
+
+    case 92: LOOP_XYZE(a) if (seen[a]) position[a] = value[a]; break;
+
+    default: break;
+  }
+}
+
+void JobIndex::add_layer() {
+  if (index_file.write(&z_move, sizeof(z_move)) != int(sizeof(z_move))) return close();
+  header.layers++;
+  layer_z = z_move.z;
+}
+
+#endif // SD_JOB_INDEX
@@ -0,0 +1,145 @@
+/**
+ * MK4duo Firmware for 3D Printer, Laser and CNC
+ *
+ * Based on Marlin, Sprinter and grbl
+ * Copyright (C) 2011 Camiel Gubbels / Erik van der Zalm
+ * Copyright (C) 2019 Alberto Cotronei @MagoKimbra
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * job_index.h - Layer index of the SD print file
+ *
+ * The file selected with M23 is read in the background, a block at a time
+ * while the printer is idle or the command buffer is full, and for each
+ * layer the file position of the move to its height, the E position, the
+ * filament used and the estimated print time up to there are written in a
+ * hidden file in the root of the card. The index is kept for the last file
+ * selected, so printing it again or resuming it after power loss does not
+ * read the file again. A file that is changed is read again.
+ *
+ * With the index the progress is the estimated print time done instead of
+ * the bytes read, M26 L<layer> and M800 L start a layer from its beginning.
+ */
+
+#if ENABLED(SD_JOB_INDEX)
+
+// A layer of the job
+typedef struct {
+  float     z;              // Height of the layer
+  uint32_t  pos;            // File position of the move to the height
+  float     e,              // E position before the move
+            feedrate,       // Feedrate before the move, mm/min
+            filament;       // Filament used up to the layer, mm
+  uint32_t  time;           // Estimated print time up to the layer, seconds
+} job_layer_t;
+
+// Index file header, the key of the file first
+typedef struct {
+  uint32_t  cluster,        // First cluster, size and last write of the file
+            size;
+  uint16_t  date,
+            time;
+  uint32_t  scanned,        // Bytes of the file read, size when complete
+            total_time;     // Estimated print time, seconds
+  float     total_filament; // Filament used, mm
+  uint16_t  layers;
+} job_index_header_t;
+
+class JobIndex {
+
+  public: /** Constructor */
+
+    JobIndex() {}
+
+  public: /** Public Parameters */
+
+    static job_index_header_t header;
+
+  private: /** Private Parameters */
+
+    static SdFile   index_file,
+                    scan_file;
+
+    static bool     scanning;
+
+    // Layers around the last position asked, -1 is the start of the file
+    static int16_t  cur_layer;
+    static job_layer_t  cur,
+                        next;
+
+    // Scanner state
+    static uint32_t line_pos;         // File position of the line in line_buf
+    static uint8_t  line_len;
+    static char     line_buf[96];
+    static bool     relative_xyz,
+                    relative_e;
+    static float    position[XYZE],
+                    feedrate,
+                    filament,
+                    time,
+                    layer_z;          // Height of the last layer found
+    static job_layer_t  z_move;       // State at the last move that changed Z
+
+  public: /** Public Function */
+
+    /**
+     * Use the index of a file just opened, or start to read it
+     */
+    static void select(SdFile &file);
+    static void close();
+
+    /**
+     * Read a block of the file for the index
+     */
+    static void update();
+
+    static inline bool ready() { return index_file.isOpen() && header.size && header.scanned == header.size; }
+
+    /**
+     * Estimated print time done up to a file position, in percent.
+     * Sets the current and the total layer of the printer.
+     */
+    static uint8_t percent_done(const uint32_t pos);
+
+    /**
+     * Estimated print time left in seconds, scaled by the time really taken so far
+     */
+    static uint32_t time_left(const uint32_t pos);
+
+    /**
+     * Layer 0..layers-1, or the layer that has a file position
+     */
+    static bool get_layer(const int16_t layer, job_layer_t &data);
+    static bool find_layer(const uint32_t pos, job_layer_t &data);
+
+  private: /** Private Function */
+
+    static bool read_layer(const int16_t layer, job_layer_t &data);
+    static void seek(const uint32_t pos);
+    static uint32_t time_at(const uint32_t pos);
+
+    static void start_scan();
+    static void end_scan();
+    static void scan_line();
+    static void add_layer();
+
+};
+
+extern JobIndex job_index;
+
+#endif // SD_JOB_INDEX
@@ -38,6 +38,35 @@
   #if DISABLED(SD_FINISHED_RELEASECOMMAND)
     #error "DEPENDENCY ERROR: Missing setting SD_FINISHED_RELEASECOMMAND."
   #endif
+  #if ENABLED(SD_READ_AHEAD)
+    #if DISABLED(SD_READ_AHEAD_BLOCKS)
+      #error "DEPENDENCY ERROR: Missing setting SD_READ_AHEAD_BLOCKS."
+    #elif SD_READ_AHEAD_BLOCKS < 1 || SD_READ_AHEAD_BLOCKS > 8
+      #error "DEPENDENCY ERROR: SD_READ_AHEAD_BLOCKS must be between 1 and 8."
+    #endif
+  #endif
+  #if ENABLED(SDSORT_INDEX) && DISABLED(SDCARD_SORT_ALPHA)
+    #error "DEPENDENCY ERROR: SDSORT_INDEX requires SDCARD_SORT_ALPHA."
+  #endif
+  #if ENABLED(SDSORT_INDEX_FILE) && DISABLED(SDSORT_INDEX)
+    #error "DEPENDENCY ERROR: SDSORT_INDEX_FILE requires SDSORT_INDEX."
+  #endif
+  #if ENABLED(GCODE_INFO_INDEX)
+    #if DISABLED(JSON_OUTPUT)
+      #error "DEPENDENCY ERROR: GCODE_INFO_INDEX requires JSON_OUTPUT."
+    #elif DISABLED(GCODE_INFO_INDEX_BUCKETS)
+      #error "DEPENDENCY ERROR: Missing setting GCODE_INFO_INDEX_BUCKETS."
+    #elif GCODE_INFO_INDEX_BUCKETS < 1 || GCODE_INFO_INDEX_BUCKETS > 256
+      #error "DEPENDENCY ERROR: GCODE_INFO_INDEX_BUCKETS must be between 1 and 256."
+    #endif
+  #endif
+  #if ENABLED(SD_STREAM_READ)
+    #if DISABLED(SD_STREAM_BLOCKS)
+      #error "DEPENDENCY ERROR: Missing setting SD_STREAM_BLOCKS."
+    #elif SD_STREAM_BLOCKS < 2 || SD_STREAM_BLOCKS > 16
+      #error "DEPENDENCY ERROR: SD_STREAM_BLOCKS must be between 2 and 16."
+    #endif
+  #endif
 #elif ENABLED(EEPROM_SETTINGS) && ENABLED(EEPROM_SD)
   #error "DEPENDENCY ERROR: You have to enable SDSUPPORT || USB_FLASH_DRIVE_SUPPORT to use EEPROM_SD."
 #endif
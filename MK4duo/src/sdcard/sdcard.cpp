@@ -56,11 +56,25 @@ uint16_t SDCard::nrFile_index = 0;
   SdFile SDCard::eeprom_file;
 #endif
 
+#if ENABLED(GCODE_INFO_INDEX)
+  uint32_t  SDCard::info_index_pos    = 0;
+  bool      SDCard::info_index_done   = false;
+  watch_t   SDCard::info_index_watch(1000UL);
+#endif
+
 uint16_t  SDCard::workDirDepth  = 0,
           SDCard::nrFiles       = 0;
 
 LsActionEnum SDCard::lsAction   = LS_Count;
 
+#if ENABLED(SD_READ_AHEAD)
+  uint8_t   SDCard::ahead_buf[2][SD_READ_AHEAD_SIZE];
+  uint32_t  SDCard::ahead_start[2]  = { 0, 0 };
+  uint16_t  SDCard::ahead_len[2]    = { 0, 0 },
+            SDCard::ahead_pos       = 0;
+  uint8_t   SDCard::ahead_front     = 0;
+#endif
+
 // Sort files and folders alphabetically.
 #if ENABLED(SDCARD_SORT_ALPHA)
   uint16_t SDCard::sort_count = 0;
@@ -71,7 +85,12 @@ LsActionEnum SDCard::lsAction   = LS_Count;
   #endif
 
   // By default the sort index is static
-  #if ENABLED(SDSORT_DYNAMIC_RAM)
+  #if ENABLED(SDSORT_INDEX)
+    uint16_t *SDCard::sort_index = NULL;
+    #if ENABLED(SDSORT_INDEX_FILE)
+      uint32_t SDCard::sort_check = 0;
+    #endif
+  #elif ENABLED(SDSORT_DYNAMIC_RAM)
     uint8_t *SDCard::sort_order;
   #else
     uint8_t SDCard::sort_order[SDSORT_LIMIT];
@@ -132,6 +151,14 @@ LsActionEnum SDCard::lsAction   = LS_Count;
 
 #endif
 
+#if ENABLED(SDSORT_INDEX_FILE)
+  // FNV-1a hash of a name
+  static uint32_t name_hash(uint32_t hash, const char* name) {
+    while (*name) hash = (hash ^ uint8_t(*name++)) * 16777619UL;
+    return hash;
+  }
+#endif
+
 /** Public Function */
 
 void SDCard::mount() {
@@ -187,6 +214,9 @@ void SDCard::mount() {
 void SDCard::unmount() {
   setDetect(false);
   setSDprinting(false);
+  #if ENABLED(SD_JOB_INDEX)
+    job_index.close();
+  #endif
 }
 
 void SDCard::ls() {
@@ -251,8 +281,22 @@ void SDCard::openAndPrintFile(PGM_P name) {
 void SDCard::stopSDPrint() {
   setSDprinting(false);
   if (isFileOpen()) gcode_file.close();
+  #if ENABLED(SD_JOB_INDEX)
+    job_index.close();
+  #endif
 }
 
+#if ENABLED(SD_JOB_INDEX)
+
+  // Estimated print time done with the layer index, or bytes read
+  uint8_t SDCard::percentDone() {
+    if (!isFileOpen() || !fileSize) return 0;
+    if (job_index.ready()) return job_index.percent_done(sdpos);
+    return sdpos / ((fileSize + 99) / 100);
+  }
+
+#endif
+
 void SDCard::write_command(char* buf) {
   char* begin = buf;
   char* npos = 0;
@@ -304,8 +348,21 @@ void SDCard::deleteFile(char *filename) {
   if (!isDetected()) return;
   setSDprinting(false);
   gcode_file.close();
+  #if ENABLED(SDSORT_INDEX)
+    uint16_t entry = 0xFFFF;
+    if (sort_index && workDirDepth == 0) {
+      SdFile file;
+      if (file.open(fat.vwd(), filename, O_READ)) {
+        entry = file.dirIndex();
+        file.close();
+      }
+    }
+  #endif
   if (fat.remove(filename)) {
     SERIAL_EMT(MSG_SD_FILE_DELETED, filename);
+    #if ENABLED(SDSORT_INDEX)
+      sort_remove(entry);
+    #endif
   }
   else {
     if (fat.rmdir(filename)) {
@@ -322,8 +379,27 @@ void SDCard::deleteFile(char *filename) {
 
 void SDCard::finishWrite() {
   gcode_file.sync();
+  #if ENABLED(SDSORT_INDEX)
+    // A new file in the root, add it to the index of the root
+    if (sort_index && workDirDepth == 0) {
+      const uint16_t entry = gcode_file.dirIndex();
+      uint16_t i = 0;
+      while (i < sort_count && (sort_index[i] & 0x7FFF) != entry) i++;
+      if (i == sort_count && entry < 0x8000) {
+        uint16_t * const index = (uint16_t*)realloc(sort_index, (sort_count + 1) * sizeof(uint16_t));
+        if (index) {
+          sort_index = index;
+          gcode_file.getName(tempLongFilename, LONG_FILENAME_LENGTH);
+          sort_insert(entry);
+        }
+      }
+    }
+  #endif
   gcode_file.close();
   setSaving(false);
+  #if ENABLED(GCODE_INFO_INDEX)
+    restart_info_index();
+  #endif
   SERIAL_EM(MSG_SD_FILE_SAVED);
 }
 
@@ -353,6 +429,10 @@ void SDCard::printingHasFinished() {
   gcode_file.close();
   setSDprinting(false);
 
+  #if ENABLED(SD_JOB_INDEX)
+    job_index.close();
+  #endif
+
   #if HAS_SD_RESTART
     restart.purge_job();
   #endif
@@ -392,6 +472,9 @@ void SDCard::chdir(PGM_P relpath) {
     #if ENABLED(SDCARD_SORT_ALPHA)
       presort();
     #endif
+    #if ENABLED(GCODE_INFO_INDEX)
+      restart_info_index();
+    #endif
   }
 }
 
@@ -433,6 +516,9 @@ void SDCard::setroot() {
   #if ENABLED(SDCARD_SORT_ALPHA)
     presort();
   #endif
+  #if ENABLED(GCODE_INFO_INDEX)
+    restart_info_index();
+  #endif
 }
 
 void SDCard::printEscapeChars(PGM_P s) {
@@ -467,6 +553,9 @@ bool SDCard::selectFile(PGM_P filename, const bool silent/*=false*/) {
 
     fileSize = gcode_file.fileSize();
     sdpos = 0;
+    #if ENABLED(SD_READ_AHEAD)
+      flush_read_ahead();
+    #endif
 
     if (!silent) {
       SERIAL_MT(MSG_SD_FILE_OPENED, fname);
@@ -481,6 +570,10 @@ bool SDCard::selectFile(PGM_P filename, const bool silent/*=false*/) {
       parsejson(gcode_file);
     #endif
 
+    #if ENABLED(SD_JOB_INDEX)
+      job_index.select(gcode_file);
+    #endif
+
     return true;
   }
   else {
@@ -495,20 +588,54 @@ int8_t SDCard::updir() {
     #if ENABLED(SDCARD_SORT_ALPHA)
       presort();
     #endif
+    #if ENABLED(GCODE_INFO_INDEX)
+      restart_info_index();
+    #endif
   }
   return workDirDepth;
 }
 
+#if ENABLED(SD_READ_AHEAD)
+
+  /**
+   * Fill the back buffer while there is time, that is when
+   * the command buffer is full. The file is always read up to
+   * the end of the last buffer filled, so the back one follows.
+   */
+  void SDCard::read_ahead() {
+    const uint8_t back = ahead_front ^ 1;
+    if (isFileOpen() && !ahead_len[back]) fill_read_ahead(back);
+  }
+
+  /**
+   * In a comment everything up to the end of the line is dropped,
+   * so jump there in the front buffer. The end of line is left for get().
+   */
+  void SDCard::skip_comment() {
+    const uint8_t * const buf = ahead_buf[ahead_front];
+    const uint16_t len = ahead_len[ahead_front];
+    uint16_t pos = ahead_pos;
+    while (pos < len && buf[pos] != '\n' && buf[pos] != '\r') pos++;
+    ahead_pos = pos;
+  }
+
+#endif // SD_READ_AHEAD
+
 uint16_t SDCard::getnrfilenames() {
   lsAction = LS_Count;
   nrFiles = 0;
+  #if ENABLED(SDSORT_INDEX_FILE)
+    sort_check = 0;
+  #endif
   lsDive(workDir);
   return nrFiles;
 }
 
 uint16_t SDCard::get_num_Files() {
   return
-    #if ENABLED(SDCARD_SORT_ALPHA) && SDSORT_USES_RAM && SDSORT_CACHE_NAMES
+    #if ENABLED(SDSORT_INDEX)
+      sort_index ? sort_count : getnrfilenames()
+    #elif ENABLED(SDCARD_SORT_ALPHA) && SDSORT_USES_RAM && SDSORT_CACHE_NAMES
       nrFiles // no need to access the SD card for filenames
     #else
       getnrfilenames()
@@ -524,7 +651,7 @@ uint16_t SDCard::get_num_Files() {
 
     if (!isDetected() || restart.job_file.isOpen()) return;
 
-    if (!restart.job_file.open(fat.vwd(), restart_file_name, read ? O_READ : (O_RDWR | O_CREAT | O_SYNC)))
+    if (!restart.job_file.open(fat.vwd(), restart_file_name, read ? O_READ : (O_RDWR | O_CREAT)))
       SERIAL_LMT(ER, MSG_SD_OPEN_FILE_FAIL, restart_file_name);
     else if (!read)
       SERIAL_EMT(MSG_SD_WRITE_TO_FILE, restart_file_name);
@@ -588,12 +715,22 @@ uint16_t SDCard::get_num_Files() {
    * Get the name of a file in the current directory by sort-index
    */
   void SDCard::getfilename_sorted(const uint16_t nr) {
-    getfilename(
-      #if ENABLED(SDSORT_GCODE)
-        sort_alpha &&
-      #endif
-      (nr < sort_count) ? sort_order[nr] : nr
-    );
+    #if ENABLED(SDSORT_INDEX)
+      if (
+        #if ENABLED(SDSORT_GCODE)
+          sort_alpha &&
+        #endif
+        nr < sort_count && getfilename_entry(sort_index[nr])
+      ) return;
+      getfilename(nr);
+    #else
+      getfilename(
+        #if ENABLED(SDSORT_GCODE)
+          sort_alpha &&
+        #endif
+        (nr < sort_count) ? sort_order[nr] : nr
+      );
+    #endif
   }
 
   /**
@@ -614,6 +751,25 @@ uint16_t SDCard::get_num_Files() {
     // Throw away old sort index
     flush_presort();
 
+    #if ENABLED(SDSORT_INDEX)
+
+      // One pass to count the items, one to add them in order to the index.
+      // Each name is compared with about log2(n) names, read by entry index.
+      const uint16_t fileCnt = getnrfilenames();
+      if (fileCnt == 0) return;
+      sort_index = (uint16_t*)malloc(fileCnt * sizeof(uint16_t));
+      if (!sort_index) return;  // Not enough RAM, the folder is not sorted
+      #if ENABLED(SDSORT_INDEX_FILE)
+        if (load_sort_index(fileCnt)) return;
+      #endif
+      lsAction = LS_SortIndex;
+      lsDive(workDir);
+      #if ENABLED(SDSORT_INDEX_FILE)
+        save_sort_index();
+      #endif
+
+    #else // !SDSORT_INDEX
+
     // If there are files, sort up to the limit
     uint16_t fileCnt = getnrfilenames();
     if (fileCnt > 0) {
@@ -779,17 +935,120 @@ uint16_t SDCard::get_num_Files() {
 
       sort_count = fileCnt;
     }
+
+    #endif // !SDSORT_INDEX
   }
 
   void SDCard::flush_presort() {
-    if (sort_count > 0) {
-      #if ENABLED(SDSORT_DYNAMIC_RAM)
-        delete sort_order;
-      #endif
+    #if ENABLED(SDSORT_INDEX)
+      free(sort_index);
+      sort_index = NULL;
       sort_count = 0;
-    }
+    #else
+      if (sort_count > 0) {
+        #if ENABLED(SDSORT_DYNAMIC_RAM)
+          delete sort_order;
+        #endif
+        sort_count = 0;
+      }
+    #endif
   }
 
+  #if ENABLED(SDSORT_INDEX)
+
+    // Name of an item of the current directory by directory entry index
+    bool SDCard::getfilename_entry(const uint16_t entry) {
+      SdFile file;
+      if (!file.open(&workDir, entry & 0x7FFF, O_READ)) return false;
+      file.getName(fileName, LONG_FILENAME_LENGTH);
+      setFilenameIsDir(file.isSubDir());
+      file.close();
+      return true;
+    }
+
+    // The item with the name in tempLongFilename goes before the other
+    bool SDCard::sort_before(const uint16_t entry1, const uint16_t entry2) {
+      #if HAS_FOLDER_SORTING
+        const int fs =
+          #if ENABLED(SDSORT_GCODE)
+            sort_folders
+          #else
+            FOLDER_SORTING
+          #endif
+        ;
+        const bool dir1 = TEST(entry1, 15), dir2 = TEST(entry2, 15);
+        if (fs && dir1 != dir2) return fs < 0 ? dir1 : dir2;
+      #endif
+      return getfilename_entry(entry2) && strcasecmp(tempLongFilename, fileName) < 0;
+    }
+
+    // Binary search, the index must have room for one more item
+    void SDCard::sort_insert(const uint16_t entry) {
+      uint16_t lo = 0, hi = sort_count;
+      while (lo < hi) {
+        const uint16_t mid = (lo + hi) >> 1;
+        if (sort_before(entry, sort_index[mid])) hi = mid; else lo = mid + 1;
+      }
+      memmove(&sort_index[lo + 1], &sort_index[lo], (sort_count - lo) * sizeof(uint16_t));
+      sort_index[lo] = entry;
+      sort_count++;
+    }
+
+    void SDCard::sort_remove(const uint16_t entry) {
+      for (uint16_t i = 0; i < sort_count; i++) {
+        if ((sort_index[i] & 0x7FFF) == entry) {
+          memmove(&sort_index[i], &sort_index[i + 1], (--sort_count - i) * sizeof(uint16_t));
+          return;
+        }
+      }
+    }
+
+    #if ENABLED(SDSORT_INDEX_FILE)
+
+      /**
+       * The file is the index of one folder, with the hash of the entries and
+       * names of the folder made by the count pass, so an index that does not
+       * match the folder any more is not used.
+       */
+      typedef struct {
+        uint32_t  cluster,        // First cluster of the folder
+                  check;          // sort_check of the folder
+        uint16_t  count;
+      } sort_index_header_t;
+
+      constexpr char sort_index_name[] = ".sortindex";
+
+      bool SDCard::load_sort_index(const uint16_t count) {
+        SdFile index;
+        if (!index.open(&root, sort_index_name, O_READ)) return false;
+        sort_index_header_t header;
+        const int size = count * sizeof(uint16_t);
+        const bool loaded = index.read(&header, sizeof(header)) == int(sizeof(header))
+                         && header.cluster == workDir.firstCluster()
+                         && header.check == sort_check
+                         && header.count == count
+                         && index.read(sort_index, size) == size;
+        index.close();
+        if (loaded) sort_count = count;
+        return loaded;
+      }
+
+      void SDCard::save_sort_index() {
+        SdFile index;
+        if (!index.open(&root, sort_index_name, O_WRITE | O_CREAT | O_TRUNC)) return;
+        sort_index_header_t header;
+        header.cluster  = workDir.firstCluster();
+        header.check    = sort_check;
+        header.count    = sort_count;
+        index.write(&header, sizeof(header));
+        index.write(sort_index, sort_count * sizeof(uint16_t));
+        index.close();
+      }
+
+    #endif // SDSORT_INDEX_FILE
+
+  #endif // SDSORT_INDEX
+
 #endif // SDCARD_SORT_ALPHA
 
 #if ENABLED(ADVANCED_SD_COMMAND)
@@ -864,6 +1123,41 @@ uint16_t SDCard::get_num_Files() {
 #endif
 
 /** Private Function */
+
+#if ENABLED(SD_READ_AHEAD)
+
+  // The file position changed, drop what was read ahead
+  void SDCard::flush_read_ahead() {
+    ahead_len[0] = ahead_len[1] = 0;
+    ahead_pos = 0;
+  }
+
+  /**
+   * Read the next part of the file in a buffer. After a seek the first
+   * read stops at the block boundary, then all reads are whole blocks
+   * that SdFat copies straight from the card, with multi-block reads.
+   */
+  void SDCard::fill_read_ahead(const uint8_t b) {
+    ahead_start[b] = gcode_file.curPosition();
+    const int16_t n = gcode_file.read(ahead_buf[b], SD_READ_AHEAD_SIZE - (ahead_start[b] & 0x1FF));
+    ahead_len[b] = n > 0 ? n : 0;
+  }
+
+  // The front buffer is done, go on with the back one
+  int16_t SDCard::get_next_buffer() {
+    ahead_len[ahead_front] = 0;
+    ahead_front ^= 1;
+    ahead_pos = 0;
+    if (!ahead_len[ahead_front] && isFileOpen()) fill_read_ahead(ahead_front);
+    if (!ahead_len[ahead_front]) {
+      sdpos = gcode_file.curPosition();
+      return -1;
+    }
+    sdpos = ahead_start[ahead_front];
+    return ahead_buf[ahead_front][ahead_pos++];
+  }
+
+#endif // SD_READ_AHEAD
 /**
  * Dive into a folder and recurse depth-first to perform a pre-set operation lsAction:
  *   LS_Count       - Add +1 to nrFiles for every file within the parent
@@ -898,6 +1192,17 @@ void SDCard::lsDive(SdFile parent, PGM_P const match/*=NULL*/) {
     switch (lsAction) {
       case LS_Count:
         nrFiles++;
+        #if ENABLED(SDSORT_INDEX_FILE)
+          sort_check = name_hash(sort_check ^ file.dirIndex(), tempLongFilename);
+        #endif
+        file.close();
+        break;
+      case LS_SortIndex:
+        #if ENABLED(SDSORT_INDEX)
+          // nrFiles is the count of the first pass, the size of the index
+          if (sort_count < nrFiles && file.dirIndex() < 0x8000)
+            sort_insert(file.dirIndex() | (file.isSubDir() ? 0x8000 : 0));
+        #endif
         file.close();
         break;
       case LS_GetFilename:
@@ -935,6 +1240,31 @@ void SDCard::parsejson(SdFile &parser_file) {
 
   if (!parser_file.isOpen()) return;
 
+  gcode_info_t info;
+  #if ENABLED(GCODE_INFO_INDEX)
+    const bool has_key = get_info_key(parser_file, info);
+    if (!has_key || !read_info_index(info)) {
+      scan_info(parser_file, info);
+      if (has_key) write_info_index(info);
+    }
+  #else
+    scan_info(parser_file, info);
+  #endif
+
+  objectHeight      = info.objectHeight;
+  firstlayerHeight  = info.firstlayerHeight;
+  layerHeight       = info.layerHeight;
+  filamentNeeded    = info.filamentNeeded;
+  strcpy(generatedBy, info.generatedBy);
+}
+
+void SDCard::scan_info(SdFile &parser_file, gcode_info_t &info) {
+  info.filamentNeeded   = 0.0;
+  info.objectHeight     = 0.0;
+  info.firstlayerHeight = 0.0;
+  info.layerHeight      = 0.0;
+  info.generatedBy[0]   = '\0';
+
   bool genByFound = false, firstlayerHeightFound = false, layerHeightFound = false, filamentNeedFound = false;
 
   #if ENABLED(__AVR__)
@@ -948,10 +1278,10 @@ void SDCard::parsejson(SdFile &parser_file) {
   for (int i = 0; i < 4096; i += GCI_BUF_SIZE - 50) {
     if(!parser_file.seekSet(i)) break;
     parser_file.read(buf, GCI_BUF_SIZE);
-    if (!genByFound && findGeneratedBy(buf, generatedBy)) genByFound = true;
-    if (!firstlayerHeightFound && findFirstLayerHeight(buf, firstlayerHeight)) firstlayerHeightFound = true;
-    if (!layerHeightFound && findLayerHeight(buf, layerHeight)) layerHeightFound = true;
-    if (!filamentNeedFound && findFilamentNeed(buf, filamentNeeded)) filamentNeedFound = true;
+    if (!genByFound && findGeneratedBy(buf, info.generatedBy)) genByFound = true;
+    if (!firstlayerHeightFound && findFirstLayerHeight(buf, info.firstlayerHeight)) firstlayerHeightFound = true;
+    if (!layerHeightFound && findLayerHeight(buf, info.layerHeight)) layerHeightFound = true;
+    if (!filamentNeedFound && findFilamentNeed(buf, info.filamentNeeded)) filamentNeedFound = true;
     if(genByFound && layerHeightFound && filamentNeedFound) goto get_objectHeight;
   }
 
@@ -959,10 +1289,10 @@ void SDCard::parsejson(SdFile &parser_file) {
   for (int i = 0; i < 4096; i += GCI_BUF_SIZE - 50) {
     if(!parser_file.seekEnd(-4096 + i)) break;
     parser_file.read(buf, GCI_BUF_SIZE);
-    if (!genByFound && findGeneratedBy(buf, generatedBy)) genByFound = true;
-    if (!firstlayerHeightFound && findFirstLayerHeight(buf, firstlayerHeight)) firstlayerHeightFound = true;
-    if (!layerHeightFound && findLayerHeight(buf, layerHeight)) layerHeightFound = true;
-    if (!filamentNeedFound && findFilamentNeed(buf, filamentNeeded)) filamentNeedFound = true;
+    if (!genByFound && findGeneratedBy(buf, info.generatedBy)) genByFound = true;
+    if (!firstlayerHeightFound && findFirstLayerHeight(buf, info.firstlayerHeight)) firstlayerHeightFound = true;
+    if (!layerHeightFound && findLayerHeight(buf, info.layerHeight)) layerHeightFound = true;
+    if (!filamentNeedFound && findFilamentNeed(buf, info.filamentNeeded)) filamentNeedFound = true;
     if(genByFound && layerHeightFound && filamentNeedFound) goto get_objectHeight;
   }
 
@@ -971,11 +1301,134 @@ void SDCard::parsejson(SdFile &parser_file) {
   for (int i = GCI_BUF_SIZE; i < 30000; i += GCI_BUF_SIZE - 50) {
     if(!parser_file.seekEnd(-i)) break;
     parser_file.read(buf, GCI_BUF_SIZE);
-    if (findTotalHeight(buf, objectHeight)) break;
+    if (findTotalHeight(buf, info.objectHeight)) break;
   }
   parser_file.rewind();
 }
 
+#if ENABLED(GCODE_INFO_INDEX)
+
+  /**
+   * The index is a hidden file in the root of the card, a hash table of
+   * GCODE_INFO_INDEX_BUCKETS buckets of INFO_INDEX_SLOTS entries. A file
+   * is in the bucket of its first cluster and size, and its entry is found
+   * by first cluster, size and last write, so a file that is changed or a
+   * new file in the place of a deleted one is not found and read again.
+   */
+  #define INFO_INDEX_SLOTS  8
+  #define INFO_BUCKET_SIZE  (INFO_INDEX_SLOTS * sizeof(gcode_info_t))
+  #define INFO_INDEX_SIZE   (GCODE_INFO_INDEX_BUCKETS * INFO_BUCKET_SIZE)
+  #define INFO_KEY_SIZE     offsetof(gcode_info_t, objectHeight)
+
+  constexpr char info_index_name[] = ".gcodeinfo";
+
+  static inline uint32_t info_bucket_pos(const gcode_info_t &info) {
+    return ((info.cluster ^ info.size) % GCODE_INFO_INDEX_BUCKETS) * INFO_BUCKET_SIZE;
+  }
+
+  /**
+   * Add the files of the current folder to the index, one each second
+   * while the printer is idle, so the next M23 does not read them.
+   */
+  void SDCard::update_info_index() {
+
+    if (info_index_done || !isDetected() || isSDprinting() || isSaving()
+      || !commands.buffer_ring.isEmpty() || planner.has_blocks_queued()
+      || !info_index_watch.elapsed()
+    ) return;
+
+    info_index_watch.start();
+
+    SdFile dir = workDir, file;
+    dir.seekSet(info_index_pos);
+    if (!file.openNext(&dir, O_READ)) {
+      info_index_done = true;
+      return;
+    }
+    info_index_pos = dir.curPosition();
+
+    dir_t entry;
+    gcode_info_t info;
+    if (file.isFile() && !file.isHidden()
+      && file.dirEntry(&entry) && entry.name[8] == 'G'   // .G, .GCO, ...
+      && get_info_key(file, info) && !read_info_index(info)
+    ) {
+      scan_info(file, info);
+      write_info_index(info);
+    }
+    file.close();
+  }
+
+  bool SDCard::open_info_index(SdFile &index) {
+    if (!index.open(&root, info_index_name, O_RDWR | O_CREAT)) return false;
+
+    // A new index, all the entries are empty
+    if (index.fileSize() < INFO_INDEX_SIZE) {
+      gcode_info_t empty;
+      memset(&empty, 0, sizeof(empty));
+      index.seekEnd();
+      while (index.fileSize() < INFO_INDEX_SIZE) {
+        if (index.write(&empty, sizeof(empty)) != int(sizeof(empty))) {
+          index.close();
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool SDCard::get_info_key(SdFile &parser_file, gcode_info_t &info) {
+    dir_t entry;
+    if (!parser_file.dirEntry(&entry) || !entry.fileSize) return false;
+    info.cluster  = uint32_t(entry.firstClusterHigh) << 16 | entry.firstClusterLow;
+    info.size     = entry.fileSize;
+    info.date     = entry.lastWriteDate;
+    info.time     = entry.lastWriteTime;
+    return true;
+  }
+
+  bool SDCard::read_info_index(gcode_info_t &info) {
+    SdFile index;
+    if (!open_info_index(index)) return false;
+
+    bool found = false;
+    gcode_info_t entry;
+    index.seekSet(info_bucket_pos(info));
+    for (uint8_t i = 0; i < INFO_INDEX_SLOTS; i++) {
+      if (index.read(&entry, sizeof(entry)) != int(sizeof(entry))) break;
+      if (!memcmp(&entry, &info, INFO_KEY_SIZE)) {
+        info = entry;
+        found = true;
+        break;
+      }
+    }
+    index.close();
+    return found;
+  }
+
+  // Take an empty entry of the bucket, or one of the old ones if it is full
+  void SDCard::write_info_index(const gcode_info_t &info) {
+    SdFile index;
+    if (!open_info_index(index)) return;
+
+    const uint32_t bucket = info_bucket_pos(info);
+    uint8_t slot = info.time % INFO_INDEX_SLOTS;
+    gcode_info_t entry;
+    index.seekSet(bucket);
+    for (uint8_t i = 0; i < INFO_INDEX_SLOTS; i++) {
+      if (index.read(&entry, sizeof(entry)) != int(sizeof(entry))) break;
+      if (!entry.size) {
+        slot = i;
+        break;
+      }
+    }
+    if (index.seekSet(bucket + slot * sizeof(gcode_info_t)))
+      index.write(&info, sizeof(info));
+    index.close();
+  }
+
+#endif // GCODE_INFO_INDEX
+
 bool SDCard::findGeneratedBy(char* buf, char* genBy) {
   // Slic3r & S3D
   PGM_P generatedByString = PSTR("generated by ");
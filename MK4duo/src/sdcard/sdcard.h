@@ -25,6 +25,10 @@
 
 #include "SdFat/SdFat.h"
 
+#if ENABLED(SD_READ_AHEAD)
+  #define SD_READ_AHEAD_SIZE (SD_READ_AHEAD_BLOCKS * 512)
+#endif
+
 union flagcard_t {
   bool all;
   struct {
@@ -40,6 +44,19 @@ union flagcard_t {
   flagcard_t() { all = false; }
 };
 
+// G-code info of a file, key first
+typedef struct {
+  uint32_t  cluster,            // First cluster, size and last write of the file
+            size;
+  uint16_t  date,
+            time;
+  float     objectHeight,
+            firstlayerHeight,
+            layerHeight,
+            filamentNeeded;
+  char      generatedBy[GENBY_SIZE];
+} gcode_info_t;
+
 class SDCard {
 
   public: /** Constructor */
@@ -74,10 +91,24 @@ class SDCard {
 
     static uint16_t nrFile_index;
 
+    #if ENABLED(SD_READ_AHEAD)
+      static uint8_t  ahead_buf[2][SD_READ_AHEAD_SIZE];
+      static uint32_t ahead_start[2];     // File position of the first byte
+      static uint16_t ahead_len[2],       // Bytes in the buffer, 0 for empty
+                      ahead_pos;          // Next byte of the front buffer
+      static uint8_t  ahead_front;        // Buffer lines are taken from
+    #endif
+
     #if HAS_EEPROM_SD
       static SdFile eeprom_file;
     #endif
 
+    #if ENABLED(GCODE_INFO_INDEX)
+      static uint32_t info_index_pos;     // Next entry of workDir to add to the index
+      static bool     info_index_done;    // All the files of workDir are in the index
+      static watch_t  info_index_watch;
+    #endif
+
     static uint16_t     workDirDepth,
                         nrFiles;          // counter for the files in the current directory and recycled as position counter for getting the nrFiles'th name in the directory.
     static LsActionEnum lsAction;         // stored for recursion.
@@ -92,7 +123,12 @@ class SDCard {
       #endif
 
       // By default the sort index is static
-      #if ENABLED(SDSORT_DYNAMIC_RAM)
+      #if ENABLED(SDSORT_INDEX)
+        static uint16_t *sort_index;      // Directory entry of the items in order, bit 15 for folders
+        #if ENABLED(SDSORT_INDEX_FILE)
+          static uint32_t sort_check;     // Hash of the entries and names of the folder
+        #endif
+      #elif ENABLED(SDSORT_DYNAMIC_RAM)
         static uint8_t *sort_order;
       #else
         static uint8_t sort_order[SDSORT_LIMIT];
@@ -198,6 +234,10 @@ class SDCard {
     static uint16_t getnrfilenames();
     static uint16_t get_num_Files();
 
+    #if ENABLED(GCODE_INFO_INDEX)
+      static void update_info_index();
+    #endif
+
     #if HAS_SD_RESTART
       static void open_restart_file(const bool read);
       static void delete_restart_file();
@@ -230,7 +270,12 @@ class SDCard {
     FORCE_INLINE static bool isSaving() { return flag.Saving; }
 
     // Card flag bit 2 printing
-    FORCE_INLINE static void setSDprinting(const bool onoff) { flag.SDprinting = onoff; }
+    FORCE_INLINE static void setSDprinting(const bool onoff) {
+      flag.SDprinting = onoff;
+      #if ENABLED(SD_STREAM_READ)
+        fat.card()->setStreaming(onoff);
+      #endif
+    }
     FORCE_INLINE static bool isSDprinting() { return flag.SDprinting; }
 
     // Card flag bit 3 Autoreport SD
@@ -248,11 +293,35 @@ class SDCard {
     static inline void pauseSDPrint() { setSDprinting(false); }
     static inline bool isFileOpen()   { return isDetected() && gcode_file.isOpen(); }
     static inline bool isPaused()     { return isFileOpen() && !isSDprinting(); }
-    static inline void setIndex(uint32_t newpos) { sdpos = newpos; gcode_file.seekSet(sdpos); }
     static inline uint32_t getIndex() { return sdpos; }
     static inline bool eof() { return sdpos >= fileSize; }
-    static inline int16_t get() { sdpos = gcode_file.curPosition(); return (int16_t)gcode_file.read(); }
-    static inline uint8_t percentDone() { return (isFileOpen() && fileSize) ? sdpos / ((fileSize + 99) / 100) : 0; }
+
+    #if ENABLED(SD_READ_AHEAD)
+
+      static inline void setIndex(uint32_t newpos) { sdpos = newpos; gcode_file.seekSet(sdpos); flush_read_ahead(); }
+
+      static inline int16_t get() {
+        if (ahead_pos < ahead_len[ahead_front]) {
+          sdpos = ahead_start[ahead_front] + ahead_pos;
+          return ahead_buf[ahead_front][ahead_pos++];
+        }
+        return get_next_buffer();
+      }
+
+      static void read_ahead();
+      static void skip_comment();
+
+    #else
+
+      static inline void setIndex(uint32_t newpos) { sdpos = newpos; gcode_file.seekSet(sdpos); }
+      static inline int16_t get() { sdpos = gcode_file.curPosition(); return (int16_t)gcode_file.read(); }
+
+    #endif
+    #if ENABLED(SD_JOB_INDEX)
+      static uint8_t percentDone();
+    #else
+      static inline uint8_t percentDone() { return (isFileOpen() && fileSize) ? sdpos / ((fileSize + 99) / 100) : 0; }
+    #endif
     static inline void getWorkDirName() { workDir.getName(fileName, LONG_FILENAME_LENGTH); }
     static inline size_t read(void* buf, uint16_t nbyte) { return gcode_file.isOpen() ? gcode_file.read(buf, nbyte) : -1; }
     static inline size_t write(void* buf, uint16_t nbyte) { return gcode_file.isOpen() ? gcode_file.write(buf, nbyte) : -1; }
@@ -268,14 +337,39 @@ class SDCard {
 
     static void lsDive(SdFile parent, PGM_P const match = NULL);
     static void parsejson(SdFile &parser_file);
+    static void scan_info(SdFile &parser_file, gcode_info_t &info);
     static bool findGeneratedBy(char* buf, char* genBy);
     static bool findFirstLayerHeight(char* buf, float &firstlayerHeight);
     static bool findLayerHeight(char* buf, float &layerHeight);
     static bool findFilamentNeed(char* buf, float &filament);
     static bool findTotalHeight(char* buf, float &objectHeight);
 
+    #if ENABLED(GCODE_INFO_INDEX)
+      static inline void restart_info_index() { info_index_pos = 0; info_index_done = false; }
+      static bool open_info_index(SdFile &index);
+      static bool get_info_key(SdFile &parser_file, gcode_info_t &info);
+      static bool read_info_index(gcode_info_t &info);
+      static void write_info_index(const gcode_info_t &info);
+    #endif
+
+    #if ENABLED(SD_READ_AHEAD)
+      static void flush_read_ahead();
+      static void fill_read_ahead(const uint8_t b);
+      static int16_t get_next_buffer();
+    #endif
+
     #if ENABLED(SDCARD_SORT_ALPHA)
       static void flush_presort();
+      #if ENABLED(SDSORT_INDEX)
+        static bool getfilename_entry(const uint16_t entry);
+        static bool sort_before(const uint16_t entry1, const uint16_t entry2);
+        static void sort_insert(const uint16_t entry);
+        static void sort_remove(const uint16_t entry);
+        #if ENABLED(SDSORT_INDEX_FILE)
+          static bool load_sort_index(const uint16_t count);
+          static void save_sort_index();
+        #endif
+      #endif
     #endif
 
     #if ENABLED(ADVANCED_SD_COMMAND)
@@ -0,0 +1,262 @@
+#!/usr/bin/python3
+
+# Stream a G-code file to MK4duo with the binary protocol (BINARY_PROTOCOL).
+#
+# Every line goes in a frame that starts where a text line would:
+#
+#   0xB5 | N low | N high | length | payload | CRC16 low | CRC16 high
+#
+# N is the line number as in "N<n> ... *<checksum>" lines, low 16 bits, and
+# goes on from the text lines. The CRC16 is CCITT (0x1021) starting at 0xFFFF
+# over N, length and payload. The payload is one of:
+#
+#   0, G-code line          any command, without N, checksum and comment
+#   1 or 2, mask, values    G0 or G1, mask bits 0-4 for X Y Z E F, int32
+#                           little endian in 1/10000 mm (F in mm/min)
+#
+# A frame is answered like a line, with "ok" or "Resend: <N>". A G0/G1 with
+# other parameters or values out of range is sent as a G-code line frame.
+#
+# With --port (or --exec, to run the Linux build) the printer is asked for
+# Cap:BINARY_PROTOCOL:1 in the M115 report first, and the file is sent as
+# text lines if it is not there. With Cap:SERIAL_WINDOW:1 the lines are sent
+# in a sliding window after "M110 N0 W1": the ok of the M110 tells the free
+# command buffer slots (B) and RX bytes (R), and the host keeps sent and not
+# yet done lines within B lines plus R bytes. A "Resend: N" then asks for
+# line N alone. --damage breaks some lines once to try the resends.
+# Without --port the frames are written to --out, to feed the Linux build:
+#
+#   binary_stream.py part.gcode --port /dev/ttyACM0 --baud 250000
+#   binary_stream.py part.gcode --exec ./mk4duo --damage 50
+#   binary_stream.py part.gcode --out - | ./mk4duo
+#   binary_stream.py part.gcode --out - --text | ./mk4duo
+
+import argparse
+import os
+import re
+import select
+import struct
+import subprocess
+import sys
+import time
+
+SYNC = 0xB5
+GCODE, G0, G1 = 0, 1, 2
+AXES = 'XYZEF'
+SCALE = 10000
+MAX_PAYLOAD = 95    # MAX_CMD_SIZE - 1
+
+WORD = re.compile(r'([A-Z])([-+]?(?:\d+\.?\d*|\.\d+))$')
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def clean(line):
+    line = line.split(';', 1)[0].strip()
+    return ' '.join(line.split())
+
+
+def payload(line):
+    """Payload of a clean G-code line"""
+    words = line.upper().split(' ')
+    if words[0] in ('G0', 'G1', 'G00', 'G01'):
+        values = {}
+        for w in words[1:]:
+            m = WORD.match(w)
+            if not m or m.group(1) not in AXES or m.group(1) in values:
+                break
+            v = round(float(m.group(2)) * SCALE)
+            if not -2**31 <= v < 2**31:
+                break
+            values[m.group(1)] = v
+        else:
+            mask = sum(1 << i for i, a in enumerate(AXES) if a in values)
+            data = bytes([G0 if int(words[0][1:]) == 0 else G1, mask])
+            for a in AXES:
+                if a in values:
+                    data += struct.pack('<i', values[a])
+            return data
+    data = bytes([GCODE]) + line.encode('ascii', 'replace')
+    if len(data) > MAX_PAYLOAD:
+        sys.exit('line too long: ' + line)
+    return data
+
+
+def frame(n, data):
+    body = struct.pack('<HB', n & 0xFFFF, len(data)) + data
+    return bytes([SYNC]) + body + struct.pack('<H', crc16(body))
+
+
+def text_line(n, line):
+    s = 'N%d %s ' % (n, line)
+    c = 0
+    for ch in s:
+        c ^= ord(ch)
+    return ('%s*%d\n' % (s, c)).encode()
+
+
+def lines(path):
+    with open(path) as f:
+        for line in f:
+            line = clean(line)
+            if line:
+                yield line
+
+
+def encode(path, text, window=False):
+    """All the frames (or lines) of a file, M110 N0 first"""
+    m110 = 'M110 N0 W1' if window else 'M110 N0'
+    out = [text_line(0, m110) if text else frame(0, payload(m110))]
+    for n, line in enumerate(lines(path), 1):
+        out.append(text_line(n, line) if text else frame(n, payload(line)))
+    return out
+
+
+class Printer:
+    """Serial port, or the Linux build on a pipe"""
+
+    def __init__(self, port, baud, command):
+        if command:
+            self.proc = subprocess.Popen(command, shell=True, stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+            self.fd_in, self.fd_out = self.proc.stdout.fileno(), self.proc.stdin.fileno()
+            self.ser = None
+        else:
+            import serial   # pyserial
+            self.ser = serial.Serial(port, baud, timeout=0.05)
+            self.proc = None
+        time.sleep(2)       # Boards reset on open
+        self.read()
+        self.pending = b''
+
+    def write(self, data):
+        if self.ser:
+            self.ser.write(data)
+        else:
+            os.write(self.fd_out, data)
+
+    def read(self):
+        if self.ser:
+            return self.ser.read(self.ser.in_waiting or 1)
+        if not select.select([self.fd_in], [], [], 0.05)[0]:
+            return b''
+        return os.read(self.fd_in, 4096)
+
+    def replies(self):
+        self.pending += self.read()
+        while b'\n' in self.pending:
+            reply, self.pending = self.pending.split(b'\n', 1)
+            yield reply.decode('ascii', 'replace').strip()
+
+    def command(self, line):
+        """Send a text line and return the replies up to its ok"""
+        self.write(line.encode() + b'\n')
+        got, end = [], time.time() + 5
+        while time.time() < end:
+            for reply in self.replies():
+                got.append(reply)
+                if reply.startswith('ok'):
+                    return got
+        return got
+
+    def close(self):
+        if self.proc:
+            self.proc.kill()
+
+
+def stream(printer, path, force_text, use_window, damage):
+    text = force_text
+    caps = '\n'.join(printer.command('M115'))
+    if not text:
+        text = 'Cap:BINARY_PROTOCOL:1' not in caps
+    window = use_window and 'Cap:SERIAL_WINDOW:1' in caps
+    print('sending %s%s' % ('text lines' if text else 'binary frames', ', in a window' if window else ''),
+          file=sys.stderr)
+
+    frames = encode(path, text, window)
+    sent = acked = resends = 0
+    slots, room = 1, 0  # Until the M110 is done
+    damaged = set()
+    skip_ok = False
+    start = time.time()
+    while acked < len(frames):
+
+        # Lines sent and not done: the first slots of them are in the
+        # command buffer, the others must fit in the RX buffer
+        while sent < len(frames):
+            ahead = sum(len(f) for f in frames[acked + slots:sent + 1])
+            if sent - acked >= slots and ahead > room:
+                break
+            data = frames[sent]
+            if damage and sent and sent % damage == 0 and sent not in damaged:
+                damaged.add(sent)
+                data = data[:-3] + bytes([data[-3] ^ 0x20]) + data[-2:]
+            printer.write(data)
+            sent += 1
+
+        for reply in printer.replies():
+            if reply.startswith('ok'):
+                if skip_ok:
+                    skip_ok = False
+                    continue
+                acked += 1
+                if acked == 1 and window:
+                    fields = dict((w[0], int(w[1:])) for w in reply.split()[1:] if w[1:].isdigit())
+                    slots, room = fields.get('B', 1), fields.get('R', 0)
+            elif reply.startswith('Resend:'):
+                n = int(reply.split(':')[1])
+                resends += 1
+                if window:
+                    # Only the line asked, the ones after it are held
+                    printer.write(frames[n])
+                else:
+                    # Go back to the line asked, the "ok" after it is not for a line
+                    sent = acked = n
+                    skip_ok = True
+            elif reply and not reply.startswith(('wait', 'busy', 'echo:busy')):
+                print(reply, file=sys.stderr)
+
+    t = time.time() - start
+    size = sum(len(f) for f in frames)
+    print('%d lines, %d bytes in %.1f s, %.0f lines/s, %d resends' %
+          (len(frames), size, t, len(frames) / max(t, 1e-6), resends), file=sys.stderr)
+    return printer.command('M114')
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Stream G-code to MK4duo with binary frames')
+    ap.add_argument('file')
+    ap.add_argument('--port', help='serial port, else the frames go to --out')
+    ap.add_argument('--baud', type=int, default=250000)
+    ap.add_argument('--exec', help='run this command as the printer, like the Linux build')
+    ap.add_argument('--no-window', action='store_true', help='one ok per line, even with SERIAL_WINDOW')
+    ap.add_argument('--damage', type=int, default=0, help='break every N-th line once')
+    ap.add_argument('--out', default='-', help='output file without --port, - for stdout')
+    ap.add_argument('--text', action='store_true', help='send text lines with N and checksum')
+    args = ap.parse_args()
+
+    if args.port or args.exec:
+        printer = Printer(args.port, args.baud, args.exec)
+        try:
+            for reply in stream(printer, args.file, args.text, not args.no_window, args.damage):
+                print(reply)
+        finally:
+            printer.close()
+        return
+
+    frames = encode(args.file, args.text)
+    out = sys.stdout.buffer if args.out == '-' else open(args.out, 'wb')
+    for f in frames:
+        out.write(f)
+    out.flush()
+    size = sum(len(f) for f in frames)
+    print('%d lines, %d bytes, %.1f bytes per line' % (len(frames), size, size / len(frames)), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
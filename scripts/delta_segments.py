@@ -0,0 +1,237 @@
+#!/usr/bin/python3
+
+# Compare the delta move segmentation modes of MK4duo on a G-code file.
+#
+# A delta move is split in lines, and the towers move in a straight line
+# between the ends of each one: the effector bows away from the cartesian
+# line, a little near the centre and more near the towers. For every G0/G1
+# move this counts the planner blocks of the fixed mode (segments per second
+# grouped by segments per line), of one block per segment, of
+# DELTA_ADAPTIVE_SEGMENTS and of DELTA_ADAPTIVE_SEGMENTS with
+# DELTA_STEP_INTERPOLATION (the towers on a parabola through the ends and the
+# middle of each line, split where a tower turns), and measures the real path
+# error of each with the same kinematics as the firmware. The blocks are
+# counted by the farthest radius the move reaches.
+#
+# The geometry comes from Configuration_Delta.h, the options override it.
+# Without a file a job with chords, circles and short segments is made.
+#
+#   delta_segments.py
+#   delta_segments.py part.gcode --max-error 0.02
+#   delta_segments.py part.gcode --config ../MK4duo/Configuration_Delta.h --radius 105
+
+import argparse
+import math
+import os
+import re
+import tempfile
+
+CONFIG = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'MK4duo', 'Configuration_Delta.h')
+
+
+class Delta:
+
+    def __init__(self, rod, radius):
+        self.rod2 = rod * rod
+        self.towers = [(math.cos(math.radians(a)) * radius, math.sin(math.radians(a)) * radius) for a in (210, 330, 90)]
+
+    def transform(self, p):
+        """Carriage heights for a cartesian point"""
+        return [p[2] + math.sqrt(self.rod2 - (tx - p[0]) ** 2 - (ty - p[1]) ** 2) for tx, ty in self.towers]
+
+    def inverse(self, h):
+        """Cartesian point for carriage heights, like InverseTransform()"""
+        (xa, ya), (xb, yb), (xc, yc) = self.towers
+        fa = xa * xa + ya * ya + h[0] * h[0]
+        fb = xb * xb + yb * yb + h[1] * h[1]
+        fc = xc * xc + yc * yc + h[2] * h[2]
+        xbc, xca, xab = xc - xb, xa - xc, xb - xa
+        ybc, yca, yab = yc - yb, ya - yc, yb - ya
+        q = 2 * (xca * yab - xab * yca)
+        p = xbc * fa + xca * fb + xab * fc
+        s = ybc * fa + yca * fb + yab * fc
+        r = 2 * (xbc * h[0] + xca * h[1] + xab * h[2])
+        u = 2 * (ybc * h[0] + yca * h[1] + yab * h[2])
+        a = u * u + r * r + q * q
+        minus_half_b = s * u + p * r + h[0] * q * q + xa * u * q - ya * r * q
+        c = (s + xa * q) ** 2 + (p - ya * q) ** 2 + (h[0] * h[0] - self.rod2) * q * q
+        z = (minus_half_b - math.sqrt(minus_half_b * minus_half_b - a * c)) / a
+        return ((u * z - s) / q, (p - r * z) / q, z)
+
+
+def lerp(a, b, t):
+    return [a[i] + (b[i] - a[i]) * t for i in range(len(a))]
+
+
+def dist(a, b):
+    return math.sqrt(sum((a[i] - b[i]) ** 2 for i in range(3)))
+
+
+def fixed_lines(distance, feed, sps, spl):
+    segments = max(1, int(sps * distance / feed))
+    return (segments + spl - 1) // spl
+
+
+def adaptive_lines(delta, p0, p1, distance, feed, sps, max_error):
+    """Same as Delta_Mechanics::adaptive_lines(), capped at the segments"""
+    towers = [delta.transform(lerp(p0, p1, k * 0.25)) for k in range(5)]
+    worst = 0.0
+    for k, (a, m, b) in enumerate(((0, 2, 4), (0, 1, 2), (2, 3, 4))):
+        line = delta.inverse(towers[m])
+        path = delta.inverse(lerp(towers[a], towers[b], 0.5))
+        worst = max(worst, dist(line, path) * (4 if k else 1))
+    lines = max(1, math.ceil(math.sqrt(worst / max_error)))
+    return min(lines, max(1, int(sps * distance / feed)))
+
+
+def parabola_lines(delta, p0, p1, distance, feed, sps, max_error):
+    """Same as Delta_Mechanics::adaptive_lines() with DELTA_STEP_INTERPOLATION"""
+    towers = [delta.transform(lerp(p0, p1, k * 0.5)) for k in range(3)]
+    worst = 0.0
+    for t, near, far in ((0.25, 0, 2), (0.75, 2, 0)):
+        curve = [0.375 * towers[near][i] + 0.75 * towers[1][i] - 0.125 * towers[far][i] for i in range(3)]
+        worst = max(worst, dist(delta.inverse(curve), lerp(p0, p1, t)))
+    lines = max(1, math.ceil((worst / max_error) ** (1 / 3)))
+    return min(lines, max(1, int(sps * distance / feed)))
+
+
+def turn(a, m, b):
+    """Where a tower turns within the parabola through a, m and b, as Planner::buffer_line()"""
+    for i in range(3):
+        dh, c = b[i] - a[i], 4 * (m[i] - a[i]) - 2 * (b[i] - a[i])
+        if abs(dh) < abs(c) and 0.05 <= 0.5 + 0.5 * dh / c <= 0.95:
+            return 0.5 + 0.5 * dh / c
+    return None
+
+
+def path_error(delta, p0, p1, lines, parabola=False, samples=8):
+    """Largest distance of the effector from the cartesian line, and the blocks"""
+    d = [p1[i] - p0[i] for i in range(3)]
+    length2 = sum(v * v for v in d)
+    worst, blocks = 0.0, 0
+    parts = [(n / lines, (n + 1) / lines, parabola) for n in range(lines)]
+    while parts:
+        t0, t1, split = parts.pop(0)
+        a, b = delta.transform(lerp(p0, p1, t0)), delta.transform(lerp(p0, p1, t1))
+        m = delta.transform(lerp(p0, p1, (t0 + t1) / 2)) if parabola else lerp(a, b, 0.5)
+        t = turn(a, m, b) if split else None
+        if t is not None:
+            tm = t0 + (t1 - t0) * t
+            parts[:0] = [(t0, tm, False), (tm, t1, False)]
+            continue
+        blocks += 1
+        for k in range(1, samples):
+            s = k / samples
+            # Parabola through a, m and b, a line when m is the middle of a and b
+            h = [a[i] + (b[i] - a[i]) * s + 2 * (2 * m[i] - a[i] - b[i]) * s * (1 - s) for i in range(3)]
+            q = delta.inverse(h)
+            w = [q[i] - p0[i] for i in range(3)]
+            t = sum(w[i] * d[i] for i in range(3)) / length2
+            worst = max(worst, dist(q, lerp(p0, p1, t)))
+    return worst, blocks
+
+
+def moves(path):
+    """XYZ start, XYZ end and feedrate (mm/s) of the G0/G1 moves"""
+    pos, feed, absolute = [0.0, 0.0, 0.0], 50.0, True
+    for line in open(path):
+        words = line.split(';', 1)[0].upper().split()
+        if not words:
+            continue
+        values = {}
+        for w in words[1:]:
+            m = re.match(r'([A-Z])([-+]?[\d.]+)$', w)
+            if m:
+                values[m.group(1)] = float(m.group(2))
+        if words[0] in ('G90', 'G91'):
+            absolute = words[0] == 'G90'
+        elif words[0] == 'G92':
+            for i, a in enumerate('XYZ'):
+                pos[i] = values.get(a, pos[i])
+        elif words[0] in ('G0', 'G1', 'G00', 'G01'):
+            if 'F' in values:
+                feed = values['F'] / 60
+            end = [values.get(a, None if absolute else 0.0) for a in 'XYZ']
+            end = [pos[i] if end[i] is None else (end[i] if absolute else pos[i] + end[i]) for i in range(3)]
+            yield pos, end, feed
+            pos = end
+
+
+def synthetic(path, radius):
+    with open(path, 'w') as f:
+        f.write('G92 X0 Y0 Z0.3\n')
+        # Long chords across the bed
+        for k in range(12):
+            a = 2 * math.pi * k / 12
+            f.write('G0 X%.3f Y%.3f F12000\n' % (radius * math.cos(a), radius * math.sin(a)))
+            f.write('G1 X%.3f Y%.3f F6000\n' % (-radius * math.cos(a + 0.5), -radius * math.sin(a + 0.5)))
+        # Perimeters of 2 mm segments from the centre to the edge
+        for r in (radius * 0.2, radius * 0.5, radius * 0.9):
+            n = int(2 * math.pi * r / 2)
+            for i in range(n + 1):
+                a = 2 * math.pi * i / n
+                f.write('G1 X%.3f Y%.3f F3000\n' % (r * math.cos(a), r * math.sin(a)))
+
+
+def config_value(text, name, default):
+    m = re.search(r'^\s*#define\s+%s\s+([-+\d.]+)' % name, text, re.M)
+    return float(m.group(1)) if m else default
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Compare the delta segmentation modes')
+    ap.add_argument('file', nargs='?', help='G-code file, a synthetic job without it')
+    ap.add_argument('--config', default=CONFIG, help='Configuration_Delta.h')
+    ap.add_argument('--rod', type=float, help='diagonal rod (mm)')
+    ap.add_argument('--radius', type=float, help='delta radius (mm)')
+    ap.add_argument('--sps', type=float, help='segments per second')
+    ap.add_argument('--spl', type=int, help='segments per line')
+    ap.add_argument('--max-error', type=float, help='DELTA_SEGMENT_MAX_ERROR (mm)')
+    args = ap.parse_args()
+
+    text = open(args.config).read() if os.path.exists(args.config) else ''
+    rod = args.rod or config_value(text, 'DELTA_DIAGONAL_ROD', 220.0)
+    radius = args.radius or (config_value(text, 'DELTA_SMOOTH_ROD_OFFSET', 150.0)
+                             - config_value(text, 'DELTA_EFFECTOR_OFFSET', 20.0)
+                             - config_value(text, 'DELTA_CARRIAGE_OFFSET', 20.0))
+    sps = args.sps or config_value(text, 'DELTA_SEGMENTS_PER_SECOND', 200)
+    spl = args.spl or int(config_value(text, 'DELTA_SEGMENTS_PER_LINE', 20))
+    max_error = args.max_error or config_value(text, 'DELTA_SEGMENT_MAX_ERROR', 0.01)
+    print_radius = config_value(text, 'DELTA_PRINTABLE_RADIUS', 75.0)
+
+    path = args.file
+    if not path:
+        path = os.path.join(tempfile.gettempdir(), 'delta_segments.gcode')
+        synthetic(path, print_radius)
+
+    delta = Delta(rod, radius)
+    zones = ('centre', 'middle', 'edge')
+    stats = {mode: {'blocks': [0, 0, 0], 'worst': 0.0, 'sum': 0.0} for mode in ('fixed', 'segments', 'adaptive', 'parabola')}
+    count = 0
+    for p0, p1, feed in moves(path):
+        distance = dist(p0, p1)
+        if not (p1[0] - p0[0] or p1[1] - p0[1]) or distance < 1e-6:
+            continue
+        count += 1
+        reach = max(math.hypot(p[0], p[1]) for p in (p0, lerp(p0, p1, 0.5), p1))
+        zone = min(2, int(3 * reach / print_radius))
+        for mode, lines in (('fixed', fixed_lines(distance, feed, sps, spl)),
+                            ('segments', fixed_lines(distance, feed, sps, 1)),
+                            ('adaptive', adaptive_lines(delta, p0, p1, distance, feed, sps, max_error)),
+                            ('parabola', parabola_lines(delta, p0, p1, distance, feed, sps, max_error))):
+            error, blocks = path_error(delta, p0, p1, lines, mode == 'parabola')
+            s = stats[mode]
+            s['blocks'][zone] += blocks
+            s['worst'] = max(s['worst'], error)
+            s['sum'] += error
+
+    print('rod %.1f radius %.1f, %g segments/s, %d per line, max error %g mm, %d XY moves'
+          % (rod, radius, sps, spl, max_error, count))
+    print('%-9s %8s %8s %8s %8s %12s %12s' % ('mode', 'blocks', *zones, 'worst mm', 'mean mm'))
+    for mode, s in stats.items():
+        print('%-9s %8d %8d %8d %8d %12.4f %12.4f' % (mode, sum(s['blocks']), *s['blocks'], s['worst'],
+                                                      s['sum'] / max(count, 1)))
+
+
+if __name__ == '__main__':
+    main()
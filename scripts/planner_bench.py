@@ -0,0 +1,103 @@
+#!/usr/bin/python3
+
+# Planner throughput benchmark for the MK4duo Linux build.
+#
+# Build the firmware for BOARD_LINUX_RAMPS with PLANNER_STATS enabled, then
+# run one or more G-code files through it at several simulated clock speeds.
+# At speed K the machine moves K times faster than the host clock, so the
+# planner runs like on a MCU K times slower than the host: the speed at which
+# the starved blocks grow is where the planner can't keep up any more.
+#
+# Without files a set of synthetic jobs is generated: small segments like a
+# sliced curve, G2/G3 arcs (they need ARC_SUPPORT) and long straight moves.
+#
+#   planner_bench.py ./mk4duo
+#   planner_bench.py ./mk4duo cura.gcode slic3r.gcode --speed 1 10 50
+
+import argparse
+import math
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+HEADER = 'G28\nG92 E0\nG1 Z0.3 F3000\nG1 X100 Y100 F9000\n'
+
+
+def segments(f, length):
+    e = 0.0
+    for r in (30, 20, 10):
+        n = int(2 * math.pi * r / length)
+        for i in range(n + 1):
+            a = 2 * math.pi * i / n
+            e += length * 0.05
+            f.write('G1 X%.3f Y%.3f E%.5f F3600\n' % (100 + r * math.cos(a), 100 + r * math.sin(a), e))
+
+
+def arcs(f):
+    f.write('G1 X130 Y100 F3600\n')
+    for _ in range(10):
+        f.write('G2 X70 Y100 I-30 J0 F3600\nG2 X130 Y100 I30 J0\n')
+
+
+def lines(f):
+    for i in range(200):
+        f.write('G1 X%d Y%d F6000\n' % (40 + (i % 2) * 120, 40 + (i % 20) * 6))
+
+
+SYNTHETIC = {
+    'segments-0.2mm': lambda f: segments(f, 0.2),
+    'segments-1mm': lambda f: segments(f, 1.0),
+    'arcs': arcs,
+    'lines': lines,
+}
+
+
+def run(firmware, path, speed):
+    result = subprocess.run([firmware, '--bench', path, '--speed', str(speed)],
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                            cwd=os.path.dirname(os.path.abspath(firmware)), timeout=3600)
+    report = result.stderr.decode('ascii', 'replace')
+    values = {}
+    for key, pattern in (('host', r'Host time\s*: ([\d.]+)'),
+                         ('blocks', r'Blocks\s*: (\d+)'),
+                         ('rate', r'\((\d+)/s host'),
+                         ('avg', r'avg ([\d.]+) us'),
+                         ('max', r'max (\d+) us'),
+                         ('starved', r'Starved\s*: (\d+)')):
+        m = re.search(pattern, report)
+        if not m:
+            sys.exit('%s: no benchmark report\n%s' % (path, report))
+        values[key] = float(m.group(1))
+    return values
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MK4duo planner throughput benchmark')
+    parser.add_argument('firmware', help='mk4duo executable of the Linux build')
+    parser.add_argument('gcode', nargs='*', help='G-code files, synthetic jobs if omitted')
+    parser.add_argument('--speed', type=int, nargs='+', default=[1, 10, 50, 200], help='simulated clock speeds')
+    args = parser.parse_args()
+
+    jobs = [(os.path.basename(g), os.path.abspath(g)) for g in args.gcode]
+    tmp = None
+    if not jobs:
+        tmp = tempfile.TemporaryDirectory()
+        for name, generate in SYNTHETIC.items():
+            path = os.path.join(tmp.name, name + '.gcode')
+            with open(path, 'w') as f:
+                f.write(HEADER)
+                generate(f)
+            jobs.append((name, path))
+
+    print('%-20s %6s %7s %9s %9s %9s %8s' % ('Job', 'Speed', 'Blocks', 'Blocks/s', 'Recalc us', 'Max us', 'Starved'))
+    for name, path in jobs:
+        for speed in args.speed:
+            v = run(args.firmware, path, speed)
+            print('%-20s %6d %7d %9d %9.2f %9d %7.1f%%' % (name, speed, v['blocks'], v['rate'], v['avg'], v['max'],
+                                                         100.0 * v['starved'] / v['blocks'] if v['blocks'] else 0.0))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,111 @@
+#!/usr/bin/python3
+
+# SD card image for the MK4duo Linux build (mk4duo --sdcard card.img).
+#
+# Makes a FAT16 volume without partition table and copies the files in the
+# root folder with 8.3 names. With --fragment the clusters of the files are
+# interleaved, so a file is not contiguous on the card like after a few
+# deletes and copies, which is what the SD streaming code must cope with.
+#
+#   sd_image.py card.img part.gcode
+#   sd_image.py card.img a.gcode b.gcode --size 128 --fragment
+
+import argparse
+import os
+import struct
+import sys
+
+SECTOR = 512
+RESERVED = 4
+FATS = 2
+ROOT_ENTRIES = 512
+
+
+def short_name(path):
+    base = os.path.basename(path).upper()
+    name, _, ext = base.rpartition('.') if '.' in base else (base, '', '')
+    name = ''.join(c for c in name if c.isalnum() or c in '_-~')[:8]
+    ext = ''.join(c for c in ext if c.isalnum())[:3]
+    return name.ljust(8).encode() + ext.ljust(3).encode()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__)
+    ap.add_argument('image')
+    ap.add_argument('files', nargs='*')
+    ap.add_argument('--size', type=int, default=64, help='card size in MB (16-1024)')
+    ap.add_argument('--cluster', type=int, default=4, help='sectors per cluster')
+    ap.add_argument('--fragment', action='store_true', help='interleave the clusters of the files')
+    args = ap.parse_args()
+
+    sectors = args.size * 1024 * 1024 // SECTOR
+    spc = args.cluster
+    root_sectors = ROOT_ENTRIES * 32 // SECTOR
+    fat_sectors = 1
+    while True:
+        clusters = (sectors - RESERVED - FATS * fat_sectors - root_sectors) // spc
+        need = ((clusters + 2) * 2 + SECTOR - 1) // SECTOR
+        if need <= fat_sectors:
+            break
+        fat_sectors = need
+    if not 4085 <= clusters < 65525:
+        sys.exit('%d clusters is not FAT16, change --size or --cluster' % clusters)
+
+    data_start = RESERVED + FATS * fat_sectors + root_sectors
+    cluster_bytes = spc * SECTOR
+    img = bytearray(sectors * SECTOR)
+
+    # Boot sector
+    bs = struct.pack('<3s8sHBHBHHBHHHII', b'\xEB\x3C\x90', b'MK4DUO  ', SECTOR, spc, RESERVED,
+                     FATS, ROOT_ENTRIES, 0, 0xF8, fat_sectors, 63, 255, 0, sectors)
+    bs += struct.pack('<BBBI11s8s', 0x80, 0, 0x29, 0x4D4B3444, b'MK4DUO     ', b'FAT16   ')
+    img[0:len(bs)] = bs
+    img[510:512] = b'\x55\xAA'
+
+    fat = [0] * (clusters + 2)
+    fat[0], fat[1] = 0xFFF8, 0xFFFF
+
+    # Cluster numbers of each file, round robin with --fragment
+    datas = [open(f, 'rb').read() for f in args.files]
+    counts = [max(1, (len(d) + cluster_bytes - 1) // cluster_bytes) for d in datas]
+    chains = [[] for _ in datas]
+    nxt = 2
+    if args.fragment:
+        left = list(counts)
+        while any(left):
+            for i in range(len(datas)):
+                if left[i]:
+                    step = min(left[i], 3)
+                    chains[i] += range(nxt, nxt + step)
+                    nxt += step
+                    left[i] -= step
+    else:
+        for i, c in enumerate(counts):
+            chains[i] = list(range(nxt, nxt + c))
+            nxt += c
+    if nxt > clusters + 2:
+        sys.exit('files do not fit in the image')
+
+    root = (RESERVED + FATS * fat_sectors) * SECTOR
+    for i, (path, data, chain) in enumerate(zip(args.files, datas, chains)):
+        for j, c in enumerate(chain):
+            fat[c] = chain[j + 1] if j + 1 < len(chain) else 0xFFFF
+            off = (data_start + (c - 2) * spc) * SECTOR
+            part = data[j * cluster_bytes:(j + 1) * cluster_bytes]
+            img[off:off + len(part)] = part
+        entry = struct.pack('<11sBBBHHHHHHHI', short_name(path), 0x20, 0, 0, 0, 0x5000, 0x5000, 0,
+                            0, 0x5000, chain[0] if data else 0, len(data))
+        img[root + i * 32:root + i * 32 + 32] = entry
+
+    fat_bytes = struct.pack('<%dH' % len(fat), *fat)
+    for n in range(FATS):
+        off = (RESERVED + n * fat_sectors) * SECTOR
+        img[off:off + len(fat_bytes)] = fat_bytes
+
+    with open(args.image, 'wb') as f:
+        f.write(img)
+    print('%s: %d MB FAT16, %d clusters of %d bytes, %d files' % (args.image, args.size, clusters, cluster_bytes, len(datas)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,179 @@
+#!/usr/bin/python3
+
+# Replay a step trace recorded by MK4duo with STEP_TRACE (M45 S1 ... M45 S0).
+#
+# The trace is the steptrace.bin file written on the SD card, or a serial log
+# holding the TRACE: lines the firmware prints when there is no SD card.
+#
+# For each axis it reports the step count, the final position, the peak
+# velocity and acceleration and the step timing jitter, that is the distance
+# of every step from the midpoint of its two neighbours.
+#
+#   steptrace.py steptrace.bin
+#   steptrace.py steptrace.bin --csv profile.csv
+#   steptrace.py new.bin --compare old.bin
+
+import argparse
+import math
+import struct
+import sys
+
+MAGIC = 0x54534B4D
+HEADER = struct.Struct('<IBBHI4f')
+EVENT = struct.Struct('<IBBBB')
+AXES = 'XYZE'
+
+FLAG_NEW_BLOCK = 0x01
+FLAG_ADVANCE = 0x02
+FLAG_OVERFLOW = 0x04
+
+
+class Trace:
+
+    def __init__(self, data):
+        if len(data) < HEADER.size:
+            raise ValueError('trace too short')
+        magic, version, axes, event_size, rate, *spm = HEADER.unpack_from(data, 0)
+        if magic != MAGIC:
+            raise ValueError('not a MK4duo step trace')
+        if version != 1 or event_size != EVENT.size:
+            raise ValueError('unsupported trace version %d' % version)
+        self.timer_rate = rate
+        self.steps_per_mm = spm[:axes]
+        self.events = []      # (time_s, step_bits, dir_bits, block_index, flags)
+        self.overflows = 0
+
+        ticks = None
+        last = 0
+        for offset in range(HEADER.size, len(data) - EVENT.size + 1, EVENT.size):
+            raw, steps, dirs, block, flags = EVENT.unpack_from(data, offset)
+            # Unwrap the 32 bit timer ticks
+            ticks = raw if ticks is None else ticks + ((raw - last) & 0xFFFFFFFF)
+            last = raw
+            if flags & FLAG_OVERFLOW:
+                self.overflows += 1
+            self.events.append((ticks / rate, steps, dirs, block, flags))
+
+    @staticmethod
+    def load(path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] == struct.pack('<I', MAGIC):
+            return Trace(data)
+        # Serial log, keep only the TRACE: lines
+        raw = bytearray()
+        for line in data.decode('ascii', 'replace').splitlines():
+            pos = line.find('TRACE:')
+            if pos >= 0:
+                raw += bytes.fromhex(line[pos + 6:].strip())
+        return Trace(bytes(raw))
+
+    def axis_steps(self, axis):
+        """List of (time_s, direction) for each step of the axis."""
+        bit = 1 << axis
+        return [(t, -1 if dirs & bit else 1) for t, steps, dirs, _, _ in self.events if steps & bit]
+
+    def blocks(self):
+        """List of (start_s, end_s, steps per axis) for each traced block."""
+        result = []
+        for t, steps, _, _, flags in self.events:
+            if flags & FLAG_NEW_BLOCK or not result:
+                result.append([t, t, [0] * len(AXES)])
+            block = result[-1]
+            block[1] = t
+            for axis in range(len(AXES)):
+                if steps & (1 << axis):
+                    block[2][axis] += 1
+        return result
+
+
+def profile(trace, axis):
+    """Velocity and acceleration samples plus jitter of one axis."""
+    spm = trace.steps_per_mm[axis] or 1.0
+    steps = trace.axis_steps(axis)
+    velocity, accel, jitter = [], [], []
+    for i in range(1, len(steps)):
+        dt = steps[i][0] - steps[i - 1][0]
+        if dt <= 0 or steps[i][1] != steps[i - 1][1]:
+            velocity.append(None)
+            continue
+        velocity.append((steps[i][0] - dt / 2, steps[i][1] / (dt * spm)))
+    for a, b in zip(velocity, velocity[1:]):
+        if a and b and b[0] > a[0]:
+            accel.append((b[1] - a[1]) / (b[0] - a[0]))
+    for i in range(1, len(steps) - 1):
+        if steps[i - 1][1] == steps[i][1] == steps[i + 1][1]:
+            d0 = steps[i][0] - steps[i - 1][0]
+            d1 = steps[i + 1][0] - steps[i][0]
+            jitter.append(d1 - d0)
+    return steps, [v for v in velocity if v], accel, jitter
+
+
+def report(trace):
+    print('Timer rate: %d Hz, events: %d, overflows: %d' % (trace.timer_rate, len(trace.events), trace.overflows))
+    if trace.events:
+        print('Duration: %.6f s, blocks: %d' % (trace.events[-1][0] - trace.events[0][0], len(trace.blocks())))
+    print('Axis   Steps   Position(mm)  Vmax(mm/s)  Amax(mm/s2)  Jitter rms/max(us)')
+    for axis, name in enumerate(AXES[:len(trace.steps_per_mm)]):
+        steps, velocity, accel, jitter = profile(trace, axis)
+        if not steps:
+            continue
+        position = sum(d for _, d in steps) / (trace.steps_per_mm[axis] or 1.0)
+        vmax = max((abs(v) for _, v in velocity), default=0.0)
+        amax = max((abs(a) for a in accel), default=0.0)
+        # Half the second difference is the distance from the neighbours mean
+        rms = math.sqrt(sum(j * j for j in jitter) / len(jitter)) / 2 if jitter else 0.0
+        jmax = max((abs(j) for j in jitter), default=0.0) / 2
+        print('%-4s %7d %14.4f %11.3f %12.1f %10.3f/%.3f' % (name, len(steps), position, vmax, amax, rms * 1e6, jmax * 1e6))
+
+
+def write_csv(trace, path):
+    with open(path, 'w') as f:
+        f.write('time_s,axis,dir,position_mm,velocity_mm_s\n')
+        for axis, name in enumerate(AXES[:len(trace.steps_per_mm)]):
+            spm = trace.steps_per_mm[axis] or 1.0
+            position, last = 0, None
+            for t, d in trace.axis_steps(axis):
+                position += d
+                velocity = d / ((t - last) * spm) if last is not None and t > last else 0.0
+                f.write('%.9f,%s,%d,%.5f,%.3f\n' % (t, name, d, position / spm, velocity))
+                last = t
+
+
+def compare(trace, other):
+    a, b = trace.blocks(), other.blocks()
+    print('Block  Duration(ms)  Reference(ms)  Diff(us)')
+    worst = 0.0
+    for i, (x, y) in enumerate(zip(a, b)):
+        if x[2] != y[2]:
+            print('%5d  step counts differ %s / %s' % (i, x[2], y[2]))
+            continue
+        dx, dy = x[1] - x[0], y[1] - y[0]
+        worst = max(worst, abs(dx - dy))
+        print('%5d %13.3f %14.3f %9.1f' % (i, dx * 1e3, dy * 1e3, (dx - dy) * 1e6))
+    if len(a) != len(b):
+        print('Block count differs: %d / %d' % (len(a), len(b)))
+    print('Worst block duration difference: %.1f us' % (worst * 1e6))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Replay a MK4duo step trace')
+    parser.add_argument('trace', help='steptrace.bin or serial log with TRACE: lines')
+    parser.add_argument('--csv', help='write the per step profile to this file')
+    parser.add_argument('--compare', metavar='TRACE', help='compare block timing against another trace')
+    args = parser.parse_args()
+
+    try:
+        trace = Trace.load(args.trace)
+    except (OSError, ValueError) as e:
+        sys.exit('%s: %s' % (args.trace, e))
+
+    report(trace)
+    if args.csv:
+        write_csv(trace, args.csv)
+    if args.compare:
+        compare(trace, Trace.load(args.compare))
+
+
+if __name__ == '__main__':
+    main()